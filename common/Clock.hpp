@@ -0,0 +1,96 @@
+#pragma once
+
+#include "time.hpp"
+
+#include <atomic>
+#include <unistd.h>
+
+namespace RJ {
+
+/**
+ * @brief Source of the current time for the control stack
+ *
+ * @details Code that runs as part of the processing loop should get the time
+ * from the Clock in SystemState rather than calling timestamp() so that the
+ * loop can be run against simulated time.  Clocks may be read from any thread.
+ */
+class Clock {
+public:
+    virtual ~Clock() {}
+
+    /// Current time in microseconds
+    virtual Time now() const = 0;
+
+    /// Blocks until now() >= @t.  Simulated clocks jump straight to @t.
+    virtual void sleepUntil(Time t) = 0;
+
+    /// Converts @wall, a time from timestamp() such as a kernel receive stamp,
+    /// to this clock by keeping how long ago it was.  Times in the future, or
+    /// older than this clock's zero, map to now().
+    virtual Time fromWallTime(Time wall) const {
+        Time current = now();
+        Time wallNow = timestamp();
+        if (wall < wallNow && wallNow - wall < current) {
+            return current - (wallNow - wall);
+        }
+        return current;
+    }
+};
+
+/// Wall-clock time from timestamp()
+class RealTimeClock : public Clock {
+public:
+    Time now() const override { return timestamp(); }
+
+    Time fromWallTime(Time wall) const override {
+        Time current = now();
+        return wall < current ? wall : current;
+    }
+
+    void sleepUntil(Time t) override {
+        Time current = now();
+        if (t > current) {
+            // Use system usleep, not QThread::usleep.
+            //
+            // QThread::usleep uses pthread_cond_wait which sometimes fails to
+            // unblock.
+            ::usleep(t - current);
+        }
+    }
+};
+
+/**
+ * @brief Simulated time that only moves when it is told to
+ *
+ * @details sleepUntil() returns immediately after advancing the time, so a
+ * loop driven by this clock runs as fast as it can while behaving as if each
+ * frame took its full period.  Given the same inputs, every run sees exactly
+ * the same times.
+ */
+class SteppedClock : public Clock {
+public:
+    /// Default starting time.  This is well after zero so that code comparing
+    /// against zero-initialized timestamps behaves as it would in real time.
+    static constexpr Time DefaultStart = 3600 * 1000000ull;
+
+    explicit SteppedClock(Time start = DefaultStart) : _now(start) {}
+
+    Time now() const override { return _now.load(); }
+
+    void sleepUntil(Time t) override {
+        if (t > _now.load()) {
+            _now.store(t);
+        }
+    }
+
+    /// Moves time forward by @dt microseconds
+    void advance(Time dt) { _now.fetch_add(dt); }
+
+    /// Sets the current time.  This may move time backwards.
+    void set(Time t) { _now.store(t); }
+
+private:
+    std::atomic<Time> _now;
+};
+
+}  // namespace RJ
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <Clock.hpp>
+
+namespace RJ {
+
+TEST(SteppedClock, onlyMovesWhenTold) {
+    SteppedClock clock(1000);
+    EXPECT_EQ(1000, clock.now());
+    EXPECT_EQ(1000, clock.now());
+
+    clock.advance(16667);
+    EXPECT_EQ(17667, clock.now());
+
+    // Sleeping jumps straight to the deadline and never goes backwards
+    clock.sleepUntil(50000);
+    EXPECT_EQ(50000, clock.now());
+    clock.sleepUntil(20000);
+    EXPECT_EQ(50000, clock.now());
+
+    clock.set(10);
+    EXPECT_EQ(10, clock.now());
+}
+
+TEST(SteppedClock, fromWallTime) {
+    SteppedClock clock;
+    Time wallNow = timestamp();
+
+    // Keeps the age of the wall time, give or take the time between the two
+    // timestamp() calls
+    Time converted = clock.fromWallTime(wallNow - 5000);
+    EXPECT_LE(converted, clock.now() - 5000);
+    EXPECT_GE(converted, clock.now() - 5000 - 100000);
+
+    // The future and times from before the clock started are clamped to now
+    EXPECT_EQ(clock.now(), clock.fromWallTime(wallNow + 1000000));
+    EXPECT_EQ(clock.now(), clock.fromWallTime(0));
+}
+
+TEST(RealTimeClock, sleepUntil) {
+    RealTimeClock clock;
+    Time start = clock.now();
+    clock.sleepUntil(start + 2000);
+    EXPECT_GE(clock.now(), start + 2000);
+
+    // Deadlines in the past return immediately
+    clock.sleepUntil(start);
+}
+
+TEST(RealTimeClock, fromWallTime) {
+    RealTimeClock clock;
+    Time start = clock.now();
+    EXPECT_EQ(start - 5000, clock.fromWallTime(start - 5000));
+    EXPECT_LE(clock.fromWallTime(start + 1000000), clock.now());
+}
+
+}  // namespace RJ
@@ -16,12 +16,15 @@ public:
     Circle(Point c, float r) {
         center = c;
         _r = r;
-        _rsq = -1;
+        // Fill in the squared radius now so that const queries don't write to
+        // the cache.  Obstacles are shared between planner threads.
+        _rsq = r >= 0 ? r * r : -1;
     }
 
     Circle(const Circle& other) {
         center = other.center;
         _r = other.radius();
+        _rsq = other.radius_sq();
     }
 
     Shape* clone() const override;
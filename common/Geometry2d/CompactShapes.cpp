@@ -0,0 +1,57 @@
+#include "CompactShapes.hpp"
+#include "Circle.hpp"
+#include "CompositeShape.hpp"
+
+namespace Geometry2d {
+
+void CompactShapes::clear() {
+    _shapes.clear();
+    _children.clear();
+    _rects.clear();
+    _vertices.clear();
+}
+
+void CompactShapes::add(const Shape& shape) {
+    const Entry e = compile(shape);
+    _shapes.push_back(e);
+}
+
+CompactShapes::Entry CompactShapes::compile(const Shape& shape) {
+    Entry e{Kind::Other, 0, 0, 0, 0, 0, &shape};
+
+    if (const Circle* circle = dynamic_cast<const Circle*>(&shape)) {
+        e.kind = Kind::Circle;
+        e.x = circle->center.x;
+        e.y = circle->center.y;
+        e.r = circle->radius() + Robot_Radius;
+    } else if (const Rect* rect = dynamic_cast<const Rect*>(&shape)) {
+        e.kind = Kind::Rect;
+        e.first = _rects.size();
+        _rects.push_back(*rect);
+    } else if (const Polygon* poly = dynamic_cast<const Polygon*>(&shape)) {
+        e.kind = Kind::Polygon;
+        e.first = _vertices.size();
+        e.count = poly->vertices.size();
+        _vertices.insert(_vertices.end(), poly->vertices.begin(),
+                         poly->vertices.end());
+    } else if (const CompositeShape* comp =
+                   dynamic_cast<const CompositeShape*>(&shape)) {
+        // Reserve the children's slots first so they stay together.
+        // Compiling a child can add more entries (and reallocate), so each
+        // one is assigned by index.
+        e.kind = Kind::Composite;
+        e.first = _children.size();
+        e.count = comp->size();
+        _children.resize(e.first + e.count);
+
+        int i = e.first;
+        for (const auto& subshape : *comp) {
+            const Entry child = compile(*subshape);
+            _children[i++] = child;
+        }
+    }
+
+    return e;
+}
+
+}  // namespace Geometry2d
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "PointBuffer.hpp"
+#include "Polygon.hpp"
+#include "Rect.hpp"
+#include "Segment.hpp"
+#include "Shape.hpp"
+#include <Constants.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Geometry2d {
+
+/**
+ * @brief A flat copy of a list of shapes for fast hit tests
+ *
+ * @details Shape::hit() is a virtual call, and the CompositeShape version
+ * makes another virtual call for every subshape.  This keeps each shape as a
+ * small tagged record instead: a circle's center and hit radius, a copy of a
+ * rect, a range of a shared vertex array for a polygon, or a range of child
+ * records for a composite.  A hit test switches on the kind and does the math
+ * directly.  Shapes of any other type are kept by pointer and tested with
+ * Shape::hit().
+ *
+ * Every test gives exactly the same result as the original shape's hit().
+ * Shapes are copied when they are added, so the list must be rebuilt if they
+ * change.
+ */
+class CompactShapes {
+public:
+    /// Removes all shapes.  Storage is kept for the next time the list is
+    /// filled.
+    void clear();
+
+    /**
+     * Adds a copy of @shape to the end of the list.  A shape whose type isn't
+     * Circle, Rect, Polygon, or CompositeShape is kept by pointer, so it must
+     * outlive the list.
+     */
+    void add(const Shape& shape);
+
+    int size() const { return _shapes.size(); }
+
+    /// Same as calling hit() on the i'th shape added
+    bool hit(int i, Point pt) const { return hit(_shapes[i], pt); }
+    bool hit(int i, const Segment& seg) const { return hit(_shapes[i], seg); }
+
+private:
+    enum class Kind : uint8_t { Circle, Rect, Polygon, Composite, Other };
+
+    struct Entry {
+        Kind kind;
+
+        // Circle: the center and hit radius.
+        float x, y, r;
+
+        // Rect: index into _rects.
+        // Polygon: range of _vertices.
+        // Composite: range of _children.
+        int first, count;
+
+        // Other: the original shape
+        const Shape* shape;
+    };
+
+    Entry compile(const Shape& shape);
+
+    template <typename T>
+    bool hit(const Entry& e, const T& obj) const {
+        switch (e.kind) {
+            case Kind::Circle:
+                return circleHit(e, obj);
+            case Kind::Rect:
+                return rectHit(e, obj);
+            case Kind::Polygon:
+                return polygonHit(e, obj);
+            case Kind::Composite:
+                for (int i = e.first; i < e.first + e.count; ++i) {
+                    if (hit(_children[i], obj)) {
+                        return true;
+                    }
+                }
+                return false;
+            default:
+                return e.shape->hit(obj);
+        }
+    }
+
+    // These are Circle::hit() with the math of Point::nearPoint() and
+    // Segment::nearPoint() written out, so they inline without virtual calls.
+    static bool circleHit(float x, float y, float r, Point pt) {
+        const float dx = pt.x - x;
+        const float dy = pt.y - y;
+        return dx * dx + dy * dy <= r * r;
+    }
+
+    static bool circleHit(float x, float y, float r, const Segment& seg) {
+        return PointBuffer::segmentDistance(seg.pt[0].x, seg.pt[0].y,
+                                            seg.pt[1].x, seg.pt[1].y,
+                                            Point(x, y)) <= r;
+    }
+
+    template <typename T>
+    static bool circleHit(const Entry& e, const T& obj) {
+        return circleHit(e.x, e.y, e.r, obj);
+    }
+
+    // Rect::hit() without the virtual call
+    bool rectHit(const Entry& e, Point pt) const {
+        return _rects[e.first].nearPoint(pt, Robot_Radius);
+    }
+
+    bool rectHit(const Entry& e, const Segment& seg) const {
+        return _rects[e.first].nearSegment(seg, Robot_Radius);
+    }
+
+    bool polygonHit(const Entry& e, Point pt) const {
+        return Polygon::verticesNearPoint(_vertices.data() + e.first, e.count,
+                                          pt, Robot_Radius);
+    }
+
+    bool polygonHit(const Entry& e, const Segment& seg) const {
+        return Polygon::verticesNearSegment(_vertices.data() + e.first,
+                                            e.count, seg, Robot_Radius);
+    }
+
+    // One per added shape
+    std::vector<Entry> _shapes;
+
+    // Parts of composites, with each composite's children stored together
+    std::vector<Entry> _children;
+
+    std::vector<Rect> _rects;
+    std::vector<Point> _vertices;
+};
+
+}  // namespace Geometry2d
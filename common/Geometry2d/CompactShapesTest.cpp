@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <Geometry2d/CompactShapes.hpp>
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/CompositeShape.hpp>
+#include <Geometry2d/Polygon.hpp>
+#include <Geometry2d/Rect.hpp>
+#include <Constants.hpp>
+
+#include <memory>
+#include <random>
+
+using namespace std;
+
+namespace Geometry2d {
+
+// A shape type that CompactShapes doesn't know about
+class HalfPlane : public Shape {
+public:
+    bool hit(Point pt) const override { return pt.x < 0; }
+    bool hit(const Segment& seg) const override {
+        return seg.pt[0].x < 0 || seg.pt[1].x < 0;
+    }
+};
+
+// Random shapes of every kind, in a small area so that queries hit often
+static vector<shared_ptr<Shape>> randomShapes(mt19937& gen) {
+    uniform_real_distribution<float> posDist(-1, 1), radiusDist(0, 0.3);
+
+    auto randomPoint = [&]() { return Point(posDist(gen), posDist(gen)); };
+
+    vector<shared_ptr<Shape>> shapes;
+    for (int i = 0; i < 30; ++i) {
+        shapes.push_back(make_shared<Circle>(randomPoint(), radiusDist(gen)));
+    }
+
+    // A circle whose hit radius is zero
+    shapes.push_back(make_shared<Circle>(randomPoint(), -Robot_Radius));
+
+    // Rects with their corners in any order, and one with no area
+    for (int i = 0; i < 5; ++i) {
+        shapes.push_back(make_shared<Rect>(randomPoint(), randomPoint()));
+    }
+    Point corner = randomPoint();
+    shapes.push_back(make_shared<Rect>(corner, corner));
+
+    // Polygons that may be self-intersecting, and one with no vertices
+    for (int i = 0; i < 5; ++i) {
+        vector<Point> verts;
+        for (int j = 0; j < 3 + i; ++j) {
+            verts.push_back(randomPoint());
+        }
+        shapes.push_back(make_shared<Polygon>(verts));
+    }
+    shapes.push_back(make_shared<Polygon>());
+
+    // Nested composites, including an empty one and one with a HalfPlane
+    auto inner = make_shared<CompositeShape>();
+    inner->add(make_shared<Circle>(randomPoint(), radiusDist(gen)));
+    inner->add(make_shared<Rect>(randomPoint(), randomPoint()));
+    auto outer = make_shared<CompositeShape>();
+    outer->add(make_shared<Polygon>(
+        vector<Point>{randomPoint(), randomPoint(), randomPoint()}));
+    outer->add(inner);
+    outer->add(make_shared<CompositeShape>());
+    shapes.push_back(outer);
+    shapes.push_back(make_shared<CompositeShape>());
+
+    auto withOther = make_shared<CompositeShape>();
+    withOther->add(make_shared<HalfPlane>());
+    shapes.push_back(withOther);
+    shapes.push_back(make_shared<HalfPlane>());
+
+    return shapes;
+}
+
+TEST(CompactShapes, hitMatchesShapes) {
+    mt19937 gen(1);
+    const vector<shared_ptr<Shape>> shapes = randomShapes(gen);
+
+    CompactShapes compact;
+    for (const auto& shape : shapes) {
+        compact.add(*shape);
+    }
+    ASSERT_EQ(shapes.size(), compact.size());
+
+    uniform_real_distribution<float> posDist(-1.5, 1.5), stepDist(-0.5, 0.5);
+    for (int i = 0; i < 2000; ++i) {
+        Point pt(posDist(gen), posDist(gen));
+
+        // Some segments have no length
+        Point end = pt;
+        if (i % 10) {
+            end += Point(stepDist(gen), stepDist(gen));
+        }
+        Segment seg(pt, end);
+
+        for (size_t j = 0; j < shapes.size(); ++j) {
+            EXPECT_EQ(shapes[j]->hit(pt), compact.hit(j, pt)) << j;
+            EXPECT_EQ(shapes[j]->hit(seg), compact.hit(j, seg)) << j;
+        }
+    }
+}
+
+TEST(CompactShapes, clear) {
+    CompactShapes compact;
+    compact.add(Rect(Point(0, 0), Point(1, 1)));
+    compact.add(Circle(Point(3, 0), 0.5));
+
+    compact.clear();
+    EXPECT_EQ(0, compact.size());
+
+    compact.add(Circle(Point(5, 0), 0.5));
+    ASSERT_EQ(1, compact.size());
+    EXPECT_TRUE(compact.hit(0, Point(5, 0)));
+    EXPECT_FALSE(compact.hit(0, Point(0.5, 0.5)));
+}
+
+}  // namespace Geometry2d
@@ -0,0 +1,90 @@
+#include "PointBuffer.hpp"
+
+#include <algorithm>
+
+namespace Geometry2d {
+
+// This file is built with the flags the compiler needs to vectorize the
+// distance loops (see common/CMakeLists.txt).  None of them change the
+// results of floating-point operations.
+
+const int PointBuffer::BlockSize;
+
+void PointBuffer::distances(const float* x, const float* y, int n, Point pt,
+                            float* dist) {
+    const Point p = pt;
+    for (int i = 0; i < n; ++i) {
+        // Point::distTo()
+        const float dx = p.x - x[i];
+        const float dy = p.y - y[i];
+        dist[i] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+void PointBuffer::segmentDistances(const float* x, const float* y, int n,
+                                   Point pt, float* dist) {
+    const Point p = pt;
+    for (int i = 0; i < n - 1; ++i) {
+        dist[i] = segmentDistance(x[i], y[i], x[i + 1], y[i + 1], p);
+    }
+}
+
+// Index of the first smallest of @n values, which are compared with < like
+// the scalar loops this replaces
+static int firstMin(const float* values, int n) {
+    int best = 0;
+    for (int i = 1; i < n; ++i) {
+        if (values[i] < values[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+int PointBuffer::nearestIndex(const float* x, const float* y, int n,
+                              Point pt, float* dist) {
+    int best = -1;
+    float bestDist = 0;
+    float block[BlockSize];
+    for (int first = 0; first < n; first += BlockSize) {
+        const int count = std::min(BlockSize, n - first);
+        distances(x + first, y + first, count, pt, block);
+
+        const int i = firstMin(block, count);
+        if (best < 0 || block[i] < bestDist) {
+            best = first + i;
+            bestDist = block[i];
+        }
+    }
+
+    if (dist && best >= 0) {
+        *dist = bestDist;
+    }
+    return best;
+}
+
+int PointBuffer::nearestSegment(const float* x, const float* y, int n,
+                                Point pt, float* dist) {
+    int best = -1;
+    float bestDist = 0;
+    float block[BlockSize];
+
+    // Each block of segments needs one more point than it has segments
+    for (int first = 0; first < n - 1; first += BlockSize) {
+        const int count = std::min(BlockSize, n - 1 - first);
+        segmentDistances(x + first, y + first, count + 1, pt, block);
+
+        const int i = firstMin(block, count);
+        if (best < 0 || block[i] < bestDist) {
+            best = first + i;
+            bestDist = block[i];
+        }
+    }
+
+    if (dist && best >= 0) {
+        *dist = bestDist;
+    }
+    return best;
+}
+
+}  // namespace Geometry2d
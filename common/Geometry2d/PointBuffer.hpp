@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Util.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace Geometry2d {
+
+/**
+ * @brief A list of points stored as separate arrays of x and y coordinates
+ *
+ * @details With the coordinates apart, loops over many points, or over the
+ * segments between consecutive points, can be vectorized by the compiler.
+ * The batch functions here work on any pair of x and y arrays, so callers
+ * that keep points elsewhere can copy them into small blocks and use the
+ * same code.
+ *
+ * Every batch function gives exactly the same result as the scalar Point or
+ * Segment function it is named after.
+ */
+class PointBuffer {
+public:
+    /// Number of distances the batch searches compute at a time, on the stack
+    static const int BlockSize = 64;
+
+    void clear() {
+        _x.clear();
+        _y.clear();
+    }
+
+    void reserve(int n) {
+        _x.reserve(n);
+        _y.reserve(n);
+    }
+
+    void push_back(Point pt) {
+        _x.push_back(pt.x);
+        _y.push_back(pt.y);
+    }
+
+    int size() const { return _x.size(); }
+    bool empty() const { return _x.empty(); }
+
+    Point operator[](int i) const { return Point(_x[i], _y[i]); }
+
+    const float* x() const { return _x.data(); }
+    const float* y() const { return _y.data(); }
+
+    /// Index of the point nearest @pt, or -1 if there are no points
+    int nearestIndex(Point pt, float* dist = nullptr) const {
+        return nearestIndex(x(), y(), size(), pt, dist);
+    }
+
+    /// Index i of the segment from point i to point i + 1 that is nearest
+    /// @pt, or -1 if there are fewer than two points
+    int nearestSegment(Point pt, float* dist = nullptr) const {
+        return nearestSegment(x(), y(), size(), pt, dist);
+    }
+
+    /// Sets dist[i] to Point(x[i], y[i]).distTo(pt) for @n points
+    static void distances(const float* x, const float* y, int n, Point pt,
+                          float* dist);
+
+    /// Sets dist[i] to the Segment::distTo() @pt of the segment from point i
+    /// to point i + 1, for the n - 1 segments between @n points
+    static void segmentDistances(const float* x, const float* y, int n,
+                                 Point pt, float* dist);
+
+    /**
+     * Finds the point nearest @pt among @n points.  Ties go to the lowest
+     * index.
+     *
+     * @param dist If not null, set to the distance to the nearest point
+     * @return the index of the nearest point, or -1 if @n is zero
+     */
+    static int nearestIndex(const float* x, const float* y, int n, Point pt,
+                            float* dist = nullptr);
+
+    /**
+     * Finds the segment between consecutive points that is nearest @pt.  Ties
+     * go to the lowest index.
+     *
+     * @param dist If not null, set to the distance to the nearest segment
+     * @return i for the segment from point i to point i + 1, or -1 if @n is
+     *     less than two
+     */
+    static int nearestSegment(const float* x, const float* y, int n, Point pt,
+                              float* dist = nullptr);
+
+    /**
+     * Segment::distTo() for the segment from (x0, y0) to (x1, y1), written
+     * with selects instead of branches so that loops over it vectorize.
+     */
+    static float segmentDistance(float x0, float y0, float x1, float y1,
+                                 Point pt) {
+        // Segment::nearestPoint()
+        const float dx = x1 - x0;
+        const float dy = y1 - y0;
+        const float magsq = dx * dx + dy * dy;
+        float t = (dx * (pt.x - x0) + dy * (pt.y - y0)) / magsq;
+        t = magsq == 0 ? 0 : t;
+
+        float nx = x0 + dx * t;
+        float ny = y0 + dy * t;
+        nx = t >= 1 ? x1 : nx;
+        ny = t >= 1 ? y1 : ny;
+        nx = t <= 0 ? x0 : nx;
+        ny = t <= 0 ? y0 : ny;
+
+        // Segment::distTo() rounds tiny distances to zero
+        const float ex = pt.x - nx;
+        const float ey = pt.y - ny;
+        const float dist = std::sqrt(ex * ex + ey * ey);
+        return dist < FLOAT_EPSILON ? 0 : dist;
+    }
+
+private:
+    std::vector<float> _x, _y;
+};
+
+}  // namespace Geometry2d
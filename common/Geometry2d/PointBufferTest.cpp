@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <Geometry2d/PointBuffer.hpp>
+#include <Geometry2d/Segment.hpp>
+
+#include <random>
+
+using namespace std;
+
+namespace Geometry2d {
+
+// Random points, with some repeated so there are zero-length segments and
+// ties
+static PointBuffer randomPoints(mt19937& gen, int n) {
+    uniform_real_distribution<float> posDist(-3, 3);
+    PointBuffer points;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0 && i % 7 == 0) {
+            points.push_back(points[i - 1]);
+        } else {
+            points.push_back(Point(posDist(gen), posDist(gen)));
+        }
+    }
+    return points;
+}
+
+TEST(PointBuffer, distancesMatchScalar) {
+    mt19937 gen(1);
+    const PointBuffer points = randomPoints(gen, 37);
+    ASSERT_EQ(37, points.size());
+
+    uniform_real_distribution<float> posDist(-3, 3);
+    vector<float> dist(points.size());
+    for (int i = 0; i < 500; ++i) {
+        // Some queries are on a point
+        Point pt = i % 10 ? Point(posDist(gen), posDist(gen)) : points[i % 37];
+
+        PointBuffer::distances(points.x(), points.y(), points.size(), pt,
+                               dist.data());
+        for (int j = 0; j < points.size(); ++j) {
+            EXPECT_EQ(pt.distTo(points[j]), dist[j]);
+        }
+
+        PointBuffer::segmentDistances(points.x(), points.y(), points.size(),
+                                      pt, dist.data());
+        for (int j = 0; j < points.size() - 1; ++j) {
+            EXPECT_EQ(Segment(points[j], points[j + 1]).distTo(pt), dist[j]);
+        }
+    }
+}
+
+TEST(PointBuffer, nearestMatchesScalar) {
+    mt19937 gen(2);
+    uniform_real_distribution<float> posDist(-3, 3);
+
+    // Sizes around the block size
+    for (int n : {0, 1, 2, 5, PointBuffer::BlockSize,
+                  PointBuffer::BlockSize + 1, 3 * PointBuffer::BlockSize + 5}) {
+        const PointBuffer points = randomPoints(gen, n);
+        for (int i = 0; i < 100; ++i) {
+            Point pt(posDist(gen), posDist(gen));
+
+            // The first nearest point and segment, found one at a time
+            int nearestPoint = -1;
+            float pointDist = 0;
+            for (int j = 0; j < n; ++j) {
+                float d = pt.distTo(points[j]);
+                if (nearestPoint < 0 || d < pointDist) {
+                    nearestPoint = j;
+                    pointDist = d;
+                }
+            }
+
+            int nearestSeg = -1;
+            float segDist = 0;
+            for (int j = 0; j < n - 1; ++j) {
+                float d = Segment(points[j], points[j + 1]).distTo(pt);
+                if (nearestSeg < 0 || d < segDist) {
+                    nearestSeg = j;
+                    segDist = d;
+                }
+            }
+
+            float dist = -1;
+            EXPECT_EQ(nearestPoint, points.nearestIndex(pt, &dist));
+            if (nearestPoint >= 0) {
+                EXPECT_EQ(pointDist, dist);
+            }
+
+            dist = -1;
+            EXPECT_EQ(nearestSeg, points.nearestSegment(pt, &dist));
+            if (nearestSeg >= 0) {
+                EXPECT_EQ(segDist, dist);
+            } else {
+                EXPECT_EQ(-1, dist);
+            }
+        }
+    }
+}
+
+TEST(PointBuffer, tiesGoToFirst) {
+    PointBuffer points;
+    points.push_back(Point(1, 0));
+    points.push_back(Point(-1, 0));
+    points.push_back(Point(1, 0));
+    EXPECT_EQ(0, points.nearestIndex(Point(2, 0)));
+    EXPECT_EQ(0, points.nearestSegment(Point(0, 1)));
+
+    points.clear();
+    EXPECT_TRUE(points.empty());
+    EXPECT_EQ(-1, points.nearestIndex(Point()));
+}
+
+}  // namespace Geometry2d
@@ -64,12 +64,26 @@ bool Polygon::containsVertex(const Polygon& other) const {
 }
 
 bool Polygon::nearPoint(Point pt, float threshold) const {
-    if (containsPoint(pt)) {
+    return verticesNearPoint(vertices.data(), vertices.size(), pt, threshold);
+}
+
+bool Polygon::nearSegment(const Segment& seg, float threshold) const {
+    return verticesNearSegment(vertices.data(), vertices.size(), seg,
+                               threshold);
+}
+
+bool Polygon::containsPoint(Point pt) const {
+    return verticesContainPoint(vertices.data(), vertices.size(), pt);
+}
+
+bool Polygon::verticesNearPoint(const Point* vertices, int n, Point pt,
+                                float threshold) {
+    if (verticesContainPoint(vertices, n, pt)) {
         return true;
     }
 
-    unsigned int i = vertices.size() - 1;
-    for (unsigned int j = 0; j < vertices.size(); ++j) {
+    int i = n - 1;
+    for (int j = 0; j < n; ++j) {
         Segment edge(vertices[i], vertices[j]);
         if (edge.nearPoint(pt, threshold)) {
             return true;
@@ -81,13 +95,15 @@ bool Polygon::nearPoint(Point pt, float threshold) const {
     return false;
 }
 
-bool Polygon::nearSegment(const Segment& seg, float threshold) const {
-    if (containsPoint(seg.pt[0]) || containsPoint(seg.pt[1])) {
+bool Polygon::verticesNearSegment(const Point* vertices, int n,
+                                  const Segment& seg, float threshold) {
+    if (verticesContainPoint(vertices, n, seg.pt[0]) ||
+        verticesContainPoint(vertices, n, seg.pt[1])) {
         return true;
     }
 
-    unsigned int i = vertices.size() - 1;
-    for (unsigned int j = 0; j < vertices.size(); ++j) {
+    int i = n - 1;
+    for (int j = 0; j < n; ++j) {
         Segment edge(vertices[i], vertices[j]);
         if (edge.nearSegment(seg, threshold)) {
             return true;
@@ -99,7 +115,7 @@ bool Polygon::nearSegment(const Segment& seg, float threshold) const {
     return false;
 }
 
-bool Polygon::containsPoint(Point pt) const {
+bool Polygon::verticesContainPoint(const Point* vertices, int n, Point pt) {
     // FIXME (Ben) - Replace this with the optimized wrap-number test.
 
     // http://www.geometryalgorithms.com/Archive/algorithm_0103/algorithm_0103.h
@@ -129,8 +145,8 @@ bool Polygon::containsPoint(Point pt) const {
     // for one of them.
 
     int count = 0;
-    unsigned int i = vertices.size() - 1;
-    for (unsigned int j = 0; j < vertices.size(); j++) {
+    int i = n - 1;
+    for (int j = 0; j < n; j++) {
         const Point& p1 = vertices[i];
         const Point& p2 = vertices[j];
         i = j;
@@ -41,6 +41,15 @@ public:
 
     Rect bbox() const;
 
+    /// Same as containsPoint(), nearPoint(), and nearSegment(), for a polygon
+    /// given as an array of @n vertices.  These let code that keeps vertices
+    /// in its own storage (see CompactShapes) use the same tests.
+    static bool verticesContainPoint(const Point* vertices, int n, Point pt);
+    static bool verticesNearPoint(const Point* vertices, int n, Point pt,
+                                  float threshold);
+    static bool verticesNearSegment(const Point* vertices, int n,
+                                    const Segment& seg, float threshold);
+
     std::vector<Point> vertices;
 
     void addVertex(Point pt) { vertices.push_back(pt); }
@@ -0,0 +1,146 @@
+#include "ShapeSet.hpp"
+#include "Circle.hpp"
+#include "CompositeShape.hpp"
+#include "Polygon.hpp"
+#include "Rect.hpp"
+#include <Constants.hpp>
+
+#include <cmath>
+
+namespace Geometry2d {
+
+constexpr float ShapeSet::DefaultIndexCellSize;
+const int ShapeSet::MaxIndexCellsPerAxis;
+
+bool ShapeSet::hitBounds(const Shape& shape, Bounds& bounds) {
+    // Shape::hit() counts anything within a robot radius as a hit.  The extra
+    // bit of padding covers floating-point error in the hit tests.
+    const float pad = Robot_Radius + 0.001f;
+
+    if (const Circle* circle = dynamic_cast<const Circle*>(&shape)) {
+        const float r = circle->radius() + pad;
+        bounds = Bounds{circle->center.x - r, circle->center.y - r,
+                        circle->center.x + r, circle->center.y + r};
+        return true;
+    } else if (const Rect* rect = dynamic_cast<const Rect*>(&shape)) {
+        bounds = Bounds{rect->minx() - pad, rect->miny() - pad,
+                        rect->maxx() + pad, rect->maxy() + pad};
+        return true;
+    } else if (const Polygon* poly = dynamic_cast<const Polygon*>(&shape)) {
+        if (poly->vertices.empty()) {
+            return false;
+        }
+        const Rect box = poly->bbox();
+        bounds = Bounds{box.minx() - pad, box.miny() - pad, box.maxx() + pad,
+                        box.maxy() + pad};
+        return true;
+    } else if (const CompositeShape* comp =
+                   dynamic_cast<const CompositeShape*>(&shape)) {
+        if (comp->size() == 0) {
+            return false;
+        }
+        bool first = true;
+        for (const auto& subshape : *comp) {
+            Bounds sub;
+            if (!hitBounds(*subshape, sub)) {
+                return false;
+            }
+            if (first) {
+                bounds = sub;
+                first = false;
+            } else {
+                bounds.minx = std::min(bounds.minx, sub.minx);
+                bounds.miny = std::min(bounds.miny, sub.miny);
+                bounds.maxx = std::max(bounds.maxx, sub.maxx);
+                bounds.maxy = std::max(bounds.maxy, sub.maxy);
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void ShapeSet::buildIndex(float cellSize) {
+    clearIndex();
+
+    for (const auto& shape : _shapes) {
+        _compact.add(*shape);
+    }
+
+    // Find the bounds of each shape and of the whole grid
+    _bounds.resize(_shapes.size());
+    bool haveGrid = false;
+    for (int i = 0; i < (int)_shapes.size(); ++i) {
+        Bounds& b = _bounds[i];
+        if (!hitBounds(*_shapes[i], b) || !std::isfinite(b.minx) ||
+            !std::isfinite(b.miny) || !std::isfinite(b.maxx) ||
+            !std::isfinite(b.maxy)) {
+            // Make sure this never passes the overlap test in the grid
+            b = Bounds{1, 1, -1, -1};
+            _unbounded.push_back(i);
+            continue;
+        }
+
+        if (!haveGrid) {
+            _grid = b;
+            haveGrid = true;
+        } else {
+            _grid.minx = std::min(_grid.minx, b.minx);
+            _grid.miny = std::min(_grid.miny, b.miny);
+            _grid.maxx = std::max(_grid.maxx, b.maxx);
+            _grid.maxy = std::max(_grid.maxy, b.maxy);
+        }
+    }
+
+    if (haveGrid) {
+        // Size the grid, growing the cells if there would be too many
+        const float width = _grid.maxx - _grid.minx;
+        const float height = _grid.maxy - _grid.miny;
+        _cellSize = std::max(cellSize, 0.001f);
+        _cellSize = std::max(_cellSize, width / MaxIndexCellsPerAxis);
+        _cellSize = std::max(_cellSize, height / MaxIndexCellsPerAxis);
+        _gridWidth = std::min(MaxIndexCellsPerAxis,
+                              std::max(1, (int)ceilf(width / _cellSize)));
+        _gridHeight = std::min(MaxIndexCellsPerAxis,
+                               std::max(1, (int)ceilf(height / _cellSize)));
+
+        // Count the shapes in each cell, then fill in the cell lists.
+        // Bounded shapes are exactly those not in _unbounded, whose bounds
+        // are valid (minx <= maxx).
+        const int numCells = _gridWidth * _gridHeight;
+        _cellStart.assign(numCells + 1, 0);
+        for (const Bounds& b : _bounds) {
+            if (b.minx > b.maxx) {
+                continue;
+            }
+            for (int y = cellY(b.miny); y <= cellY(b.maxy); ++y) {
+                for (int x = cellX(b.minx); x <= cellX(b.maxx); ++x) {
+                    ++_cellStart[y * _gridWidth + x + 1];
+                }
+            }
+        }
+
+        for (int c = 0; c < numCells; ++c) {
+            _cellStart[c + 1] += _cellStart[c];
+        }
+
+        _cellShapes.resize(_cellStart[numCells]);
+        _cellFill.assign(_cellStart.begin(), _cellStart.end() - 1);
+        for (int i = 0; i < (int)_bounds.size(); ++i) {
+            const Bounds& b = _bounds[i];
+            if (b.minx > b.maxx) {
+                continue;
+            }
+            for (int y = cellY(b.miny); y <= cellY(b.maxy); ++y) {
+                for (int x = cellX(b.minx); x <= cellX(b.maxx); ++x) {
+                    _cellShapes[_cellFill[y * _gridWidth + x]++] = i;
+                }
+            }
+        }
+    }
+
+    _indexed = true;
+}
+
+}  // namespace Geometry2d
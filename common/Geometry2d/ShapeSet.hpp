@@ -1,7 +1,11 @@
 #pragma once
 
+#include "CompactShapes.hpp"
 #include "Shape.hpp"
+#include "Segment.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <sstream>
@@ -9,36 +13,115 @@
 
 namespace Geometry2d {
 
-/// This class maintains a collection of Shape objects.
+/**
+ * This class maintains a collection of Shape objects.
+ *
+ * By default every query tests every shape.  Calling buildIndex() bins the
+ * shapes' bounding boxes into a uniform grid so that hit queries only test the
+ * shapes near the query object.  The index is dropped whenever the set is
+ * modified, so it should be built once the set is complete (for example, once
+ * per planning request).
+ *
+ * The index also keeps a CompactShapes copy of the shapes, which the indexed
+ * queries test instead of calling Shape::hit().  Since the shapes are copied,
+ * the index must be rebuilt if a shape in the set changes.
+ */
 class ShapeSet {
 public:
-    ShapeSet() {}
+    /// Default edge length of a grid cell in the index, in meters
+    static constexpr float DefaultIndexCellSize = 0.5f;
+
+    /// Largest number of grid cells along either axis of the index
+    static const int MaxIndexCellsPerAxis = 64;
+
+    ShapeSet() : _indexed(false) {}
 
     /// Initializes the set by iterating from @first to @last, which are
     /// iterators into a collection of std::shared_ptr<Shape>.
     template <class InputIt>
-    ShapeSet(InputIt first, InputIt last) {
+    ShapeSet(InputIt first, InputIt last) : _indexed(false) {
         while (first != last) {
             add(*first++);
         }
     }
 
-    std::vector<std::shared_ptr<Shape>> shapes() { return _shapes; }
-    const std::vector<std::shared_ptr<Shape>> shapes() const { return _shapes; }
+    const std::vector<std::shared_ptr<Shape>>& shapes() const {
+        return _shapes;
+    }
+
+    int size() const { return _shapes.size(); }
 
     void add(std::shared_ptr<Shape> shape) {
         assert(shape != nullptr);
-        _shapes.push_back(shape);
+        _shapes.push_back(std::move(shape));
+        clearIndex();
     }
 
     void add(const ShapeSet& other) {
-        for (auto shape : other.shapes()) {
-            add(shape);
+        const int n = other._shapes.size();
+        _shapes.reserve(_shapes.size() + n);
+        for (int i = 0; i < n; ++i) {
+            _shapes.push_back(other._shapes[i]);
         }
+        clearIndex();
+    }
+
+    /**
+     * Adds the shapes in @other without sharing ownership of them.  The
+     * entries are non-owning pointers (see view()), so adding, copying and
+     * destroying them does no reference counting.  @other's shapes must
+     * outlive this set, or at least its next clear(), and this set must not
+     * be copied anywhere that might outlive them.
+     */
+    void addView(const ShapeSet& other) {
+        const int n = other._shapes.size();
+        _shapes.reserve(_shapes.size() + n);
+        for (int i = 0; i < n; ++i) {
+            _shapes.push_back(view(other._shapes[i].get()));
+        }
+        clearIndex();
+    }
+
+    /**
+     * A shared_ptr to @shape that doesn't own it.  It has no control block,
+     * so copies of it are plain pointer copies.
+     *
+     * Nothing keeps @shape alive: use_count() is always zero and a weak_ptr
+     * made from the view is expired from the start, so neither can tell
+     * whether it is still valid.  The caller must make sure every copy is
+     * gone before @shape is destroyed or reused.  Views of ObstaclePool
+     * circles, for example, are only valid until the pool's next clear().
+     */
+    static std::shared_ptr<Shape> view(Shape* shape) {
+        return std::shared_ptr<Shape>(std::shared_ptr<Shape>(), shape);
     }
 
-    /// Remove all shapes
-    void clear() { _shapes.clear(); }
+    /// Makes room for @n shapes without reallocating
+    void reserve(int n) { _shapes.reserve(n); }
+
+    /// Remove all shapes.  The storage is kept, so a set that is cleared and
+    /// refilled every frame stops allocating once it has reached its largest
+    /// size.
+    void clear() {
+        _shapes.clear();
+        clearIndex();
+    }
+
+    /**
+     * Builds the spatial index used to speed up hit queries.
+     *
+     * Shapes whose bounds can't be determined (types other than Circle, Rect,
+     * Polygon, and CompositeShapes made of those) are kept in a separate list
+     * that is tested by every query.  The shapes must not be changed while
+     * the index is in use.
+     *
+     * @param cellSize Edge length of a grid cell.  This is increased if needed
+     *     to keep the grid within MaxIndexCellsPerAxis cells on each side.
+     */
+    void buildIndex(float cellSize = DefaultIndexCellSize);
+
+    /// True if buildIndex() has been called since the set was last modified
+    bool indexed() const { return _indexed; }
 
     /**
      * Get a set of which shapes "hit" the given object.
@@ -49,11 +132,10 @@ public:
     template <typename T>
     std::set<std::shared_ptr<Shape>> hitSet(const T& obj) const {
         std::set<std::shared_ptr<Shape>> hits;
-        for (const auto& shape : _shapes) {
-            if (shape->hit(obj)) {
-                hits.insert(shape);
-            }
-        }
+        visitHits(obj, [&](int i) {
+            hits.insert(_shapes[i]);
+            return false;
+        });
         return hits;
     }
 
@@ -65,7 +147,118 @@ public:
      */
     template <typename T>
     bool hit(const T& obj) const {
-        return !hitSet<T>(obj).empty();
+        return anyHit(obj);
+    }
+
+    /// Same as hit(), but stops at the first collision and never allocates.
+    template <typename T>
+    bool anyHit(const T& obj) const {
+        return visitHits(obj, [](int) { return true; });
+    }
+
+    /**
+     * Check if the object hits any shape that is not in @ignored.
+     *
+     * This is the allocation-free version of checking whether hitSet(obj)
+     * contains anything that isn't in a previous hitSet (typically the set of
+     * obstacles the robot is already inside of).
+     */
+    template <typename T>
+    bool anyHit(const T& obj,
+                const std::set<std::shared_ptr<Shape>>& ignored) const {
+        return visitHits(obj, [&](int i) {
+            return ignored.empty() || ignored.find(_shapes[i]) == ignored.end();
+        });
+    }
+
+    /// Number of 64-bit words in a mask with one bit per shape (see hitMask())
+    int maskWords() const { return ((int)_shapes.size() + 63) / 64; }
+
+    /**
+     * Allocation-free version of hitSet().
+     *
+     * Bit i of @mask is set if the i'th shape added to the set hits @obj.
+     * @mask must hold maskWords() words and is fully overwritten.
+     */
+    template <typename T>
+    void hitMask(const T& obj, uint64_t* mask) const {
+        std::fill(mask, mask + maskWords(), 0);
+        visitHits(obj, [&](int i) {
+            mask[i / 64] |= uint64_t(1) << (i % 64);
+            return false;
+        });
+    }
+
+    /// Same as anyHit(obj, ignored), but with the ignored shapes given as a
+    /// mask from hitMask().
+    template <typename T>
+    bool anyHit(const T& obj, const uint64_t* ignored) const {
+        return visitHits(obj, [&](int i) {
+            return !((ignored[i / 64] >> (i % 64)) & 1);
+        });
+    }
+
+    /**
+     * Find the shape that was added earliest among those that hit the object.
+     *
+     * @return The hit shape or nullptr if nothing was hit
+     */
+    template <typename T>
+    std::shared_ptr<Shape> firstHit(const T& obj) const {
+        int best = -1;
+        if (_indexed) {
+            visitHits(obj, [&](int i) {
+                if (best < 0 || i < best) {
+                    best = i;
+                }
+                return false;
+            });
+        } else {
+            // Shapes are tested in order, so stop at the first hit
+            visitHits(obj, [&](int i) {
+                best = i;
+                return true;
+            });
+        }
+
+        return best < 0 ? nullptr : _shapes[best];
+    }
+
+    /**
+     * Finds how far along @seg, from seg.pt[0], it first hits a shape that is
+     * not ignored.
+     *
+     * The whole segment is tested once, and the contact is only searched for
+     * if that hits something.  The search bisects on prefixes of @seg and
+     * tests each one as a segment, so unlike testing points along @seg it
+     * can't step over a thin shape.
+     *
+     * @param ignored Shapes to ignore, as a set or as a mask from hitMask()
+     * @param tolerance The result is at most this far before the contact
+     * @return The distance to the first contact, or -1 if nothing is hit
+     */
+    template <typename Ignored>
+    float firstHitDistance(const Segment& seg, const Ignored& ignored,
+                           float tolerance = 0.001f) const {
+        if (!anyHit(seg, ignored)) {
+            return -1;
+        }
+        if (anyHit(seg.pt[0], ignored)) {
+            return 0;
+        }
+
+        // The prefix of length lo is clear and the one of length hi hits
+        const Point dir = seg.delta().normalized();
+        float lo = 0, hi = seg.length();
+        while (hi - lo > tolerance) {
+            const float mid = (lo + hi) / 2;
+            if (anyHit(Segment(seg.pt[0], seg.pt[0] + dir * mid), ignored)) {
+                hi = mid;
+            } else {
+                lo = mid;
+            }
+        }
+        return lo;
     }
 
     friend std::ostream& operator<<(std::ostream& out,
@@ -79,7 +272,148 @@ public:
     }
 
 private:
+    /// Axis-aligned bounds of the region in which something can be hit
+    struct Bounds {
+        float minx, miny, maxx, maxy;
+
+        bool overlaps(const Bounds& other) const {
+            return other.minx <= maxx && other.maxx >= minx &&
+                   other.miny <= maxy && other.maxy >= miny;
+        }
+    };
+
+    /// Finds the bounds of the region in which @shape can hit something
+    /// (including the robot radius that Shape::hit() adds).
+    /// Returns false if the shape's type is not known.
+    static bool hitBounds(const Shape& shape, Bounds& bounds);
+
+    static Bounds queryBounds(Point pt) { return Bounds{pt.x, pt.y, pt.x, pt.y}; }
+
+    static Bounds queryBounds(const Segment& seg) {
+        return Bounds{std::min(seg.pt[0].x, seg.pt[1].x),
+                      std::min(seg.pt[0].y, seg.pt[1].y),
+                      std::max(seg.pt[0].x, seg.pt[1].x),
+                      std::max(seg.pt[0].y, seg.pt[1].y)};
+    }
+
+    int cellX(float x) const {
+        return std::max(
+            0, std::min(_gridWidth - 1, (int)((x - _grid.minx) / _cellSize)));
+    }
+
+    int cellY(float y) const {
+        return std::max(
+            0, std::min(_gridHeight - 1, (int)((y - _grid.miny) / _cellSize)));
+    }
+
+    /**
+     * Calls @visit(i) for the index of every shape that might hit something
+     * in @query.  Each shape is visited at most once.  Without an index, every
+     * shape is visited in order.
+     *
+     * Stops and returns true as soon as @visit returns true.
+     */
+    template <typename Visitor>
+    bool visitCandidates(const Bounds& query, Visitor visit) const {
+        if (!_indexed) {
+            for (int i = 0; i < (int)_shapes.size(); ++i) {
+                if (visit(i)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        for (int i : _unbounded) {
+            if (visit(i)) {
+                return true;
+            }
+        }
+
+        if (_cellStart.empty() || !_grid.overlaps(query)) {
+            return false;
+        }
+
+        const int x0 = cellX(query.minx), x1 = cellX(query.maxx);
+        const int y0 = cellY(query.miny), y1 = cellY(query.maxy);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                const int cell = y * _gridWidth + x;
+                for (int j = _cellStart[cell]; j < _cellStart[cell + 1]; ++j) {
+                    const int i = _cellShapes[j];
+                    const Bounds& b = _bounds[i];
+                    if (!b.overlaps(query)) {
+                        continue;
+                    }
+
+                    // A shape is stored in every cell its bounds touch, so
+                    // only visit it from the cell holding the lower corner of
+                    // its overlap with the query.
+                    if (cellX(std::max(b.minx, query.minx)) != x ||
+                        cellY(std::max(b.miny, query.miny)) != y) {
+                        continue;
+                    }
+
+                    if (visit(i)) {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Calls @onHit(i) for the index of every shape that hits @obj.  Without an
+     * index, shapes are tested in order.
+     *
+     * Stops and returns true as soon as @onHit returns true.
+     */
+    template <typename T, typename Visitor>
+    bool visitHits(const T& obj, Visitor onHit) const {
+        if (!_indexed) {
+            return visitCandidates(queryBounds(obj), [&](int i) {
+                return _shapes[i]->hit(obj) && onHit(i);
+            });
+        }
+
+        return visitCandidates(queryBounds(obj), [&](int i) {
+            return _compact.hit(i, obj) && onHit(i);
+        });
+    }
+
+    void clearIndex() {
+        if (_indexed) {
+            _indexed = false;
+            _compact.clear();
+            _bounds.clear();
+            _unbounded.clear();
+            _cellStart.clear();
+            _cellShapes.clear();
+        }
+    }
+
     std::vector<std::shared_ptr<Shape>> _shapes;
+
+    // Spatial index, valid when _indexed is true.
+    //
+    // The grid covers _grid with _gridWidth * _gridHeight square cells, stored
+    // row-major.  The shapes in cell c are
+    // _cellShapes[_cellStart[c] .. _cellStart[c + 1]).
+    bool _indexed;
+    std::vector<Bounds> _bounds;  // Parallel to _shapes
+    std::vector<int> _unbounded;  // Shapes that every query must test
+    Bounds _grid{0, 0, 0, 0};
+    float _cellSize = 1;
+    int _gridWidth = 0, _gridHeight = 0;
+    std::vector<int> _cellStart;
+    std::vector<int> _cellShapes;
+    CompactShapes _compact;  // Parallel to _shapes
+
+    // Scratch space for buildIndex(), kept so that rebuilding the index
+    // doesn't allocate
+    std::vector<int> _cellFill;
 };
 
 }  // namespace Geometry2d
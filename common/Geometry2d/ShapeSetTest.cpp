@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <Geometry2d/ShapeSet.hpp>
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/CompositeShape.hpp>
+#include <Geometry2d/Polygon.hpp>
+#include <Geometry2d/Rect.hpp>
+#include <Constants.hpp>
+
+#include <random>
+
+using namespace std;
+
+namespace Geometry2d {
+
+// A field's worth of robot-sized circles plus a few larger shapes
+static ShapeSet exampleObstacles() {
+    mt19937 gen(1);
+    uniform_real_distribution<float> xDist(-3, 3), yDist(0, 9);
+
+    ShapeSet obstacles;
+    for (int i = 0; i < 40; ++i) {
+        obstacles.add(
+            make_shared<Circle>(Point(xDist(gen), yDist(gen)), Robot_Radius));
+    }
+    obstacles.add(make_shared<Rect>(Point(-1, 0), Point(1, 1)));
+    obstacles.add(make_shared<Polygon>(
+        vector<Point>{Point(-3.5, -0.5), Point(3.5, -0.5), Point(0, -0.2)}));
+
+    auto composite = make_shared<CompositeShape>();
+    composite->add(make_shared<Circle>(Point(0, 8.5), 0.5));
+    composite->add(make_shared<Rect>(Point(-0.5, 8.5), Point(0.5, 9)));
+    obstacles.add(composite);
+
+    return obstacles;
+}
+
+TEST(ShapeSet, indexMatchesLinearScan) {
+    const ShapeSet linear = exampleObstacles();
+    ShapeSet indexed = linear;
+    indexed.buildIndex(0.3);
+    ASSERT_FALSE(linear.indexed());
+    ASSERT_TRUE(indexed.indexed());
+    ASSERT_EQ(1, indexed.maskWords());
+
+    mt19937 gen(2);
+    uniform_real_distribution<float> xDist(-4, 4), yDist(-1, 10),
+        stepDist(-0.5, 0.5);
+    for (int i = 0; i < 2000; ++i) {
+        Point pt(xDist(gen), yDist(gen));
+        Segment seg(pt, pt + Point(stepDist(gen), stepDist(gen)));
+
+        EXPECT_EQ(linear.hitSet(pt), indexed.hitSet(pt));
+        EXPECT_EQ(linear.hitSet(seg), indexed.hitSet(seg));
+        EXPECT_EQ(linear.anyHit(seg), indexed.anyHit(seg));
+        EXPECT_EQ(linear.firstHit(seg), indexed.firstHit(seg));
+        EXPECT_EQ(linear.firstHit(pt), indexed.firstHit(pt));
+
+        // The mask has the same shapes as the hit set
+        uint64_t mask[1];
+        indexed.hitMask(seg, mask);
+        const auto hits = linear.hitSet(seg);
+        const auto shapes = linear.shapes();
+        for (size_t j = 0; j < shapes.size(); ++j) {
+            EXPECT_EQ(hits.count(shapes[j]) != 0, ((mask[0] >> j) & 1) != 0);
+        }
+        EXPECT_EQ(linear.anyHit(seg, hits), indexed.anyHit(seg, mask));
+    }
+
+    // Long segments cross many cells
+    for (int i = 0; i < 200; ++i) {
+        Segment seg(Point(xDist(gen), yDist(gen)),
+                    Point(xDist(gen), yDist(gen)));
+        EXPECT_EQ(linear.hitSet(seg), indexed.hitSet(seg));
+        EXPECT_EQ(linear.firstHit(seg), indexed.firstHit(seg));
+    }
+}
+
+TEST(ShapeSet, anyHitIgnored) {
+    auto a = make_shared<Circle>(Point(0, 0), 0.5);
+    auto b = make_shared<Circle>(Point(1, 0), 0.5);
+    ShapeSet obstacles;
+    obstacles.add(a);
+    obstacles.add(b);
+    obstacles.buildIndex();
+
+    // Starts inside a and moves into b
+    Segment seg(Point(0, 0), Point(1, 0));
+    EXPECT_TRUE(obstacles.anyHit(seg, {a}));
+    EXPECT_FALSE(obstacles.anyHit(seg, {a, b}));
+    EXPECT_EQ(a, obstacles.firstHit(seg));
+    EXPECT_EQ(nullptr, obstacles.firstHit(Point(5, 5)));
+}
+
+TEST(ShapeSet, firstHitDistance) {
+    auto a = make_shared<Circle>(Point(0, 0), 0.5);
+    auto b = make_shared<Circle>(Point(2, 0), 0.5);
+    ShapeSet obstacles;
+    obstacles.add(a);
+    obstacles.add(b);
+
+    // Circles count as hit within a robot radius of their edge
+    Segment seg(Point(0, 0), Point(3, 0));
+    const float expected = 1.5 - Robot_Radius;
+    float dist = obstacles.firstHitDistance(seg, set<shared_ptr<Shape>>{a});
+    EXPECT_LE(dist, expected);
+    EXPECT_GT(dist, expected - 0.001);
+
+    // The indexed search and the ignored mask give the same contact
+    obstacles.buildIndex();
+    vector<uint64_t> mask(obstacles.maskWords());
+    obstacles.hitMask(Point(0, 0), mask.data());
+    EXPECT_EQ(dist, obstacles.firstHitDistance(seg, mask.data()));
+
+    EXPECT_EQ(0, obstacles.firstHitDistance(seg, set<shared_ptr<Shape>>()));
+    EXPECT_EQ(-1, obstacles.firstHitDistance(Segment(Point(0, 0), Point(0, 3)),
+                                             set<shared_ptr<Shape>>{a}));
+}
+
+TEST(ShapeSet, addView) {
+    const ShapeSet owner = exampleObstacles();
+
+    ShapeSet view;
+    view.add(make_shared<Circle>(Point(10, 10), 0.5));
+    view.addView(owner);
+    ASSERT_EQ(owner.size() + 1, view.size());
+
+    for (int i = 0; i < owner.size(); ++i) {
+        EXPECT_EQ(owner.shapes()[i].get(), view.shapes()[i + 1].get());
+        EXPECT_EQ(0, view.shapes()[i + 1].use_count());
+        EXPECT_EQ(1, owner.shapes()[i].use_count());
+    }
+
+    // Copies of the view don't take ownership either
+    ShapeSet copy = view;
+    EXPECT_EQ(0, copy.shapes()[1].use_count());
+    EXPECT_EQ(1, owner.shapes()[0].use_count());
+
+    view.buildIndex();
+    EXPECT_TRUE(view.hit(Point(10, 10)));
+    for (const Point& pt : {Point(0, 0.5), Point(0, 8.7), Point(3, 3)}) {
+        EXPECT_EQ(owner.hit(pt), view.hit(pt));
+    }
+}
+
+TEST(ShapeSet, addInvalidatesIndex) {
+    ShapeSet obstacles;
+    obstacles.add(make_shared<Circle>(Point(0, 0), 0.5));
+    obstacles.buildIndex();
+    EXPECT_FALSE(obstacles.hit(Point(3, 3)));
+
+    obstacles.add(make_shared<Circle>(Point(3, 3), 0.5));
+    EXPECT_FALSE(obstacles.indexed());
+    EXPECT_TRUE(obstacles.hit(Point(3, 3)));
+
+    obstacles.buildIndex();
+    EXPECT_TRUE(obstacles.hit(Point(3, 3)));
+}
+
+}  // namespace Geometry2d
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded, lock-free single-producer/single-consumer queue.
+ *
+ * @details Exactly one thread may call tryPush() and exactly one (other)
+ * thread may call tryPop() at any time.  Neither call blocks, allocates, or
+ * takes a lock, which makes this suitable for handing data off the control
+ * loop to a worker thread.
+ *
+ * The capacity is rounded up to a power of two so that indices can be wrapped
+ * with a mask.  One slot is never used so full and empty can be distinguished.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : _head(0), _tail(0) {
+        size_t size = 2;
+        while (size < capacity + 1) {
+            size *= 2;
+        }
+        _slots.resize(size);
+        _mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /// Maximum number of elements that can be queued at once
+    size_t capacity() const { return _mask; }
+
+    /// Approximate number of queued elements.  Exact when called from either
+    /// the producer or the consumer while the other side is idle.
+    size_t size() const {
+        size_t head = _head.load(std::memory_order_acquire);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        return (tail - head) & _mask;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /// Producer only.  Returns false (and leaves @value untouched) if the queue
+    /// is full.
+    bool tryPush(T&& value) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & _mask;
+        if (next == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        _slots[tail] = std::move(value);
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value) {
+        T copy = value;
+        return tryPush(std::move(copy));
+    }
+
+    /// Consumer only.  Returns false if the queue is empty.
+    bool tryPop(T& value) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = std::move(_slots[head]);
+        // Don't keep the moved-from object alive in the slot (this matters for
+        // shared_ptr, which would otherwise hold a reference until overwritten)
+        _slots[head] = T();
+        _head.store((head + 1) & _mask, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> _slots;
+    size_t _mask;
+
+    // Keep the indices on separate cache lines so the producer and consumer
+    // don't fight over the same line.
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include <sys/time.h>
 
 namespace RJ {
@@ -90,11 +90,12 @@ int main(int argc, char* argv[]) {
             buf.resize(n);
             visionSocket.readDatagram(&buf[0], n);
 
-            SSL_WrapperPacket* packet = logFrame.add_raw_vision();
-            if (!packet->ParseFromString(buf)) {
+            SSL_WrapperPacket packet;
+            if (!packet.ParseFromString(buf)) {
                 printf("Bad vision packet of %d bytes\n", n);
                 continue;
             }
+            logFrame.add_raw_vision(buf);
         }
 
         // Read referee data
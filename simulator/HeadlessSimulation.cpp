@@ -0,0 +1,65 @@
+#include "HeadlessSimulation.hpp"
+#include "physics/Environment.hpp"
+#include "physics/PhysicsConstants.hpp"
+
+#include <Processor.hpp>
+#include <radio/InProcessRadio.hpp>
+#include <protobuf/messages_robocup_ssl_wrapper.pb.h>
+
+HeadlessSimulation::HeadlessSimulation(const QString& simConfigFile,
+                                       bool blueTeam)
+    : _clock(std::make_shared<RJ::SteppedClock>()),
+      _simEngine(new SimEngine()),
+      _radio(new InProcessRadio(blueTeam)),
+      _frames(0) {
+    _simEngine->initPhysics();
+
+    // The simulator builds its field from the current dimensions in its own
+    // scaled units, but soccer expects them in meters.
+    Field_Dimensions dims = Field_Dimensions::Current_Dimensions;
+    Field_Dimensions::Current_Dimensions = dims * scaling;
+    _env.reset(new Environment(simConfigFile, false, _simEngine.get()));
+    Field_Dimensions::Current_Dimensions = dims;
+
+    _processor.reset(new Processor(true));
+    _processor->clock(_clock);
+    _processor->radio(_radio.get());
+    _processor->blueTeam(blueTeam);
+
+    VisionReceiver* vision = _processor->visionReceiver();
+    _env->visionHandler = [vision](const SSL_WrapperPacket& wrapper) {
+        vision->addPacket(wrapper);
+    };
+
+    // Only the team that soccer is controlling gets reverse packets
+    InProcessRadio* radio = _radio.get();
+    _env->radioRxHandler = [radio](bool blue, const Packet::RadioRx& rx) {
+        if (blue == radio->blueTeam()) {
+            radio->addReverse(rx);
+        }
+    };
+}
+
+HeadlessSimulation::~HeadlessSimulation() {}
+
+void HeadlessSimulation::step() {
+    // Commands from the last Processor frame apply to this physics step
+    _radioTx.clear();
+    _radio->takeSent(_radioTx);
+    for (const Packet::RadioTx& tx : _radioTx) {
+        _env->handleRadioTx(_radio->blueTeam(), tx);
+    }
+
+    _env->stepFixed(FramePeriod / 1000000.0f, _clock->now() / 1000000.0);
+
+    _processor->runFrame();
+
+    _clock->advance(FramePeriod);
+    ++_frames;
+}
+
+void HeadlessSimulation::run(int frames) {
+    for (int i = 0; i < frames; ++i) {
+        step();
+    }
+}
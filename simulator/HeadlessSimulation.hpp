@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Clock.hpp>
+#include <protobuf/RadioTx.pb.h>
+
+#include <QString>
+#include <memory>
+#include <vector>
+
+class Environment;
+class InProcessRadio;
+class Processor;
+class SimEngine;
+
+/**
+ * @brief Runs the simulator and soccer together in one process, in lock-step
+ *
+ * @details Each step() delivers the Processor's radio commands to the
+ * simulated robots, advances the physics by one frame, hands the resulting
+ * vision frame to the Processor, and runs one Processor frame.  Vision and
+ * radio go through in-memory queues (see VisionReceiver::addPacket() and
+ * InProcessRadio) and time comes from a SteppedClock, so nothing waits on
+ * sockets or the wall clock.  A run goes as fast as the machine allows and
+ * every frame sees the same simulated time no matter how long it took.
+ *
+ * The Processor's thread is never started, and neither are the vision and
+ * referee receiver threads, so no sockets are opened and several simulations
+ * can run side by side.  Referee packets can be given to
+ * Processor::refereeModule() with NewRefereeModule::addPacket().
+ * Configuration must be set up before construction, the same as for the
+ * soccer program.
+ */
+class HeadlessSimulation {
+public:
+    /// Simulated time per step, in microseconds
+    static constexpr RJ::Time FramePeriod = 1000000 / 60;
+
+    /// @simConfigFile is the simulator's config file, which lists the robots
+    /// and balls to create.  Robots on @blueTeam are controlled by soccer.
+    HeadlessSimulation(const QString& simConfigFile, bool blueTeam);
+    ~HeadlessSimulation();
+
+    /// Runs one frame of physics and one Processor frame
+    void step();
+
+    /// Runs @frames steps
+    void run(int frames);
+
+    /// Number of steps run so far
+    int frames() const { return _frames; }
+
+    Environment* environment() { return _env.get(); }
+
+    Processor* processor() { return _processor.get(); }
+
+    RJ::SteppedClock* clock() { return _clock.get(); }
+
+private:
+    std::shared_ptr<RJ::SteppedClock> _clock;
+
+    std::unique_ptr<SimEngine> _simEngine;
+    std::unique_ptr<Environment> _env;
+
+    // The Processor uses the radio, so it must be destroyed first
+    std::unique_ptr<InProcessRadio> _radio;
+    std::unique_ptr<Processor> _processor;
+
+    // Commands taken from the radio each step.  Kept to reuse its storage.
+    std::vector<Packet::RadioTx> _radioTx;
+
+    int _frames;
+};
@@ -17,7 +17,7 @@ public:
         bool ballSensorWorks;
         bool chargerWorks;
         unsigned int shell;
-        Robot::RobotRevision revision;
+        Physics::Robot::RobotRevision revision;
     };
 
 signals:
@@ -10,7 +10,9 @@
 class btCollisionShape;
 class btDynamicsWorld;
 
+namespace Physics {
 class Robot;
+}
 class GlutCamera;
 
 class Environment;
@@ -28,7 +30,7 @@ protected:
     Environment* _env;
 
     // Drivable vehicle
-    Robot* _vehicle;
+    Physics::Robot* _vehicle;
     bool _blue;
 
     // Dynamics/Collision Environment parts
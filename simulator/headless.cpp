@@ -0,0 +1,136 @@
+#include "HeadlessSimulation.hpp"
+
+#include <Configuration.hpp>
+#include <Field_Dimensions.hpp>
+#include <Processor.hpp>
+#include <Utils.hpp>
+#include <gameplay/GameplayModule.hpp>
+
+#include <QCoreApplication>
+#include <QDateTime>
+
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [options...]\n", prog);
+    fprintf(stderr, "\t-y:           run as the yellow team\n");
+    fprintf(stderr, "\t-b:           run as the blue team\n");
+    fprintf(stderr, "\t-c <file>:    specify the soccer configuration file\n");
+    fprintf(stderr,
+            "\t-sc <file>:   specify the simulator configuration file\n");
+    fprintf(stderr, "\t-s <seed>:    set random seed (hexadecimal)\n");
+    fprintf(stderr,
+            "\t-pbk <file>:  playbook file name as contained in "
+            "'soccer/gameplay/playbooks/'\n");
+    fprintf(stderr, "\t-n <frames>:  number of frames to run (default 3600)\n");
+    fprintf(stderr, "\t-log <file>:  write a log file\n");
+    fprintf(stderr,
+            "\t-profile <file>: write processing loop timing to a file as "
+            "JSON\n");
+    fprintf(stderr, "\t--smallfield: run with the small/single field\n");
+    exit(1);
+}
+
+/**
+ * Runs soccer against the simulator in one process, without sockets or
+ * sleeping, for a fixed number of frames and reports how long it took.
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    bool blueTeam = false;
+    QString cfgFile = ApplicationRunDirectory().filePath("soccer-sim.cfg");
+    QString simCfgFile = ApplicationRunDirectory().filePath("simulator.cfg");
+    QString logFile;
+    QString profileFile;
+    string playbookFile;
+    long int seed = 0;
+    int frames = 60 * 60;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* var = argv[i];
+
+        if (strcmp(var, "--help") == 0) {
+            usage(argv[0]);
+        } else if (strcmp(var, "-y") == 0) {
+            blueTeam = false;
+        } else if (strcmp(var, "-b") == 0) {
+            blueTeam = true;
+        } else if (strcmp(var, "--smallfield") == 0) {
+            Field_Dimensions::Current_Dimensions =
+                Field_Dimensions::Single_Field_Dimensions;
+        } else if (i + 1 >= argc) {
+            printf("Missing value after %s\n", var);
+            usage(argv[0]);
+        } else if (strcmp(var, "-c") == 0) {
+            cfgFile = argv[++i];
+        } else if (strcmp(var, "-sc") == 0) {
+            simCfgFile = argv[++i];
+        } else if (strcmp(var, "-s") == 0) {
+            seed = strtol(argv[++i], nullptr, 16);
+        } else if (strcmp(var, "-pbk") == 0) {
+            playbookFile = argv[++i];
+        } else if (strcmp(var, "-n") == 0) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(var, "-log") == 0) {
+            logFile = argv[++i];
+        } else if (strcmp(var, "-profile") == 0) {
+            profileFile = argv[++i];
+        } else {
+            printf("Not a valid flag: %s\n", var);
+            usage(argv[0]);
+        }
+    }
+
+    printf("seed %016lx\n", seed);
+    srand48(seed);
+    srand(seed);
+
+    std::shared_ptr<Configuration> config =
+        Configuration::FromRegisteredConfigurables();
+
+    HeadlessSimulation sim(simCfgFile, blueTeam);
+    Processor* processor = sim.processor();
+
+    // There is no referee in the loop
+    processor->refereeModule()->useExternalReferee(false);
+
+    QString error;
+    if (!config->load(cfgFile, error)) {
+        fprintf(stderr, "Can't read initial configuration %s:\n%s\n",
+                (const char*)cfgFile.toLatin1(),
+                (const char*)error.toLatin1());
+        return 1;
+    }
+
+    if (!logFile.isEmpty() && !processor->openLog(logFile)) {
+        printf("Failed to open %s: %m\n", (const char*)logFile.toLatin1());
+    }
+
+    if (playbookFile.size() > 0) {
+        processor->gameplayModule()->loadPlaybook(playbookFile);
+    }
+
+    qint64 start = QDateTime::currentMSecsSinceEpoch();
+    sim.run(frames);
+    double elapsed = (QDateTime::currentMSecsSinceEpoch() - start) / 1000.0;
+
+    double simulated = frames * (HeadlessSimulation::FramePeriod / 1000000.0);
+    printf("Ran %d frames (%.1f s simulated) in %.1f s, %.1fx real time\n",
+           frames, simulated, elapsed,
+           elapsed > 0 ? simulated / elapsed : 0.0);
+
+    processor->closeLog();
+
+    if (!profileFile.isEmpty()) {
+        ofstream out(profileFile.toStdString());
+        processor->profiler().dump(out);
+    }
+
+    return 0;
+}
@@ -3,6 +3,8 @@
 
 #include <stdio.h>
 
+using namespace Physics;
+
 Ball::Ball(Environment* env)
     : Entity(env),
       _ball(nullptr),
@@ -3,6 +3,8 @@
 #include "Entity.hpp"
 #include <physics/SimEngine.hpp>
 
+namespace Physics {
+
 class Ball : public Entity {
 protected:
     // physics components
@@ -25,3 +27,5 @@ public:
 
     void resetScene();
 };
+
+}  // namespace Physics
@@ -22,6 +22,7 @@
 using namespace std;
 using namespace Geometry2d;
 using namespace Packet;
+using namespace Physics;
 
 static const QHostAddress LocalAddress(QHostAddress::LocalHost);
 static const QHostAddress MulticastAddress(SharedVisionAddress);
@@ -103,6 +104,17 @@ void Environment::step() {
     // execute simulation step
     // TODO: execute
 
+    finishStep(tv.tv_sec + (double)tv.tv_usec * 1.0e-6);
+}
+
+void Environment::stepFixed(float dt, double captureTime) {
+    preStep(dt);
+    _simEngine->stepSimulation(dt);
+
+    finishStep(captureTime);
+}
+
+void Environment::finishStep(double captureTime) {
     // Send vision data
     ++_stepCount;
     if (_stepCount == Oversample) {
@@ -111,7 +123,7 @@ void Environment::step() {
         if (_dropFrame) {
             _dropFrame = false;
         } else {
-            sendVision();
+            sendVision(captureTime);
         }
     }
 }
@@ -180,15 +192,13 @@ void Environment::handleSimCommand(const Packet::SimCommand& cmd) {
     }
 }
 
-void Environment::sendVision() {
+void Environment::sendVision(double captureTime) {
     SSL_WrapperPacket wrapper;
     SSL_DetectionFrame* det = wrapper.mutable_detection();
     det->set_frame_number(_frameNumber++);
     det->set_camera_id(0);
 
-    struct timeval tv;
-    gettimeofday(&tv, nullptr);
-    det->set_t_capture(tv.tv_sec + (double)tv.tv_usec * 1.0e-6);
+    det->set_t_capture(captureTime);
     det->set_t_sent(det->t_capture());
 
     for (Robot* robot : _yellow) {
@@ -226,6 +236,11 @@ void Environment::sendVision() {
         }
     }
 
+    if (visionHandler) {
+        visionHandler(wrapper);
+        return;
+    }
+
     std::string buf;
     wrapper.SerializeToString(&buf);
 
@@ -361,11 +376,17 @@ void Environment::handleRadioTx(bool blue, const Packet::RadioTx& tx) {
         } else {
             printf("Commanding nonexistent robot %s:%d\n",
                    blue ? "Blue" : "Yellow", cmd.robot_id());
+            continue;
         }
 
         Packet::RadioRx rx = r->radioRx();
         rx.set_robot_id(r->shell);
 
+        if (radioRxHandler) {
+            radioRxHandler(blue, rx);
+            continue;
+        }
+
         // Send the RX packet
         std::string out;
         rx.SerializeToString(&out);
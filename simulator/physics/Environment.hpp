@@ -9,6 +9,7 @@
 #include <QDomElement>
 #include <QString>
 #include <sys/time.h>
+#include <functional>
 
 #include <Geometry2d/Point.hpp>
 
@@ -22,12 +23,13 @@
 #include "GL_ShapeDrawer.h"
 
 class SSL_DetectionRobot;
+class SSL_WrapperPacket;
 
 class Environment : public QObject {
     Q_OBJECT;
 
 public:
-    typedef QMap<unsigned int, Robot*> RobotMap;
+    typedef QMap<unsigned int, Physics::Robot*> RobotMap;
 
 private:
     // IF true, the next vision frame is dropped.
@@ -36,7 +38,7 @@ private:
 
     RobotMap _blue;
     RobotMap _yellow;
-    QVector<Ball*> _balls;
+    QVector<Physics::Ball*> _balls;
 
     QString _configFile;  //< filename for the config file
 
@@ -67,6 +69,14 @@ public:
 
     int ballVisibility;
 
+    /// If set, vision frames are passed to this instead of being sent over
+    /// the network.  This is used to run the environment in-process.
+    std::function<void(const SSL_WrapperPacket& wrapper)> visionHandler;
+
+    /// If set, reverse radio packets are passed to this instead of being sent
+    /// over the network.
+    std::function<void(bool blue, const Packet::RadioRx& rx)> radioRxHandler;
+
     Environment(const QString& configFile, bool sendShared_, SimEngine* engine);
 
     ~Environment();
@@ -76,7 +86,7 @@ public:
 
     void dropFrame() { _dropFrame = true; }
 
-    const QVector<Ball*>& balls() const { return _balls; }
+    const QVector<Physics::Ball*>& balls() const { return _balls; }
 
     const RobotMap& blue() const { return _blue; }
     const RobotMap& yellow() const { return _yellow; }
@@ -86,13 +96,13 @@ public:
 
     /** add a robot with id i to the environment @ pos */
     void addRobot(bool blue, int id, Geometry2d::Point pos,
-                  Robot::RobotRevision rev);
+                  Physics::Robot::RobotRevision rev);
 
     /** removes a robot with id i from the environment */
     void removeRobot(bool blue, int id);
 
     /** gets a robot with id from the environment */
-    Robot* robot(bool blue, int board_id) const;
+    Physics::Robot* robot(bool blue, int board_id) const;
 
     void reshapeFieldBodies();
 
@@ -100,6 +110,19 @@ public:
     // sets engine forces on robots before physics tick
     void preStep(float deltaTime);
 
+    /**
+     * Runs one step without the timer or sockets: the physics advances by
+     * exactly @dt seconds and the vision frame, if any, is captured at
+     * @captureTime (seconds).  Commands are given with handleRadioTx() and
+     * handleSimCommand() and output goes to visionHandler and radioRxHandler.
+     */
+    void stepFixed(float dt, double captureTime);
+
+    /// Applies commands for one team's robots and replies with their status
+    void handleRadioTx(bool blue, const Packet::RadioTx& data);
+
+    void handleSimCommand(const Packet::SimCommand& cmd);
+
     /**
      * Primary environment step function - called by a timer at a fixed interval
      */
@@ -121,12 +144,13 @@ public:
     bool loadConfigFile();
 
 private:
-    static void convert_robot(const Robot* robot, SSL_DetectionRobot* out);
-    void handleRadioTx(bool blue, const Packet::RadioTx& data);
+    static void convert_robot(const Physics::Robot* robot,
+                              SSL_DetectionRobot* out);
 
-    void handleSimCommand(const Packet::SimCommand& cmd);
+    /// Counts a step and sends a vision frame if one is due
+    void finishStep(double captureTime);
 
-    void sendVision();
+    void sendVision(double captureTime);
 
     // Packet handling
     template <class PACKET>
@@ -4,6 +4,7 @@
 #include "GLDebugFont.h"
 
 using namespace std;
+using namespace Physics;
 
 GlutCamera::GlutCamera(SimEngine* engine)
     : _mode(0),
@@ -10,7 +10,9 @@ class btCollisionShape;
 class btDynamicsWorld;
 class btRigidBody;
 class btTypedConstraint;
+namespace Physics {
 class Robot;
+}
 
 class GlutCamera {
 public:
@@ -29,7 +31,7 @@ public:
 
 protected:
     int _mode;
-    Robot* _vehicle;
+    Physics::Robot* _vehicle;
 
     float _cameraDistance;
     float _ele;  // elevation
@@ -103,7 +105,7 @@ public:
     void setCameraMode(int mode);
     int getCameraMode() { return _mode; }
 
-    void setRobot(Robot* robot) { _vehicle = robot; }
+    void setRobot(Physics::Robot* robot) { _vehicle = robot; }
 
     void setCameraDistance(float dist) { _cameraDistance = dist; }
     float getCameraDistance() const { return _cameraDistance; }
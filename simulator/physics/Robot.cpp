@@ -12,6 +12,7 @@
 #include <Geometry2d/TransformMatrix.hpp>
 
 using namespace Geometry2d;
+using namespace Physics;
 
 // FIXME: parameters have no sensible interpretation static physics parameters
 static const float maxEngineForce =
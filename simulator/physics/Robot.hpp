@@ -6,10 +6,15 @@
 #include <protobuf/RadioTx.pb.h>
 #include <protobuf/RadioRx.pb.h>
 
-class Ball;
 class RobotBallController;
 class GL_ShapeDrawer;
 
+// Robot and Ball are namespaced because soccer has classes with the same names
+// and the headless simulation links the two together.
+namespace Physics {
+
+class Ball;
+
 class Robot : public Entity {
 public:
     enum WheelIndex {
@@ -145,3 +150,5 @@ public:
     void driveForward();
     void driveBackward();
 };
+
+}  // namespace Physics
@@ -6,6 +6,8 @@
 // DEBUG
 #include <stdio.h>
 
+using namespace Physics;
+
 // static constants (guessed with science)
 static const float MouthWidth = 0.075 * scaling;
 static const float MouthHeight = 0.06 * scaling;  // based off ball diam
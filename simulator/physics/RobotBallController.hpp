@@ -6,8 +6,9 @@
 
 #include <stdint.h>
 
+namespace Physics {
 class Robot;
-class Ball;
+}
 class btPairCachingGhostObject;
 
 /// RobotBallController is an object that handles dribbling and kicking/chipping
@@ -23,7 +24,7 @@ protected:
 
     btVector3 _localMouthPos;
 
-    Robot* _parent;
+    Physics::Robot* _parent;
     btRigidBody* _ball;
 
     /// links to the engine
@@ -40,7 +41,7 @@ protected:
     uint64_t _dribble;
 
 public:
-    RobotBallController(Robot* robot);
+    RobotBallController(Physics::Robot* robot);
     ~RobotBallController();
 
     void initPhysics();
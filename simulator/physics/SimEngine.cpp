@@ -165,7 +165,10 @@ btScalar SimEngine::getDeltaTimeMicroseconds() {
 btClock* SimEngine::getClock() { return &_clock; }
 
 void SimEngine::stepSimulation() {
-    float dt = getDeltaTimeMicroseconds() * 0.000001f;
+    stepSimulation(getDeltaTimeMicroseconds() * 0.000001f);
+}
+
+void SimEngine::stepSimulation(float dt) {
     if (_dynamicsWorld) {
         // during idle mode, just run 1 simulation step maximum
         int maxSimSubSteps = 2;
@@ -71,6 +71,10 @@ public:
     /** Key function for advancing the simulation forward in time */
     void stepSimulation();
 
+    /** Advances the simulation by @dt seconds regardless of how much real
+     * time has passed */
+    void stepSimulation(float dt);
+
     btClock* getClock();
 
     void debugDrawWorld();
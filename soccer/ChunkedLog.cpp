@@ -0,0 +1,282 @@
+#include "ChunkedLog.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+using namespace Packet;
+
+namespace ChunkedLog {
+
+const char FileMagic[4] = {'R', 'J', 'L', 'C'};
+const char ChunkMagic[4] = {'C', 'H', 'N', 'K'};
+const char FooterMagic[4] = {'R', 'J', 'L', 'I'};
+
+bool isChunkedLog(const uint8_t* data, size_t size) {
+    return size >= sizeof(FileHeader) &&
+           !memcmp(data, FileMagic, sizeof(FileMagic));
+}
+
+Codec defaultCodec() {
+#ifdef HAVE_ZSTD
+    return Zstd;
+#else
+    return Zlib;
+#endif
+}
+
+bool codecAvailable(Codec codec) {
+    switch (codec) {
+        case NoCompression:
+        case Zlib:
+            return true;
+#ifdef HAVE_ZSTD
+        case Zstd:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+bool codecFromName(const string& name, Codec& codec) {
+    if (name == "none") {
+        codec = NoCompression;
+    } else if (name == "zlib") {
+        codec = Zlib;
+    } else if (name == "zstd") {
+        codec = Zstd;
+    } else {
+        return false;
+    }
+
+    return codecAvailable(codec);
+}
+
+bool compress(Codec codec, const string& in, string& out) {
+    switch (codec) {
+        case NoCompression:
+            out = in;
+            return true;
+
+        case Zlib: {
+            // Fastest level: the logger must keep up with the processing
+            // loop, and most of the gain comes from repeated fields anyway.
+            uLongf size = compressBound(in.size());
+            out.resize(size);
+            if (compress2((Bytef*)&out[0], &size, (const Bytef*)in.data(),
+                          in.size(), Z_BEST_SPEED) != Z_OK) {
+                return false;
+            }
+            out.resize(size);
+            return true;
+        }
+
+#ifdef HAVE_ZSTD
+        case Zstd: {
+            out.resize(ZSTD_compressBound(in.size()));
+            size_t size =
+                ZSTD_compress(&out[0], out.size(), in.data(), in.size(), 1);
+            if (ZSTD_isError(size)) {
+                return false;
+            }
+            out.resize(size);
+            return true;
+        }
+#endif
+
+        default:
+            return false;
+    }
+}
+
+bool decompress(Codec codec, const uint8_t* in, size_t size, size_t rawSize,
+                string& out) {
+    out.resize(rawSize);
+
+    switch (codec) {
+        case NoCompression:
+            if (size != rawSize) {
+                return false;
+            }
+            memcpy(&out[0], in, size);
+            return true;
+
+        case Zlib: {
+            uLongf outSize = rawSize;
+            return uncompress((Bytef*)&out[0], &outSize, in, size) == Z_OK &&
+                   outSize == rawSize;
+        }
+
+#ifdef HAVE_ZSTD
+        case Zstd: {
+            size_t outSize = ZSTD_decompress(&out[0], rawSize, in, size);
+            return !ZSTD_isError(outSize) && outSize == rawSize;
+        }
+#endif
+
+        default:
+            return false;
+    }
+}
+
+}  // namespace ChunkedLog
+
+using namespace ChunkedLog;
+
+ChunkedLogWriter::ChunkedLogWriter(Codec codec, size_t chunkSize)
+    : _codec(codec),
+      _chunkSize(chunkSize),
+      _fd(-1),
+      _offset(0),
+      _frames(0),
+      _chunkFrames(0),
+      _startTime(0),
+      _endTime(0) {}
+
+ChunkedLogWriter::~ChunkedLogWriter() { close(); }
+
+bool ChunkedLogWriter::open(const string& filename) {
+    close();
+
+    if (!codecAvailable(_codec)) {
+        errno = ENOTSUP;
+        return false;
+    }
+
+    _fd = creat(filename.c_str(), 0666);
+    if (_fd < 0) {
+        return false;
+    }
+
+    _offset = 0;
+    _frames = 0;
+    _chunk.clear();
+    _chunkFrames = 0;
+    _index.clear();
+
+    FileHeader header;
+    memcpy(header.magic, FileMagic, sizeof(FileMagic));
+    header.version = Version;
+    return writeAll(&header, sizeof(header));
+}
+
+bool ChunkedLogWriter::close() {
+    if (_fd < 0) {
+        return true;
+    }
+
+    bool ok = flush();
+
+    if (ok) {
+        Footer footer;
+        footer.indexOffset = _offset;
+        footer.chunks = _index.size();
+        memcpy(footer.magic, FooterMagic, sizeof(FooterMagic));
+        footer.version = Version;
+
+        ok = writeAll(_index.data(), _index.size() * sizeof(_index[0])) &&
+             writeAll(&footer, sizeof(footer));
+    }
+
+    // Report the first error
+    int error = errno;
+    if (::close(_fd) != 0 && ok) {
+        ok = false;
+    } else if (!ok) {
+        errno = error;
+    }
+    _fd = -1;
+
+    return ok;
+}
+
+bool ChunkedLogWriter::addFrame(const LogFrame& frame) {
+    if (_fd < 0) {
+        errno = EBADF;
+        return false;
+    }
+
+    uint32_t size = frame.ByteSize();
+    _chunk.append((const char*)&size, sizeof(size));
+    frame.AppendPartialToString(&_chunk);
+
+    if (!_chunkFrames) {
+        _startTime = frame.command_time();
+    }
+    _endTime = frame.command_time();
+    ++_chunkFrames;
+    ++_frames;
+
+    if (_chunk.size() >= _chunkSize) {
+        return flush();
+    }
+
+    return true;
+}
+
+bool ChunkedLogWriter::flush() {
+    if (!_chunkFrames) {
+        return true;
+    }
+
+    if (!compress(_codec, _chunk, _compressed)) {
+        errno = EIO;
+        return false;
+    }
+
+    ChunkHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ChunkMagic, sizeof(ChunkMagic));
+    header.codec = _codec;
+    header.frames = _chunkFrames;
+    header.rawSize = _chunk.size();
+    header.compressedSize = _compressed.size();
+    header.startTime = _startTime;
+    header.endTime = _endTime;
+
+    IndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = _offset;
+    entry.firstFrame = _frames - _chunkFrames;
+    entry.frames = _chunkFrames;
+    entry.startTime = _startTime;
+    entry.endTime = _endTime;
+
+    _chunk.clear();
+    _chunkFrames = 0;
+
+    if (!writeAll(&header, sizeof(header)) ||
+        !writeAll(_compressed.data(), _compressed.size())) {
+        return false;
+    }
+
+    _index.push_back(entry);
+    return true;
+}
+
+bool ChunkedLogWriter::writeAll(const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size) {
+        ssize_t n = write(_fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        p += n;
+        size -= n;
+        _offset += n;
+    }
+
+    return true;
+}
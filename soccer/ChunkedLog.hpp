@@ -0,0 +1,176 @@
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compressed log file format
+ *
+ * @details A chunked log starts with a FileHeader, followed by chunks of
+ * consecutive frames.  Each chunk is a ChunkHeader followed by a compressed
+ * block.  When decompressed, the block holds the chunk's frames in the same
+ * form as an uncompressed log: a 32-bit size, then the serialized LogFrame.
+ *
+ * When the log is closed, an index with one IndexEntry per chunk is written
+ * after the last chunk, followed by a Footer that locates it.  The index gives
+ * the frame numbers and command_time range of every chunk, so a reader can
+ * find any frame or time without reading the chunks.  If the log was not
+ * closed cleanly, the same information can be recovered by walking the chunk
+ * headers.
+ *
+ * All integers are little-endian, as in uncompressed logs.
+ */
+namespace ChunkedLog {
+
+enum Codec : uint8_t {
+    NoCompression = 0,
+    Zlib = 1,
+
+    /// Only available when built with libzstd
+    Zstd = 2
+};
+
+const uint32_t Version = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+};
+
+struct ChunkHeader {
+    char magic[4];
+    uint8_t codec;
+    uint8_t reserved[3];
+
+    /// Number of frames in the chunk
+    uint32_t frames;
+
+    /// Size of the block before and after compression
+    uint32_t rawSize;
+    uint32_t compressedSize;
+
+    /// command_time of the first and last frames
+    uint64_t startTime;
+    uint64_t endTime;
+};
+
+struct IndexEntry {
+    /// Offset of the ChunkHeader from the start of the file
+    uint64_t offset;
+
+    /// Frame number of the chunk's first frame
+    uint64_t firstFrame;
+    uint32_t frames;
+    uint32_t reserved;
+
+    uint64_t startTime;
+    uint64_t endTime;
+};
+
+struct Footer {
+    /// Offset of the first IndexEntry
+    uint64_t indexOffset;
+    uint64_t chunks;
+    char magic[4];
+    uint32_t version;
+};
+
+static_assert(sizeof(FileHeader) == 8, "FileHeader must not have padding");
+static_assert(sizeof(ChunkHeader) == 40, "ChunkHeader must not have padding");
+static_assert(sizeof(IndexEntry) == 40, "IndexEntry must not have padding");
+static_assert(sizeof(Footer) == 24, "Footer must not have padding");
+
+extern const char FileMagic[4];
+extern const char ChunkMagic[4];
+extern const char FooterMagic[4];
+
+/// Returns true if @data starts with a chunked log's FileHeader
+bool isChunkedLog(const uint8_t* data, size_t size);
+
+/// Best codec that this build supports
+Codec defaultCodec();
+
+bool codecAvailable(Codec codec);
+
+/// Codec with the given name ("none", "zlib", or "zstd").  Returns false if
+/// the name is not recognized or the codec is not available.
+bool codecFromName(const std::string& name, Codec& codec);
+
+bool compress(Codec codec, const std::string& in, std::string& out);
+
+/// Decompresses @size bytes at @in, which must produce exactly @rawSize bytes
+bool decompress(Codec codec, const uint8_t* in, size_t size, size_t rawSize,
+                std::string& out);
+
+}  // namespace ChunkedLog
+
+/**
+ * @brief Writes LogFrames to a chunked log file
+ *
+ * @details Frames are buffered until the chunk reaches chunkSize() bytes, then
+ * compressed and written.  If the program dies without calling close(), the
+ * frames in the current chunk are lost but the rest of the file is still
+ * readable.
+ *
+ * Errors are reported by returning false with errno set.
+ */
+class ChunkedLogWriter {
+public:
+    /// Default size of a chunk before compression
+    static const size_t DefaultChunkSize = 1 << 20;
+
+    explicit ChunkedLogWriter(ChunkedLog::Codec codec =
+                                  ChunkedLog::defaultCodec(),
+                              size_t chunkSize = DefaultChunkSize);
+    ~ChunkedLogWriter();
+
+    ChunkedLogWriter(const ChunkedLogWriter&) = delete;
+    ChunkedLogWriter& operator=(const ChunkedLogWriter&) = delete;
+
+    /// Creates @filename and writes the file header
+    bool open(const std::string& filename);
+
+    /// Writes the last chunk and the index, then closes the file.  Does
+    /// nothing if no file is open.
+    bool close();
+
+    bool isOpen() const { return _fd >= 0; }
+
+    bool addFrame(const Packet::LogFrame& frame);
+
+    /// Compresses and writes the frames that have been added so far
+    bool flush();
+
+    ChunkedLog::Codec codec() const { return _codec; }
+    size_t chunkSize() const { return _chunkSize; }
+
+    /// Number of frames added since the file was opened
+    uint64_t frames() const { return _frames; }
+
+    /// Number of bytes written to the file so far
+    uint64_t bytesWritten() const { return _offset; }
+
+private:
+    bool writeAll(const void* data, size_t size);
+
+    ChunkedLog::Codec _codec;
+    size_t _chunkSize;
+
+    int _fd;
+    uint64_t _offset;
+    uint64_t _frames;
+
+    /// Uncompressed frames in the current chunk
+    std::string _chunk;
+    uint32_t _chunkFrames;
+    uint64_t _startTime;
+    uint64_t _endTime;
+
+    /// Reused compression buffer
+    std::string _compressed;
+
+    std::vector<ChunkedLog::IndexEntry> _index;
+};
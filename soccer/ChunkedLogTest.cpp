@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "ChunkedLog.hpp"
+#include "LogReader.hpp"
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+string tempFilename() {
+    char filename[] = "/tmp/ChunkedLogTest.XXXXXX";
+    close(mkstemp(filename));
+    return filename;
+}
+
+/// Fills in a frame that compresses about as well as a real one: the same
+/// debug text repeated in every frame.
+void makeFrame(int i, LogFrame& frame) {
+    frame.Clear();
+    frame.set_command_time(1000000 + i * 16667);
+    frame.set_timestamp(frame.command_time());
+    frame.set_blue_team(i % 2);
+    for (int j = 0; j < 20; ++j) {
+        frame.add_debug_texts()->set_text("Play: OurKickoff, role: striker");
+    }
+}
+
+}  // namespace
+
+TEST(ChunkedLog, codecs) {
+    string data;
+    for (int i = 0; i < 1000; ++i) {
+        data += "frame " + to_string(i % 7) + " ";
+    }
+
+    for (ChunkedLog::Codec codec :
+         {ChunkedLog::NoCompression, ChunkedLog::Zlib, ChunkedLog::Zstd}) {
+        if (!ChunkedLog::codecAvailable(codec)) {
+            continue;
+        }
+
+        string compressed, decompressed;
+        ASSERT_TRUE(ChunkedLog::compress(codec, data, compressed));
+        ASSERT_TRUE(ChunkedLog::decompress(
+            codec, (const uint8_t*)compressed.data(), compressed.size(),
+            data.size(), decompressed));
+        EXPECT_EQ(data, decompressed);
+
+        // The size must match exactly
+        EXPECT_FALSE(ChunkedLog::decompress(
+            codec, (const uint8_t*)compressed.data(), compressed.size(),
+            data.size() + 1, decompressed));
+    }
+}
+
+TEST(ChunkedLog, readBack) {
+    string filename = tempFilename();
+
+    ChunkedLogWriter writer(ChunkedLog::defaultCodec(), 16 * 1024);
+    ASSERT_TRUE(writer.open(filename));
+    LogFrame frame;
+    for (int i = 0; i < 500; ++i) {
+        makeFrame(i, frame);
+        ASSERT_TRUE(writer.addFrame(frame));
+    }
+    ASSERT_TRUE(writer.close());
+
+    LogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_TRUE(reader.chunked());
+    EXPECT_TRUE(reader.indexLoaded());
+    EXPECT_FALSE(reader.truncated());
+    ASSERT_EQ(500, reader.size());
+
+    for (int i : {0, 1, 123, 250, 499}) {
+        makeFrame(i, frame);
+        EXPECT_EQ(frame.SerializeAsString(),
+                  reader.frame(i)->SerializeAsString());
+    }
+
+    // Repetitive frames compress well
+    struct stat st;
+    ASSERT_EQ(0, stat(filename.c_str(), &st));
+    EXPECT_LT(st.st_size, 500 * frame.ByteSize() / 5);
+
+    unlink(filename.c_str());
+}
+
+TEST(ChunkedLog, unfinishedLog) {
+    string filename = tempFilename();
+
+    ChunkedLogWriter writer(ChunkedLog::defaultCodec(), 16 * 1024);
+    ASSERT_TRUE(writer.open(filename));
+    LogFrame frame;
+    for (int i = 0; i < 500; ++i) {
+        makeFrame(i, frame);
+        ASSERT_TRUE(writer.addFrame(frame));
+    }
+    ASSERT_TRUE(writer.flush());
+    uint64_t chunksEnd = writer.bytesWritten();
+    ASSERT_TRUE(writer.close());
+
+    // Remove the index and part of the last chunk, as if the program had
+    // crashed while writing it
+    ASSERT_EQ(0, truncate(filename.c_str(), chunksEnd - 10));
+
+    // The complete chunks are still readable
+    LogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_FALSE(reader.indexLoaded());
+    EXPECT_TRUE(reader.truncated());
+    EXPECT_GT(reader.size(), 0);
+    EXPECT_LT(reader.size(), 500);
+    EXPECT_EQ(1000000u, reader.frame(0)->command_time());
+
+    unlink(filename.c_str());
+}
+
+TEST(ChunkedLog, frameAtTime) {
+    string filename = tempFilename();
+
+    ChunkedLogWriter writer(ChunkedLog::defaultCodec(), 4 * 1024);
+    ASSERT_TRUE(writer.open(filename));
+    LogFrame frame;
+    for (int i = 0; i < 300; ++i) {
+        makeFrame(i, frame);
+        ASSERT_TRUE(writer.addFrame(frame));
+    }
+    ASSERT_TRUE(writer.close());
+
+    LogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ(0, reader.frameAtTime(0));
+    EXPECT_EQ(0, reader.frameAtTime(1000000));
+    EXPECT_EQ(100, reader.frameAtTime(1000000 + 100 * 16667));
+    EXPECT_EQ(100, reader.frameAtTime(1000000 + 100 * 16667 + 100));
+    EXPECT_EQ(299, reader.frameAtTime(10000000000ull));
+
+    unlink(filename.c_str());
+}
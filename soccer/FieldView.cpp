@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 #include <Network.hpp>
+#include <protobuf/messages_robocup_ssl_wrapper.pb.h>
 #include <LogUtils.hpp>
 #include <Constants.hpp>
 #include <Geometry2d/Point.hpp>
@@ -189,8 +190,9 @@ void FieldView::drawWorldSpace(QPainter& p) {
     if (showRawBalls || showRawRobots) {
         tempPen.setColor(QColor(0xcc, 0xcc, 0xcc));
         p.setPen(tempPen);
-        for (const SSL_WrapperPacket& wrapper : frame->raw_vision()) {
-            if (!wrapper.has_detection()) {
+        SSL_WrapperPacket wrapper;
+        for (const string& raw : frame->raw_vision()) {
+            if (!wrapper.ParseFromString(raw) || !wrapper.has_detection()) {
                 // Useless
                 continue;
             }
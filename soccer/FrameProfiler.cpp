@@ -0,0 +1,198 @@
+#include "FrameProfiler.hpp"
+
+#include <protobuf/LogFrame.pb.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+//// LatencyHistogram ////
+
+LatencyHistogram::LatencyHistogram(int window)
+    : _samples(window), _next(0), _count(0), _buckets(NumBuckets) {}
+
+int LatencyHistogram::bucket(uint32_t us) {
+    if (us < 32) {
+        return us;
+    }
+
+    // Keep the top five bits: the leading one and 16 steps below it
+    int msb = 31 - __builtin_clz(us);
+    int shift = msb - 4;
+    return shift * 16 + (us >> shift);
+}
+
+uint32_t LatencyHistogram::bucketMax(int bucket) {
+    if (bucket < 32) {
+        return bucket;
+    }
+
+    int shift = bucket / 16 - 1;
+    uint64_t top = bucket - shift * 16;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::add(uint32_t us) {
+    if (_count == (int)_samples.size()) {
+        --_buckets[bucket(_samples[_next])];
+    } else {
+        ++_count;
+    }
+
+    _samples[_next] = us;
+    ++_buckets[bucket(us)];
+    _next = (_next + 1) % _samples.size();
+}
+
+uint32_t LatencyHistogram::percentile(double p) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    int rank = std::max(1, (int)ceil(p * _count));
+    int seen = 0;
+    for (int i = 0; i < NumBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            // The top bucket's range can go past the largest sample
+            return min(bucketMax(i), max());
+        }
+    }
+
+    return max();
+}
+
+uint32_t LatencyHistogram::max() const {
+    uint32_t result = 0;
+    for (int i = 0; i < _count; ++i) {
+        result = std::max(result, _samples[i]);
+    }
+    return result;
+}
+
+void LatencyHistogram::clear() {
+    _next = 0;
+    _count = 0;
+    fill(_buckets.begin(), _buckets.end(), 0);
+}
+
+//// FrameProfiler ////
+
+FrameProfiler::FrameProfiler()
+    : _frames(0), _histograms(NumStages, LatencyHistogram(WindowSize)) {
+    fill(_current, _current + NumStages, 0);
+    fill(_last, _last + NumStages, 0);
+}
+
+const char* FrameProfiler::stageName(Stage stage) {
+    switch (stage) {
+        case Total:
+            return "total";
+        case Setup:
+            return "setup";
+        case Vision:
+            return "vision";
+        case RadioReceive:
+            return "radio_receive";
+        case LoopLock:
+            return "loop_lock";
+        case Joysticks:
+            return "joysticks";
+        case Models:
+            return "models";
+        case Referee:
+            return "referee";
+        case Gameplay:
+            return "gameplay";
+        case Obstacles:
+            return "obstacles";
+        case Planning:
+            return "planning";
+        case Visualization:
+            return "visualization";
+        case MotionControl:
+            return "motion_control";
+        case LogFrame:
+            return "log_frame";
+        case RadioSend:
+            return "radio_send";
+        case Logging:
+            return "logging";
+        default:
+            return "unknown";
+    }
+}
+
+void FrameProfiler::beginFrame() {
+    _frameStart = Clock::now();
+    _lastMark = _frameStart;
+    fill(_current, _current + NumStages, 0);
+}
+
+void FrameProfiler::mark(Stage stage) {
+    Clock::time_point now = Clock::now();
+    _current[stage] +=
+        chrono::duration_cast<chrono::microseconds>(now - _lastMark).count();
+    _lastMark = now;
+}
+
+void FrameProfiler::endFrame() {
+    _current[Total] = chrono::duration_cast<chrono::microseconds>(
+                          Clock::now() - _frameStart).count();
+
+    lock_guard<mutex> lock(_mutex);
+    ++_frames;
+    for (int i = 0; i < NumStages; ++i) {
+        _last[i] = _current[i];
+        _histograms[i].add(_current[i]);
+    }
+}
+
+int FrameProfiler::frames() const {
+    lock_guard<mutex> lock(_mutex);
+    return _frames;
+}
+
+FrameProfiler::Stats FrameProfiler::stats(Stage stage) const {
+    lock_guard<mutex> lock(_mutex);
+
+    const LatencyHistogram& h = _histograms[stage];
+    Stats s;
+    s.last = _last[stage];
+    s.p50 = h.percentile(0.5);
+    s.p99 = h.percentile(0.99);
+    s.max = h.max();
+    return s;
+}
+
+void FrameProfiler::log(Packet::LogFrame* frame) const {
+    lock_guard<mutex> lock(_mutex);
+    if (_frames == 0) {
+        return;
+    }
+
+    // Percentiles can be found from the logged times, so only these are kept
+    for (int i = 0; i < NumStages; ++i) {
+        frame->add_stage_time(_last[i]);
+    }
+}
+
+void FrameProfiler::dump(ostream& out) const {
+    out << "{\n";
+    out << "  \"frames\": " << frames() << ",\n";
+    out << "  \"window\": " << WindowSize << ",\n";
+    out << "  \"units\": \"us\",\n";
+    out << "  \"stages\": [\n";
+    for (int i = 0; i < NumStages; ++i) {
+        Stats s = stats((Stage)i);
+        out << "    {\"stage\": \"" << stageName((Stage)i) << "\", "
+            << "\"last\": " << s.last << ", "
+            << "\"p50\": " << s.p50 << ", "
+            << "\"p99\": " << s.p99 << ", "
+            << "\"max\": " << s.max << "}"
+            << (i + 1 < NumStages ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Packet {
+class LogFrame;
+}
+
+/**
+ * @brief Distribution of the most recent latency samples
+ *
+ * @details Samples are counted in buckets that are exact below 32us and then
+ * split each power of two into 16 parts, so percentiles are accurate to about
+ * 6% at any scale.  Only the last @window samples are counted: the oldest one
+ * is removed as each new one is added.
+ */
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(int window);
+
+    /// Adds a sample in microseconds
+    void add(uint32_t us);
+
+    /// Number of samples in the window
+    int count() const { return _count; }
+
+    /// Approximate value that @p (0 to 1) of the samples are at or below.
+    /// Returns 0 if there are no samples.
+    uint32_t percentile(double p) const;
+
+    /// Largest sample in the window
+    uint32_t max() const;
+
+    void clear();
+
+    static int bucket(uint32_t us);
+
+    /// Largest value that falls in @bucket
+    static uint32_t bucketMax(int bucket);
+
+    static const int NumBuckets = 29 * 16;
+
+private:
+    std::vector<uint32_t> _samples;
+    int _next;
+    int _count;
+
+    std::vector<int> _buckets;
+};
+
+/**
+ * @brief Measures how long each stage of the processing loop takes
+ *
+ * @details The Processor calls beginFrame() at the start of each frame, mark()
+ * at the end of each stage, and endFrame() when the frame is done.  Time is
+ * taken from a monotonic clock, so this measures real time even when the
+ * Processor is driven by a simulated clock.
+ *
+ * Marking a stage is just a clock read, so this is always on.  Results are
+ * kept for the last WindowSize frames and may be read from any thread.
+ */
+class FrameProfiler {
+public:
+    /// Logs record stage times by their index here (see log()), so new stages
+    /// must be added just before NumStages.
+    enum Stage {
+        /// The whole frame, from beginFrame() to endFrame()
+        Total,
+
+        /// Starting the LogFrame and applying robot configs
+        Setup,
+
+        /// Reading and filtering vision packets
+        Vision,
+
+        /// Reading reverse radio packets
+        RadioReceive,
+
+        /// Waiting for the loop mutex, which the GUI also takes
+        LoopLock,
+
+        /// Joystick::update
+        Joysticks,
+
+        /// Filters and ball tracking (Processor::runModels)
+        Models,
+
+        /// Referee state updates
+        Referee,
+
+        /// GameplayModule::run
+        Gameplay,
+
+        /// Collecting obstacles and building plan requests
+        Obstacles,
+
+        /// Path planner
+        Planning,
+
+        /// Drawing the global obstacles
+        Visualization,
+
+        /// Motion control for each robot
+        MotionControl,
+
+        /// Filling in robot and ball state in the LogFrame
+        LogFrame,
+
+        /// Processor::sendRadioData
+        RadioSend,
+
+        /// Logger::addFrame
+        Logging,
+
+        NumStages
+    };
+
+    struct Stats {
+        /// Time in the most recent frame
+        uint32_t last = 0;
+
+        uint32_t p50 = 0;
+        uint32_t p99 = 0;
+        uint32_t max = 0;
+    };
+
+    /// Number of frames that statistics are kept for: ten seconds at 60Hz
+    static const int WindowSize = 600;
+
+    FrameProfiler();
+
+    static const char* stageName(Stage stage);
+
+    void beginFrame();
+
+    /// Charges the time since the last mark (or beginFrame()) to @stage.  Each
+    /// stage should be marked at most once per frame.
+    void mark(Stage stage);
+
+    void endFrame();
+
+    /// Number of frames that have been profiled
+    int frames() const;
+
+    /// Statistics in microseconds over the last WindowSize frames
+    Stats stats(Stage stage) const;
+
+    /// Adds the most recent complete frame's stage times to @frame
+    void log(Packet::LogFrame* frame) const;
+
+    /// Writes the statistics for all stages as JSON
+    void dump(std::ostream& out) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // Only used by the thread that runs the frames
+    Clock::time_point _frameStart;
+    Clock::time_point _lastMark;
+    uint32_t _current[NumStages];
+
+    // Protects everything below
+    mutable std::mutex _mutex;
+    int _frames;
+    uint32_t _last[NumStages];
+    std::vector<LatencyHistogram> _histograms;
+};
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "FrameProfiler.hpp"
+#include <protobuf/LogFrame.pb.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+TEST(LatencyHistogram, bucketsCoverEveryValue) {
+    // Each bucket starts right after the previous one ends
+    for (int b = 1; b < LatencyHistogram::NumBuckets; ++b) {
+        uint32_t first = LatencyHistogram::bucketMax(b - 1) + 1;
+        EXPECT_EQ(b, LatencyHistogram::bucket(first));
+        EXPECT_EQ(b, LatencyHistogram::bucket(LatencyHistogram::bucketMax(b)));
+    }
+    EXPECT_EQ(0xffffffffu,
+              LatencyHistogram::bucketMax(LatencyHistogram::NumBuckets - 1));
+}
+
+TEST(LatencyHistogram, percentiles) {
+    LatencyHistogram h(1000);
+    EXPECT_EQ(0u, h.percentile(0.5));
+    EXPECT_EQ(0u, h.max());
+
+    std::mt19937 random(1);
+    std::uniform_int_distribution<uint32_t> dist(10, 20000);
+    std::vector<uint32_t> samples;
+    for (int i = 0; i < 1000; ++i) {
+        samples.push_back(dist(random));
+        h.add(samples.back());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    EXPECT_EQ(1000, h.count());
+    EXPECT_EQ(samples.back(), h.max());
+
+    // Percentiles are rounded up to the end of their bucket
+    for (double p : {0.5, 0.9, 0.99}) {
+        uint32_t exact = samples[(int)(p * samples.size()) - 1];
+        EXPECT_GE(h.percentile(p), exact);
+        EXPECT_LE(h.percentile(p), exact * 1.07);
+    }
+}
+
+TEST(LatencyHistogram, window) {
+    LatencyHistogram h(10);
+    for (int i = 0; i < 10; ++i) {
+        h.add(5000);
+    }
+    EXPECT_EQ(5000u, h.max());
+
+    // Old samples fall out of the window
+    for (int i = 0; i < 10; ++i) {
+        h.add(7);
+    }
+    EXPECT_EQ(10, h.count());
+    EXPECT_EQ(7u, h.max());
+    EXPECT_EQ(7u, h.percentile(0.99));
+}
+
+TEST(FrameProfiler, stages) {
+    FrameProfiler profiler;
+    EXPECT_EQ(0, profiler.frames());
+
+    // Nothing to log until a frame is done
+    Packet::LogFrame frame;
+    profiler.log(&frame);
+    EXPECT_EQ(0, frame.stage_time_size());
+
+    for (int i = 0; i < 3; ++i) {
+        profiler.beginFrame();
+        profiler.mark(FrameProfiler::Vision);
+        profiler.mark(FrameProfiler::Planning);
+        profiler.endFrame();
+    }
+    EXPECT_EQ(3, profiler.frames());
+
+    FrameProfiler::Stats total = profiler.stats(FrameProfiler::Total);
+    FrameProfiler::Stats planning = profiler.stats(FrameProfiler::Planning);
+    EXPECT_GE(total.max, planning.max);
+    EXPECT_LE(total.p50, total.p99);
+    EXPECT_LE(total.p99, total.max);
+
+    profiler.log(&frame);
+    ASSERT_EQ(FrameProfiler::NumStages, frame.stage_time_size());
+    EXPECT_EQ(total.last, frame.stage_time(FrameProfiler::Total));
+    EXPECT_EQ(planning.last, frame.stage_time(FrameProfiler::Planning));
+
+    std::ostringstream json;
+    profiler.dump(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"frames\": 3"));
+    EXPECT_NE(std::string::npos, json.str().find("\"stage\": \"planning\""));
+}
@@ -0,0 +1,140 @@
+// Converts logs between the uncompressed and chunked formats
+
+#include <ChunkedLog.hpp>
+#include <LogReader.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace std;
+using namespace Packet;
+
+void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [options...] <input.log> <output.log>\n",
+            prog);
+    fprintf(stderr, "\t-codec <name>: none, zlib, or zstd (default: %s)\n",
+            ChunkedLog::defaultCodec() == ChunkedLog::Zstd ? "zstd" : "zlib");
+    fprintf(stderr,
+            "\t-chunk <bytes>: uncompressed size of each chunk "
+            "(default: %zu)\n",
+            ChunkedLogWriter::DefaultChunkSize);
+    fprintf(stderr,
+            "\t-raw: write the old uncompressed format instead of chunks\n");
+    exit(1);
+}
+
+// Writes frames in the uncompressed format: a 32-bit size, then the frame
+bool writeRaw(LogReader& reader, const char* filename) {
+    FILE* fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Can't create %s: %m\n", filename);
+        return false;
+    }
+
+    string data;
+    for (int i = 0; i < reader.size(); ++i) {
+        reader.frame(i)->SerializePartialToString(&data);
+        uint32_t size = data.size();
+        if (fwrite(&size, sizeof(size), 1, fp) != 1 ||
+            fwrite(data.data(), data.size(), 1, fp) != 1) {
+            fprintf(stderr, "Failed to write %s: %m\n", filename);
+            fclose(fp);
+            return false;
+        }
+    }
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Failed to write %s: %m\n", filename);
+        return false;
+    }
+
+    return true;
+}
+
+bool writeChunked(LogReader& reader, const char* filename,
+                  ChunkedLog::Codec codec, size_t chunkSize) {
+    ChunkedLogWriter writer(codec, chunkSize);
+    if (!writer.open(filename)) {
+        fprintf(stderr, "Can't create %s: %m\n", filename);
+        return false;
+    }
+
+    for (int i = 0; i < reader.size(); ++i) {
+        if (!writer.addFrame(*reader.frame(i))) {
+            fprintf(stderr, "Failed to write %s: %m\n", filename);
+            return false;
+        }
+    }
+
+    if (!writer.close()) {
+        fprintf(stderr, "Failed to write %s: %m\n", filename);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ChunkedLog::Codec codec = ChunkedLog::defaultCodec();
+    size_t chunkSize = ChunkedLogWriter::DefaultChunkSize;
+    bool raw = false;
+    const char* inputFile = nullptr;
+    const char* outputFile = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* var = argv[i];
+
+        if (strcmp(var, "-codec") == 0) {
+            if (i + 1 >= argc ||
+                !ChunkedLog::codecFromName(argv[++i], codec)) {
+                fprintf(stderr, "Unknown or unavailable codec\n");
+                usage(argv[0]);
+            }
+        } else if (strcmp(var, "-chunk") == 0) {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+            }
+            chunkSize = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(var, "-raw") == 0) {
+            raw = true;
+        } else if (!inputFile) {
+            inputFile = var;
+        } else if (!outputFile) {
+            outputFile = var;
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    if (!inputFile || !outputFile) {
+        usage(argv[0]);
+    }
+
+    // Frames are read in order and never revisited
+    LogReader reader(1);
+    if (!reader.open(inputFile)) {
+        return 1;
+    }
+
+    bool ok = raw ? writeRaw(reader, outputFile)
+                  : writeChunked(reader, outputFile, codec, chunkSize);
+    if (!ok) {
+        unlink(outputFile);
+        return 1;
+    }
+
+    struct stat in, out;
+    if (stat(inputFile, &in) == 0 && stat(outputFile, &out) == 0 &&
+        out.st_size > 0) {
+        printf("%d frames, %lld -> %lld bytes (%.2fx)\n", reader.size(),
+               (long long)in.st_size, (long long)out.st_size,
+               (double)in.st_size / out.st_size);
+    }
+
+    return 0;
+}
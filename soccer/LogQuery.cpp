@@ -0,0 +1,440 @@
+#include "LogQuery.hpp"
+
+#include <Constants.hpp>
+#include <FrameProfiler.hpp>
+#include <Geometry2d/TransformMatrix.hpp>
+#include <LogReader.hpp>
+#include <protobuf/messages_robocup_ssl_wrapper.pb.h>
+
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Packet;
+using Geometry2d::TransformMatrix;
+
+// Frames further apart than this are not used to find acceleration, since the
+// log was probably paused or cut between them
+static const double MaxFrameGap = 0.1;
+
+namespace {
+
+/// Count, mean, and maximum of a series of values
+struct Summary {
+    uint64_t count = 0;
+    double sum = 0;
+    double sumSq = 0;
+    double max = 0;
+
+    void add(double value) {
+        ++count;
+        sum += value;
+        sumSq += value * value;
+        max = std::max(max, value);
+    }
+
+    void merge(const Summary& other) {
+        count += other.count;
+        sum += other.sum;
+        sumSq += other.sumSq;
+        max = std::max(max, other.max);
+    }
+
+    double mean() const { return count ? sum / count : 0; }
+    double rms() const { return count ? sqrt(sumSq / count) : 0; }
+};
+
+/// Distribution of microsecond times over a whole log, with the same buckets
+/// as LatencyHistogram
+struct Histogram {
+    vector<uint64_t> buckets = vector<uint64_t>(LatencyHistogram::NumBuckets);
+    Summary summary;
+
+    void add(uint32_t us) {
+        ++buckets[LatencyHistogram::bucket(us)];
+        summary.add(us);
+    }
+
+    void merge(const Histogram& other) {
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        summary.merge(other.summary);
+    }
+
+    uint32_t percentile(double p) const {
+        uint64_t rank = std::max<uint64_t>(1, ceil(p * summary.count));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return min<double>(LatencyHistogram::bucketMax(i),
+                                   summary.max);
+            }
+        }
+        return summary.max;
+    }
+};
+
+/// Speed and acceleration of each robot from the filtered world state
+class RobotQuery : public LogQuery {
+public:
+    unique_ptr<LogQuery> clone() const override {
+        return unique_ptr<LogQuery>(new RobotQuery);
+    }
+
+    void add(const LogFrame* prev, const LogFrame& frame) override {
+        double dt = prev ? (double)(frame.timestamp() - prev->timestamp()) /
+                               1000000
+                         : 0;
+        bool haveAccel = dt > 0 && dt < MaxFrameGap;
+        addTeam(0, frame.self(), haveAccel ? &prev->self() : nullptr, dt);
+        addTeam(1, frame.opp(), haveAccel ? &prev->opp() : nullptr, dt);
+    }
+
+    void merge(const LogQuery& other) override {
+        const RobotQuery& q = static_cast<const RobotQuery&>(other);
+        for (const auto& entry : q._robots) {
+            Robot& robot = _robots[entry.first];
+            robot.speed.merge(entry.second.speed);
+            robot.accel.merge(entry.second.accel);
+        }
+    }
+
+    void print(FILE* fp) const override {
+        fprintf(fp,
+                "team,shell,frames,mean_speed,max_speed,mean_accel,"
+                "max_accel\n");
+        for (const auto& entry : _robots) {
+            const Robot& robot = entry.second;
+            fprintf(fp, "%s,%d,%llu,%.3f,%.3f,%.3f,%.3f\n",
+                    entry.first.first == 0 ? "self" : "opp",
+                    entry.first.second, (unsigned long long)robot.speed.count,
+                    robot.speed.mean(), robot.speed.max, robot.accel.mean(),
+                    robot.accel.max);
+        }
+    }
+
+private:
+    typedef google::protobuf::RepeatedPtrField<LogFrame::Robot> Robots;
+
+    void addTeam(int team, const Robots& robots, const Robots* prevRobots,
+                 double dt) {
+        for (const LogFrame::Robot& r : robots) {
+            Robot& robot = _robots[make_pair(team, r.shell())];
+            Geometry2d::Point vel = r.world_vel(), prevVel;
+            robot.speed.add(vel.mag());
+
+            if (prevRobots) {
+                for (const LogFrame::Robot& p : *prevRobots) {
+                    if (p.shell() == r.shell()) {
+                        prevVel = p.world_vel();
+                        robot.accel.add((vel - prevVel).mag() / dt);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    struct Robot {
+        Summary speed;  // m/s
+        Summary accel;  // m/s^2
+    };
+
+    /// Keyed by (0 for self or 1 for opponents, shell)
+    map<pair<int, int>, Robot> _robots;
+};
+
+/// Commands sent to and replies received from each robot
+class RadioQuery : public LogQuery {
+public:
+    unique_ptr<LogQuery> clone() const override {
+        return unique_ptr<LogQuery>(new RadioQuery);
+    }
+
+    void add(const LogFrame* prev, const LogFrame& frame) override {
+        for (const RadioTx::Robot& robot : frame.radio_tx().robots()) {
+            ++_robots[robot.robot_id()].sent;
+        }
+        for (const RadioRx& rx : frame.radio_rx()) {
+            Robot& robot = _robots[rx.robot_id()];
+            ++robot.received;
+            if (rx.has_rssi()) {
+                robot.rssi.add(rx.rssi());
+            }
+        }
+    }
+
+    void merge(const LogQuery& other) override {
+        const RadioQuery& q = static_cast<const RadioQuery&>(other);
+        for (const auto& entry : q._robots) {
+            Robot& robot = _robots[entry.first];
+            robot.sent += entry.second.sent;
+            robot.received += entry.second.received;
+            robot.rssi.merge(entry.second.rssi);
+        }
+    }
+
+    void print(FILE* fp) const override {
+        fprintf(fp, "robot,sent,received,loss,mean_rssi\n");
+        for (const auto& entry : _robots) {
+            const Robot& robot = entry.second;
+            double loss =
+                robot.sent ? max(0.0, 1 - (double)robot.received / robot.sent)
+                           : 0;
+            fprintf(fp, "%u,%llu,%llu,%.4f,%.2f\n", entry.first,
+                    (unsigned long long)robot.sent,
+                    (unsigned long long)robot.received, loss,
+                    robot.rssi.mean());
+        }
+    }
+
+private:
+    struct Robot {
+        uint64_t sent = 0;
+        uint64_t received = 0;
+        Summary rssi;
+    };
+
+    map<uint32_t, Robot> _robots;
+};
+
+/// Distribution of the time taken by each stage of the processing loop
+class TimingQuery : public LogQuery {
+public:
+    unique_ptr<LogQuery> clone() const override {
+        return unique_ptr<LogQuery>(new TimingQuery);
+    }
+
+    void add(const LogFrame* prev, const LogFrame& frame) override {
+        const int n = std::min<int>(frame.stage_time_size(),
+                                    FrameProfiler::NumStages);
+        for (int i = 0; i < n; ++i) {
+            _stages[i].add(frame.stage_time(i));
+        }
+    }
+
+    void merge(const LogQuery& other) override {
+        const TimingQuery& q = static_cast<const TimingQuery&>(other);
+        for (int i = 0; i < FrameProfiler::NumStages; ++i) {
+            _stages[i].merge(q._stages[i]);
+        }
+    }
+
+    void print(FILE* fp) const override {
+        fprintf(fp, "stage,frames,mean_us,p50_us,p99_us,max_us\n");
+        for (int i = 0; i < FrameProfiler::NumStages; ++i) {
+            const Histogram& hist = _stages[i];
+            if (hist.summary.count == 0) {
+                continue;
+            }
+            fprintf(fp, "%s,%llu,%.1f,%u,%u,%.0f\n",
+                    FrameProfiler::stageName((FrameProfiler::Stage)i),
+                    (unsigned long long)hist.summary.count,
+                    hist.summary.mean(), hist.percentile(0.5),
+                    hist.percentile(0.99), hist.summary.max);
+        }
+    }
+
+private:
+    // Indexed by FrameProfiler::Stage
+    vector<Histogram> _stages = vector<Histogram>(FrameProfiler::NumStages);
+};
+
+/// Distance from each raw vision detection to the filtered position logged in
+/// the same frame.  The filtered positions are predicted to the frame's
+/// command time, so this includes the motion over the vision latency.
+class VisionQuery : public LogQuery {
+public:
+    unique_ptr<LogQuery> clone() const override {
+        return unique_ptr<LogQuery>(new VisionQuery);
+    }
+
+    void add(const LogFrame* prev, const LogFrame& frame) override {
+        // Same transformation as Processor::recalculateWorldToTeamTransform.
+        // Logs from before field_length was recorded use the current field.
+        float length = frame.has_field_length()
+                           ? frame.field_length()
+                           : Field_Dimensions::Current_Dimensions.Length();
+        TransformMatrix worldToTeam =
+            TransformMatrix::translate(0, length / 2.0f);
+        worldToTeam *= TransformMatrix::rotate(
+            frame.defend_plus_x() ? -M_PI_2 : M_PI_2);
+
+        for (const string& raw : frame.raw_vision()) {
+            if (!_wrapper.ParseFromString(raw) || !_wrapper.has_detection()) {
+                continue;
+            }
+            const SSL_DetectionFrame& detection = _wrapper.detection();
+
+            if (frame.has_ball() && detection.balls_size() > 0) {
+                // Use the closest detection, since the others are likely to
+                // be false positives
+                Geometry2d::Point ball = frame.ball().pos();
+                float best = -1;
+                for (const SSL_DetectionBall& raw : detection.balls()) {
+                    Geometry2d::Point pos =
+                        worldToTeam *
+                        Geometry2d::Point(raw.x() / 1000, raw.y() / 1000);
+                    float d = (pos - ball).mag();
+                    if (best < 0 || d < best) {
+                        best = d;
+                    }
+                }
+                _error[make_pair(Ball, 0)].add(best);
+            }
+
+            bool blue = frame.blue_team();
+            addTeam(Self, worldToTeam,
+                    blue ? detection.robots_blue() : detection.robots_yellow(),
+                    frame.self());
+            addTeam(Opp, worldToTeam,
+                    blue ? detection.robots_yellow() : detection.robots_blue(),
+                    frame.opp());
+        }
+    }
+
+    void merge(const LogQuery& other) override {
+        const VisionQuery& q = static_cast<const VisionQuery&>(other);
+        for (const auto& entry : q._error) {
+            _error[entry.first].merge(entry.second);
+        }
+    }
+
+    void print(FILE* fp) const override {
+        static const char* names[] = {"self", "opp", "ball"};
+        fprintf(fp, "object,shell,observations,mean_error,rms_error,"
+                    "max_error\n");
+        for (const auto& entry : _error) {
+            const Summary& error = entry.second;
+            fprintf(fp, "%s,%d,%llu,%.4f,%.4f,%.4f\n",
+                    names[entry.first.first], entry.first.second,
+                    (unsigned long long)error.count, error.mean(), error.rms(),
+                    error.max);
+        }
+    }
+
+private:
+    enum Object { Self, Opp, Ball };
+
+    void addTeam(
+        Object object, const TransformMatrix& worldToTeam,
+        const google::protobuf::RepeatedPtrField<SSL_DetectionRobot>& raw,
+        const google::protobuf::RepeatedPtrField<LogFrame::Robot>& filtered) {
+        for (const SSL_DetectionRobot& robot : raw) {
+            if (!robot.has_robot_id()) {
+                continue;
+            }
+
+            for (const LogFrame::Robot& r : filtered) {
+                if (r.shell() == (int)robot.robot_id()) {
+                    Geometry2d::Point pos =
+                        worldToTeam *
+                        Geometry2d::Point(robot.x() / 1000, robot.y() / 1000);
+                    Geometry2d::Point filtered = r.pos();
+                    _error[make_pair(object, r.shell())].add(
+                        (pos - filtered).mag());
+                    break;
+                }
+            }
+        }
+    }
+
+    /// Error in meters keyed by (object, shell)
+    map<pair<int, int>, Summary> _error;
+
+    /// Reused for parsing each packet
+    SSL_WrapperPacket _wrapper;
+};
+
+}  // namespace
+
+unique_ptr<LogQuery> LogQuery::create(const string& name) {
+    if (name == "robots") {
+        return unique_ptr<LogQuery>(new RobotQuery);
+    } else if (name == "radio") {
+        return unique_ptr<LogQuery>(new RadioQuery);
+    } else if (name == "timing") {
+        return unique_ptr<LogQuery>(new TimingQuery);
+    } else if (name == "vision") {
+        return unique_ptr<LogQuery>(new VisionQuery);
+    }
+    return nullptr;
+}
+
+/// Adds blocks of frames to @query until there are none left.  Returns false
+/// if the log could not be opened.
+static bool scan(const string& filename, int size, int blockSize,
+                 atomic<int>& next, LogQuery& query) {
+    // Every frame is visited once, so there is no point caching more than the
+    // one that is kept as the previous frame
+    LogReader reader(2);
+    if (!reader.open(filename)) {
+        return false;
+    }
+    size = min(size, reader.size());
+
+    while (true) {
+        int start = next.fetch_add(blockSize);
+        if (start >= size) {
+            break;
+        }
+        int end = min(start + blockSize, size);
+
+        shared_ptr<LogFrame> prev = reader.frame(start - 1);
+        for (int i = start; i < end; ++i) {
+            shared_ptr<LogFrame> frame = reader.frame(i);
+            query.add(prev.get(), *frame);
+            prev = frame;
+        }
+    }
+
+    return true;
+}
+
+
+int LogQuery::run(const string& filename, int numThreads, int blockSize) {
+    // Opening the log once here builds the sidecar index for an uncompressed
+    // log, so the threads' readers only have to load it
+    int size;
+    {
+        LogReader reader(1);
+        if (!reader.open(filename)) {
+            return -1;
+        }
+        size = reader.size();
+    }
+
+    vector<unique_ptr<LogQuery>> partial;
+    vector<thread> workers;
+    vector<char> ok(numThreads, false);
+    atomic<int> next(0);
+    for (int t = 0; t < numThreads; ++t) {
+        partial.push_back(clone());
+        LogQuery* q = partial.back().get();
+        char* result = &ok[t];
+        workers.emplace_back([=, &filename, &next]() {
+            *result = scan(filename, size, blockSize, next, *q);
+        });
+    }
+
+    // Every thread must be joined before returning, even if one failed
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    for (int t = 0; t < numThreads; ++t) {
+        if (!ok[t]) {
+            return -1;
+        }
+        merge(*partial[t]);
+    }
+
+    return size;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <protobuf/LogFrame.pb.h>
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Statistics computed over every frame of a log, as printed by
+ * log_tool
+ *
+ * @details Frames are scanned in blocks by a pool of threads.  Each thread has
+ * its own LogReader on the same file and its own clone() of the query, so the
+ * threads share nothing but the memory mapping and a counter of the next block
+ * to scan.  Every query's results are sums, counts, maxima, or histograms, so
+ * the clones are merged at the end.
+ */
+class LogQuery {
+public:
+    virtual ~LogQuery() {}
+
+    /// Returns the query called @name ("robots", "radio", "timing", or
+    /// "vision"), or nullptr if there is no such query
+    static std::unique_ptr<LogQuery> create(const std::string& name);
+
+    /// Returns an empty query of the same type for another thread to fill
+    virtual std::unique_ptr<LogQuery> clone() const = 0;
+
+    /// Adds one frame.  @prev is the frame before it, or nullptr for the
+    /// first frame in the log.
+    virtual void add(const Packet::LogFrame* prev,
+                     const Packet::LogFrame& frame) = 0;
+
+    /// Adds the results of a query of the same type
+    virtual void merge(const LogQuery& other) = 0;
+
+    /// Prints the results as CSV
+    virtual void print(FILE* fp) const = 0;
+
+    /**
+     * Adds every frame in the log @filename, using @numThreads threads that
+     * each take @blockSize frames at a time.  Returns the number of frames,
+     * or -1 if the log could not be opened.
+     */
+    int run(const std::string& filename, int numThreads, int blockSize);
+};
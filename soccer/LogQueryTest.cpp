@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "LogQuery.hpp"
+#include "LogReader.hpp"
+#include <protobuf/messages_robocup_ssl_wrapper.pb.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+const int NumFrames = 100;
+
+/// Writes a log in the Logger's format in which robot 1 speeds up by 0.1m/s
+/// every 20ms, robot 2 answers every other radio packet, vision sees robot 1
+/// 0.1m from its filtered position, and each frame takes 1ms of which frame i
+/// spends i us in setup.  Returns the name of the file.
+string writeLog() {
+    char filename[] = "/tmp/LogQueryTest.XXXXXX";
+    int fd = mkstemp(filename);
+    FILE* fp = fdopen(fd, "wb");
+
+    for (int i = 0; i < NumFrames; ++i) {
+        LogFrame frame;
+        frame.set_timestamp(i * 20000);
+        frame.set_blue_team(true);
+        frame.set_defend_plus_x(false);
+        frame.set_field_length(9);
+        frame.add_stage_time(1000);
+        frame.add_stage_time(i);
+
+        LogFrame::Robot* robot = frame.add_self();
+        robot->set_shell(1);
+        robot->set_angle(0);
+        robot->mutable_pos()->set_x(0.5);
+        robot->mutable_pos()->set_y(5.6);
+        robot->mutable_world_vel()->set_x(0.1 * i);
+        robot->mutable_world_vel()->set_y(0);
+
+        frame.mutable_radio_tx()->add_robots()->set_robot_id(2);
+        if (i % 2 == 0) {
+            RadioRx* rx = frame.add_radio_rx();
+            rx->set_timestamp(i);
+            rx->set_robot_id(2);
+            rx->set_rssi(-40);
+        }
+
+        // At (0.5, 5.5) in team coordinates
+        SSL_WrapperPacket wrapper;
+        SSL_DetectionFrame* det = wrapper.mutable_detection();
+        det->set_frame_number(i);
+        det->set_t_capture(0);
+        det->set_t_sent(0);
+        det->set_camera_id(0);
+        SSL_DetectionRobot* seen = det->add_robots_blue();
+        seen->set_confidence(1);
+        seen->set_robot_id(1);
+        seen->set_x(1000);
+        seen->set_y(-500);
+        seen->set_pixel_x(0);
+        seen->set_pixel_y(0);
+        frame.add_raw_vision(wrapper.SerializeAsString());
+
+        string data = frame.SerializePartialAsString();
+        uint32_t size = data.size();
+        fwrite(&size, sizeof(size), 1, fp);
+        fwrite(data.data(), data.size(), 1, fp);
+    }
+
+    fclose(fp);
+    return filename;
+}
+
+/// Runs the query called @name over @filename and returns what it prints
+string runQuery(const string& name, const string& filename) {
+    unique_ptr<LogQuery> query = LogQuery::create(name);
+    EXPECT_NE(nullptr, query);
+
+    // Small blocks on several threads, so the partial results are merged
+    EXPECT_EQ(NumFrames, query->run(filename, 3, 7));
+
+    char* buf = nullptr;
+    size_t len = 0;
+    FILE* fp = open_memstream(&buf, &len);
+    query->print(fp);
+    fclose(fp);
+    string out(buf, len);
+    free(buf);
+    return out;
+}
+
+}  // namespace
+
+TEST(LogQuery, queries) {
+    string filename = writeLog();
+
+    EXPECT_EQ(
+        "team,shell,frames,mean_speed,max_speed,mean_accel,max_accel\n"
+        "self,1,100,4.950,9.900,5.000,5.000\n",
+        runQuery("robots", filename));
+
+    EXPECT_EQ(
+        "robot,sent,received,loss,mean_rssi\n"
+        "2,100,50,0.5000,-40.00\n",
+        runQuery("radio", filename));
+
+    EXPECT_EQ(
+        "object,shell,observations,mean_error,rms_error,max_error\n"
+        "self,1,100,0.1000,0.1000,0.1000\n",
+        runQuery("vision", filename));
+
+    EXPECT_EQ(
+        "stage,frames,mean_us,p50_us,p99_us,max_us\n"
+        "total,100,1000.0,1000,1000,1000\n"
+        "setup,100,49.5,49,99,99\n",
+        runQuery("timing", filename));
+
+    unlink(filename.c_str());
+    unlink(LogReader::indexFilename(filename).c_str());
+}
+
+TEST(LogQuery, missingLog) {
+    EXPECT_EQ(nullptr, LogQuery::create("nonsense"));
+
+    unique_ptr<LogQuery> query = LogQuery::create("timing");
+    EXPECT_EQ(-1, query->run("/nonexistent/LogQueryTest.log", 4, 16));
+}
@@ -0,0 +1,494 @@
+#include "LogReader.hpp"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace Packet;
+using namespace ChunkedLog;
+
+namespace {
+
+// Header of a sidecar index file.  It is followed by count 64-bit offsets.
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t logSize;
+    int64_t logMtime;
+    uint64_t count;
+    uint8_t truncated;
+    uint8_t reserved[7];
+};
+
+const char IndexMagic[4] = {'R', 'J', 'L', 'X'};
+const uint32_t IndexVersion = 1;
+
+bool readAll(int fd, void* buf, size_t size) {
+    return read(fd, buf, size) == (ssize_t)size;
+}
+
+bool writeAll(int fd, const void* buf, size_t size) {
+    return write(fd, buf, size) == (ssize_t)size;
+}
+
+}  // namespace
+
+LogReader::LogReader(int cacheSize)
+    : _cacheSize(max(1, cacheSize)),
+      _fd(-1),
+      _data(nullptr),
+      _fileSize(0),
+      _mtime(0),
+      _size(0),
+      _chunked(false),
+      _truncated(false),
+      _indexLoaded(false) {}
+
+LogReader::~LogReader() { close(); }
+
+string LogReader::indexFilename(const string& filename) {
+    return filename + ".idx";
+}
+
+bool LogReader::open(const string& filename) {
+    close();
+
+    _fd = ::open(filename.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        fprintf(stderr, "Can't open %s: %m\n", filename.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(_fd, &st) < 0) {
+        fprintf(stderr, "Can't stat %s: %m\n", filename.c_str());
+        close();
+        return false;
+    }
+    _fileSize = st.st_size;
+    _mtime = st.st_mtime;
+
+    if (_fileSize == 0) {
+        // mmap can't map an empty file, but an empty log is still valid
+        static const uint8_t empty = 0;
+        _data = &empty;
+        return true;
+    }
+
+    void* data = mmap(nullptr, _fileSize, PROT_READ, MAP_SHARED, _fd, 0);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Can't map %s: %m\n", filename.c_str());
+        close();
+        return false;
+    }
+    _data = (const uint8_t*)data;
+
+    _chunked = isChunkedLog(_data, _fileSize);
+    if (_chunked) {
+        _indexLoaded = loadChunkIndex();
+        if (!_indexLoaded) {
+            buildChunkIndex();
+        }
+
+        if (!_chunks.empty()) {
+            _size = _chunks.back().firstFrame + _chunks.back().frames;
+        }
+    } else {
+        string indexName = indexFilename(filename);
+        _indexLoaded = loadIndex(indexName);
+        if (!_indexLoaded) {
+            buildIndex();
+            saveIndex(indexName);
+        }
+
+        _size = _offsets.size();
+    }
+
+    // Frames are read wherever the user scrubs to, so readahead is wasted
+    madvise((void*)_data, _fileSize, MADV_RANDOM);
+
+    if (_truncated) {
+        fprintf(stderr, "%s: ignoring incomplete data at end of log\n",
+                filename.c_str());
+    }
+
+    return true;
+}
+
+void LogReader::close() {
+    {
+        lock_guard<mutex> lock(_cacheMutex);
+        _cache.clear();
+        _lru.clear();
+        _chunkCache.clear();
+    }
+
+    if (_data && _fileSize) {
+        munmap((void*)_data, _fileSize);
+    }
+    _data = nullptr;
+
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    _offsets.clear();
+    _chunks.clear();
+    _fileSize = 0;
+    _mtime = 0;
+    _size = 0;
+    _chunked = false;
+    _truncated = false;
+    _indexLoaded = false;
+}
+
+void LogReader::buildIndex() {
+    _offsets.clear();
+    _truncated = false;
+
+    uint64_t pos = 0;
+    while (pos < _fileSize) {
+        uint32_t size;
+        if (_fileSize - pos < sizeof(size)) {
+            _truncated = true;
+            break;
+        }
+        memcpy(&size, _data + pos, sizeof(size));
+
+        if (_fileSize - pos - sizeof(size) < size) {
+            _truncated = true;
+            break;
+        }
+
+        _offsets.push_back(pos);
+        pos += sizeof(size) + size;
+    }
+}
+
+bool LogReader::loadIndex(const string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    IndexHeader header;
+    bool valid = readAll(fd, &header, sizeof(header)) &&
+                 !memcmp(header.magic, IndexMagic, sizeof(IndexMagic)) &&
+                 header.version == IndexVersion &&
+                 header.logSize == _fileSize && header.logMtime == _mtime &&
+                 header.count <= _fileSize / sizeof(uint32_t);
+    if (valid) {
+        _offsets.resize(header.count);
+        valid = readAll(fd, _offsets.data(),
+                        _offsets.size() * sizeof(_offsets[0]));
+    }
+    ::close(fd);
+
+    // Make sure every record really fits in the file and ends before the next
+    // one starts, so a stale or corrupt index can't make parseFrame() read
+    // past the mapping.
+    uint64_t end = 0;
+    for (size_t i = 0; valid && i < _offsets.size(); ++i) {
+        uint64_t offset = _offsets[i];
+        if (offset < end || _fileSize - end < sizeof(uint32_t) ||
+            offset > _fileSize - sizeof(uint32_t) ||
+            recordSize(i) > _fileSize - offset - sizeof(uint32_t)) {
+            valid = false;
+        } else {
+            end = offset + sizeof(uint32_t) + recordSize(i);
+        }
+    }
+
+    if (!valid) {
+        _offsets.clear();
+        return false;
+    }
+
+    _truncated = header.truncated;
+    return true;
+}
+
+void LogReader::saveIndex(const string& filename) const {
+    // Write to a temporary file and rename it so that a reader never sees a
+    // partial index.  Failure is harmless: the log is just scanned next time.
+    string tempName = filename + ".tmp";
+    int fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        return;
+    }
+
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IndexMagic, sizeof(IndexMagic));
+    header.version = IndexVersion;
+    header.logSize = _fileSize;
+    header.logMtime = _mtime;
+    header.count = _offsets.size();
+    header.truncated = _truncated;
+
+    bool ok = writeAll(fd, &header, sizeof(header)) &&
+              writeAll(fd, _offsets.data(),
+                       _offsets.size() * sizeof(_offsets[0]));
+    ::close(fd);
+
+    if (!ok || rename(tempName.c_str(), filename.c_str()) < 0) {
+        unlink(tempName.c_str());
+    }
+}
+
+bool LogReader::loadChunkIndex() {
+    Footer footer;
+    if (_fileSize < sizeof(FileHeader) + sizeof(footer)) {
+        return false;
+    }
+    memcpy(&footer, _data + _fileSize - sizeof(footer), sizeof(footer));
+
+    uint64_t indexEnd = _fileSize - sizeof(footer);
+    if (memcmp(footer.magic, FooterMagic, sizeof(FooterMagic)) ||
+        footer.version != Version || footer.indexOffset > indexEnd ||
+        footer.chunks != (indexEnd - footer.indexOffset) / sizeof(IndexEntry) ||
+        (indexEnd - footer.indexOffset) % sizeof(IndexEntry)) {
+        return false;
+    }
+
+    _chunks.resize(footer.chunks);
+    memcpy(_chunks.data(), _data + footer.indexOffset,
+           _chunks.size() * sizeof(IndexEntry));
+
+    // Check that the index is consistent so a bad one can't cause reads past
+    // the end of the mapping
+    uint64_t nextFrame = 0;
+    for (const IndexEntry& entry : _chunks) {
+        if (entry.firstFrame != nextFrame ||
+            entry.offset + sizeof(ChunkHeader) > footer.indexOffset) {
+            _chunks.clear();
+            return false;
+        }
+        nextFrame += entry.frames;
+    }
+
+    return true;
+}
+
+void LogReader::buildChunkIndex() {
+    _chunks.clear();
+    _truncated = false;
+
+    uint64_t pos = sizeof(FileHeader);
+    uint64_t nextFrame = 0;
+    while (pos < _fileSize) {
+        ChunkHeader header;
+        if (_fileSize - pos < sizeof(header)) {
+            _truncated = true;
+            break;
+        }
+        memcpy(&header, _data + pos, sizeof(header));
+
+        if (memcmp(header.magic, ChunkMagic, sizeof(ChunkMagic))) {
+            // Either the index written by close() or garbage from a crash
+            _truncated = memcmp(_data + _fileSize - sizeof(Footer::magic),
+                                FooterMagic, sizeof(FooterMagic)) != 0;
+            break;
+        }
+
+        if (_fileSize - pos - sizeof(header) < header.compressedSize) {
+            _truncated = true;
+            break;
+        }
+
+        IndexEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.offset = pos;
+        entry.firstFrame = nextFrame;
+        entry.frames = header.frames;
+        entry.startTime = header.startTime;
+        entry.endTime = header.endTime;
+        _chunks.push_back(entry);
+
+        nextFrame += header.frames;
+        pos += sizeof(header) + header.compressedSize;
+    }
+}
+
+uint32_t LogReader::recordSize(int i) const {
+    uint32_t size;
+    memcpy(&size, _data + _offsets[i], sizeof(size));
+    return size;
+}
+
+int LogReader::chunkIndex(int i) const {
+    // Last chunk that starts at or before frame i
+    auto iter = upper_bound(_chunks.begin(), _chunks.end(), (uint64_t)i,
+                            [](uint64_t frame, const IndexEntry& entry) {
+                                return frame < entry.firstFrame;
+                            });
+    return iter - _chunks.begin() - 1;
+}
+
+shared_ptr<const LogReader::Chunk> LogReader::chunkForFrame(int i) {
+    int c = chunkIndex(i);
+
+    {
+        lock_guard<mutex> lock(_cacheMutex);
+        for (auto cached = _chunkCache.begin(); cached != _chunkCache.end();
+             ++cached) {
+            if (cached->first == c) {
+                _chunkCache.splice(_chunkCache.begin(), _chunkCache, cached);
+                return cached->second;
+            }
+        }
+    }
+
+    const IndexEntry& entry = _chunks[c];
+    ChunkHeader header;
+    memcpy(&header, _data + entry.offset, sizeof(header));
+
+    shared_ptr<Chunk> chunk = make_shared<Chunk>();
+    bool ok = entry.offset + sizeof(header) + header.compressedSize <=
+                  _fileSize &&
+              decompress((Codec)header.codec, _data + entry.offset +
+                                                   sizeof(header),
+                         header.compressedSize, header.rawSize, chunk->data);
+
+    // Find the frames in the chunk
+    uint32_t pos = 0;
+    while (ok && chunk->offsets.size() < entry.frames) {
+        uint32_t size;
+        if (chunk->data.size() - pos < sizeof(size)) {
+            ok = false;
+            break;
+        }
+        memcpy(&size, &chunk->data[pos], sizeof(size));
+        if (chunk->data.size() - pos - sizeof(size) < size) {
+            ok = false;
+            break;
+        }
+
+        chunk->offsets.push_back(pos);
+        pos += sizeof(size) + size;
+    }
+
+    if (!ok) {
+        fprintf(stderr, "LogReader: chunk %d is corrupt\n", c);
+
+        // Frames that couldn't be found are empty
+        chunk->data.clear();
+        chunk->offsets.clear();
+    }
+
+    lock_guard<mutex> lock(_cacheMutex);
+    _chunkCache.emplace_front(c, chunk);
+    if ((int)_chunkCache.size() > ChunkCacheSize) {
+        _chunkCache.pop_back();
+    }
+
+    return chunk;
+}
+
+void LogReader::parseFrame(int i, LogFrame& frame) {
+    const uint8_t* data;
+    uint32_t size;
+
+    // Keeps a decompressed chunk alive while parsing from it
+    shared_ptr<const Chunk> chunk;
+
+    if (_chunked) {
+        chunk = chunkForFrame(i);
+        size_t n = i - _chunks[chunkIndex(i)].firstFrame;
+        if (n >= chunk->offsets.size()) {
+            return;
+        }
+
+        data = (const uint8_t*)&chunk->data[chunk->offsets[n]];
+        memcpy(&size, data, sizeof(size));
+        data += sizeof(size);
+    } else {
+        data = _data + _offsets[i] + sizeof(uint32_t);
+        size = recordSize(i);
+    }
+
+    // Parse partial so we can recover from corrupt data
+    if (!frame.ParsePartialFromArray(data, size)) {
+        fprintf(stderr, "LogReader: frame %d is corrupt: %s\n", i,
+                frame.InitializationErrorString().c_str());
+    }
+}
+
+int LogReader::frameAtTime(uint64_t time) {
+    int lo = 0;
+    int hi = size();
+
+    // Narrow the search to one chunk using the index
+    if (_chunked && !_chunks.empty()) {
+        auto iter = upper_bound(_chunks.begin(), _chunks.end(), time,
+                                [](uint64_t t, const IndexEntry& entry) {
+                                    return t < entry.startTime;
+                                });
+        if (iter == _chunks.begin()) {
+            return 0;
+        }
+        --iter;
+        lo = iter->firstFrame;
+        hi = iter->firstFrame + iter->frames;
+    }
+
+    // Binary search for the first frame after time
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (frame(mid)->command_time() <= time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return max(0, lo - 1);
+}
+
+shared_ptr<LogFrame> LogReader::frame(int i) {
+    if (i < 0 || i >= size()) {
+        return nullptr;
+    }
+
+    {
+        lock_guard<mutex> lock(_cacheMutex);
+        auto iter = _cache.find(i);
+        if (iter != _cache.end()) {
+            _lru.splice(_lru.begin(), _lru, iter->second.lruPos);
+            return iter->second.frame;
+        }
+    }
+
+    // Parse without holding the lock so other threads can use the cache
+    shared_ptr<LogFrame> frame = make_shared<LogFrame>();
+    parseFrame(i, *frame);
+
+    lock_guard<mutex> lock(_cacheMutex);
+    auto iter = _cache.find(i);
+    if (iter != _cache.end()) {
+        // Another thread parsed it first
+        return iter->second.frame;
+    }
+
+    _lru.push_front(i);
+    _cache[i] = CacheEntry{frame, _lru.begin()};
+
+    if ((int)_cache.size() > _cacheSize) {
+        _cache.erase(_lru.back());
+        _lru.pop_back();
+    }
+
+    return frame;
+}
+
+int LogReader::cachedFrames() const {
+    lock_guard<mutex> lock(_cacheMutex);
+    return _cache.size();
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "ChunkedLog.hpp"
+#include <protobuf/LogFrame.pb.h>
+
+#include <stdint.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Random access to the frames in a log file without loading all of it
+ *
+ * @details Both log formats are supported:
+ *
+ * - Uncompressed logs are a sequence of records, each a 32-bit size followed
+ *   by a serialized LogFrame.  Only the offset of each record is kept, so
+ *   opening a log costs one pass over the record headers no matter how large
+ *   the frames are.  That offset index is saved next to the log as
+ *   <filename>.idx and reused as long as the log's size and modification time
+ *   still match, so the second open of a log does not touch the frame data.
+ *
+ * - Chunked logs (see ChunkedLog.hpp) carry their own index of chunks.  A
+ *   chunk is decompressed when one of its frames is first requested, and the
+ *   most recently used chunks are kept so that playback and scrubbing only
+ *   decompress each chunk once.
+ *
+ * In both cases the file is memory-mapped.  Frames are parsed when they are
+ * first requested and kept in a least-recently-used cache of cacheSize()
+ * frames.  An incomplete record or chunk at the end of the file (from a log
+ * that was not closed cleanly) is ignored and reported by truncated().
+ *
+ * Once a log is open, frame(), frameAtTime() and the const accessors may be
+ * called concurrently from any number of threads.  open() and close() unmap
+ * the file and reset the index without synchronizing with readers, so they
+ * must not overlap any other call.
+ */
+class LogReader {
+public:
+    /// Default number of parsed frames to keep: about 17 seconds at 60Hz
+    static const int DefaultCacheSize = 1024;
+
+    /// Number of decompressed chunks to keep for chunked logs
+    static const int ChunkCacheSize = 4;
+
+    explicit LogReader(int cacheSize = DefaultCacheSize);
+    ~LogReader();
+
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    /// Opens a log, closing any log that was already open.  On failure,
+    /// prints the reason and returns false.
+    bool open(const std::string& filename);
+
+    void close();
+
+    bool isOpen() const { return _data != nullptr; }
+
+    /// Number of complete frames in the log
+    int size() const { return _size; }
+
+    /// True if the log is in the chunked format
+    bool chunked() const { return _chunked; }
+
+    /// True if the file ends with an incomplete record
+    bool truncated() const { return _truncated; }
+
+    /// True if the index was loaded from the sidecar file or a chunked log's
+    /// footer instead of being built by scanning the log
+    bool indexLoaded() const { return _indexLoaded; }
+
+    /// Returns the frame with index @i (0 to size()-1).  Corrupt frames are
+    /// parsed as far as possible.  Returns nullptr if @i is out of range.
+    std::shared_ptr<Packet::LogFrame> frame(int i);
+
+    /// Returns the index of the last frame with command_time at or before
+    /// @time, or 0 if there is no such frame.  Assumes command_time does not
+    /// decrease through the log.
+    int frameAtTime(uint64_t time);
+
+    int cacheSize() const { return _cacheSize; }
+
+    /// Number of frames currently parsed and cached
+    int cachedFrames() const;
+
+    /// Name of the sidecar index file for @filename
+    static std::string indexFilename(const std::string& filename);
+
+private:
+    /// A decompressed chunk
+    struct Chunk {
+        std::string data;
+
+        /// Offset in data of each frame's size field
+        std::vector<uint32_t> offsets;
+    };
+
+    /// Fills _offsets by walking the records in the mapped file
+    void buildIndex();
+
+    bool loadIndex(const std::string& filename);
+    void saveIndex(const std::string& filename) const;
+
+    /// Fills _chunks from a chunked log's footer
+    bool loadChunkIndex();
+
+    /// Fills _chunks by walking the chunk headers
+    void buildChunkIndex();
+
+    /// Size of the uncompressed record with index @i
+    uint32_t recordSize(int i) const;
+
+    /// Index in _chunks of the chunk that holds frame @i
+    int chunkIndex(int i) const;
+
+    /// Returns the chunk that holds frame @i, decompressing it if needed
+    std::shared_ptr<const Chunk> chunkForFrame(int i);
+
+    void parseFrame(int i, Packet::LogFrame& frame);
+
+    const int _cacheSize;
+
+    int _fd;
+    const uint8_t* _data;
+    uint64_t _fileSize;
+    int64_t _mtime;
+
+    int _size;
+    bool _chunked;
+    bool _truncated;
+    bool _indexLoaded;
+
+    /// Offset of each record's size field in an uncompressed log
+    std::vector<uint64_t> _offsets;
+
+    /// Chunks of a chunked log
+    std::vector<ChunkedLog::IndexEntry> _chunks;
+
+    // Protects the frame and chunk caches
+    mutable std::mutex _cacheMutex;
+
+    /// Frame indices, most recently used first
+    std::list<int> _lru;
+
+    struct CacheEntry {
+        std::shared_ptr<Packet::LogFrame> frame;
+        std::list<int>::iterator lruPos;
+    };
+    std::unordered_map<int, CacheEntry> _cache;
+
+    /// Decompressed chunks by index in _chunks, most recently used first
+    std::list<std::pair<int, std::shared_ptr<const Chunk>>> _chunkCache;
+};
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "LogReader.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace std;
+using namespace Packet;
+
+namespace {
+
+/// Writes @count frames with command_time 1000*i in the Logger's format.
+/// Returns the name of the new file.
+string writeLog(int count, bool truncate = false) {
+    char filename[] = "/tmp/LogReaderTest.XXXXXX";
+    int fd = mkstemp(filename);
+    FILE* fp = fdopen(fd, "wb");
+
+    for (int i = 0; i < count; ++i) {
+        LogFrame frame;
+        frame.set_command_time(i * 1000);
+        frame.set_blue_team(i % 2);
+        string data = frame.SerializePartialAsString();
+
+        uint32_t size = data.size();
+        fwrite(&size, sizeof(size), 1, fp);
+        if (truncate && i == count - 1) {
+            data.resize(data.size() / 2);
+        }
+        fwrite(data.data(), data.size(), 1, fp);
+    }
+
+    fclose(fp);
+    return filename;
+}
+
+void removeLog(const string& filename) {
+    unlink(filename.c_str());
+    unlink(LogReader::indexFilename(filename).c_str());
+}
+
+}  // namespace
+
+TEST(LogReader, readsFrames) {
+    string filename = writeLog(100);
+
+    LogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_FALSE(reader.indexLoaded());
+    EXPECT_FALSE(reader.truncated());
+    ASSERT_EQ(100, reader.size());
+
+    // Frames are parsed only when asked for
+    EXPECT_EQ(0, reader.cachedFrames());
+    EXPECT_EQ(57000u, reader.frame(57)->command_time());
+    EXPECT_TRUE(reader.frame(57)->blue_team());
+    EXPECT_EQ(0u, reader.frame(0)->command_time());
+    EXPECT_EQ(99000u, reader.frame(99)->command_time());
+    EXPECT_EQ(3, reader.cachedFrames());
+
+    EXPECT_EQ(nullptr, reader.frame(-1));
+    EXPECT_EQ(nullptr, reader.frame(100));
+
+    removeLog(filename);
+}
+
+TEST(LogReader, sidecarIndex) {
+    string filename = writeLog(50);
+
+    {
+        LogReader reader;
+        ASSERT_TRUE(reader.open(filename));
+        EXPECT_FALSE(reader.indexLoaded());
+    }
+
+    LogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_TRUE(reader.indexLoaded());
+    ASSERT_EQ(50, reader.size());
+    EXPECT_EQ(49000u, reader.frame(49)->command_time());
+
+    // A log that changed since the index was written is scanned again
+    reader.close();
+    removeLog(filename);
+    string other = writeLog(20);
+    rename(other.c_str(), filename.c_str());
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_FALSE(reader.indexLoaded());
+    EXPECT_EQ(20, reader.size());
+
+    removeLog(filename);
+}
+
+TEST(LogReader, corruptSidecarIndex) {
+    string filename = writeLog(50);
+    {
+        LogReader reader;
+        ASSERT_TRUE(reader.open(filename));
+    }
+
+    // The index is a 40 byte header followed by the offset of each frame
+    string indexName = LogReader::indexFilename(filename);
+    const long frame9 = 40 + 9 * sizeof(uint64_t);
+    uint64_t offsets[2];
+    FILE* fp = fopen(indexName.c_str(), "rb");
+    ASSERT_NE(nullptr, fp);
+    fseek(fp, frame9, SEEK_SET);
+    ASSERT_EQ(2u, fread(offsets, sizeof(offsets[0]), 2, fp));
+    fclose(fp);
+
+    // Frame 10 past the end of the log, at the same place as frame 9, and
+    // inside frame 9
+    uint64_t bad[] = {1u << 30, offsets[0], offsets[0] + 1};
+    for (uint64_t offset : bad) {
+        fp = fopen(indexName.c_str(), "r+b");
+        ASSERT_NE(nullptr, fp);
+        fseek(fp, frame9 + sizeof(offset), SEEK_SET);
+        fwrite(&offset, sizeof(offset), 1, fp);
+        fclose(fp);
+
+        // The index is ignored and rewritten
+        LogReader reader;
+        ASSERT_TRUE(reader.open(filename));
+        EXPECT_FALSE(reader.indexLoaded()) << offset;
+        ASSERT_EQ(50, reader.size());
+        EXPECT_EQ(10000u, reader.frame(10)->command_time());
+    }
+
+    removeLog(filename);
+}
+
+TEST(LogReader, truncatedLog) {
+    string filename = writeLog(10, true);
+
+    LogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_TRUE(reader.truncated());
+    EXPECT_EQ(9, reader.size());
+    EXPECT_EQ(8000u, reader.frame(8)->command_time());
+
+    reader.close();
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_TRUE(reader.indexLoaded());
+    EXPECT_TRUE(reader.truncated());
+
+    removeLog(filename);
+}
+
+TEST(LogReader, cacheEviction) {
+    string filename = writeLog(30);
+
+    LogReader reader(10);
+    ASSERT_TRUE(reader.open(filename));
+
+    std::shared_ptr<LogFrame> first = reader.frame(0);
+    for (int i = 1; i < 30; ++i) {
+        reader.frame(i);
+    }
+    EXPECT_EQ(10, reader.cachedFrames());
+
+    // Frame 0 was evicted, but the copy we hold is still valid
+    EXPECT_NE(first, reader.frame(0));
+    EXPECT_EQ(0u, first->command_time());
+
+    // Recently used frames stay in the cache
+    std::shared_ptr<LogFrame> recent = reader.frame(25);
+    EXPECT_EQ(recent, reader.frame(25));
+
+    removeLog(filename);
+}
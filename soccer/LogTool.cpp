@@ -0,0 +1,99 @@
+// Computes statistics over a whole log and prints them as CSV.  The queries
+// are in LogQuery.cpp.
+
+#include <Constants.hpp>
+#include <LogQuery.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace std;
+
+static const int DefaultBlockSize = 1024;
+
+void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [options...] <query> <input.log>\n", prog);
+    fprintf(stderr, "queries:\n");
+    fprintf(stderr, "\trobots: speed and acceleration of each robot\n");
+    fprintf(stderr,
+            "\tradio: commands sent and replies received for each robot\n");
+    fprintf(stderr, "\ttiming: time taken by each stage of the loop\n");
+    fprintf(stderr,
+            "\tvision: distance from raw vision to the filtered positions\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr,
+            "\t-threads <n>: number of scanning threads (default: %u)\n",
+            max(1u, thread::hardware_concurrency()));
+    fprintf(stderr,
+            "\t-block <frames>: frames per unit of work (default: %d)\n",
+            DefaultBlockSize);
+    fprintf(stderr,
+            "\t-single: use single field dimensions for logs that don't "
+            "record the field length\n");
+    exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    int numThreads = max(1u, thread::hardware_concurrency());
+    int blockSize = DefaultBlockSize;
+    const char* queryName = nullptr;
+    const char* inputFile = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* var = argv[i];
+
+        if (strcmp(var, "-threads") == 0) {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+            }
+            numThreads = max(1, atoi(argv[++i]));
+        } else if (strcmp(var, "-single") == 0) {
+            Field_Dimensions::Current_Dimensions =
+                Field_Dimensions::Single_Field_Dimensions;
+        } else if (strcmp(var, "-block") == 0) {
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+            }
+            blockSize = max(1, atoi(argv[++i]));
+        } else if (!queryName) {
+            queryName = var;
+        } else if (!inputFile) {
+            inputFile = var;
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    if (!queryName || !inputFile) {
+        usage(argv[0]);
+    }
+
+    unique_ptr<LogQuery> query = LogQuery::create(queryName);
+    if (!query) {
+        fprintf(stderr, "Unknown query \"%s\"\n", queryName);
+        usage(argv[0]);
+    }
+
+    auto startTime = chrono::steady_clock::now();
+
+    int size = query->run(inputFile, numThreads, blockSize);
+    if (size < 0) {
+        return 1;
+    }
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() -
+                                              startTime)
+                         .count();
+    fprintf(stderr, "%d frames in %.2fs with %d threads\n", size, elapsed,
+            numThreads);
+
+    query->print(stdout);
+
+    return 0;
+}
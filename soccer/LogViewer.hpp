@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ui_LogViewer.h>
+#include <LogReader.hpp>
 #include <protobuf/LogFrame.pb.h>
 
 #include <QTime>
@@ -17,11 +18,9 @@ public:
 
     void frameNumber(int value) { _doubleFrameNumber = value; }
 
-    // This is called when
+    // Opens a log file.  Frames are read from it as they are displayed.
     bool readFrames(const char* filename);
 
-    std::vector<std::shared_ptr<Packet::LogFrame> > frames;
-
 public Q_SLOTS:
     void updateViews();
 
@@ -50,6 +49,11 @@ private:
     QTime _lastUpdateTime;
     double _doubleFrameNumber;
 
+    LogReader _log;
+
+    // command_time of the first frame, for the elapsed time display
+    uint64_t _startTime;
+
     // Recent history.
     // Yeah, it's copied, but if it works in soccer then it works here.
     std::vector<std::shared_ptr<Packet::LogFrame> > _history;
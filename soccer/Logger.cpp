@@ -1,7 +1,6 @@
 #include "Logger.hpp"
 
 #include <QString>
-#include <fcntl.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -9,8 +8,20 @@ using namespace std;
 using namespace Packet;
 using namespace google::protobuf::io;
 
-Logger::Logger() {
-    _fd = -1;
+// How long the writer thread sleeps when it has nothing to do
+static const int WriterIdleSleep_us = 1000;
+
+// How long addFrame() sleeps between attempts with BlockProducer
+static const int ProducerRetrySleep_us = 100;
+
+Logger::Logger()
+    : _writeQueue(WriteQueueSize),
+      _recording(false),
+      _writerRunning(false),
+      _overrunPolicy(DropFrames),
+      _maxQueueDepth(0),
+      _droppedFrames(0),
+      _writtenFrames(0) {
     _history.resize(100000);
     _nextFrameNumber = 0;
     _spaceUsed = sizeof(_history[0]) * _history.size();
@@ -19,52 +30,76 @@ Logger::Logger() {
 Logger::~Logger() { close(); }
 
 bool Logger::open(QString filename) {
-    QMutexLocker locker(&_mutex);
+    // Finish any log that is already open.  This must happen before locking
+    // _mutex because close() locks it too.
+    close();
 
-    if (_fd >= 0) {
-        close();
-    }
+    QMutexLocker locker(&_mutex);
 
-    _fd = creat(filename.toLatin1(), 0666);
-    if (_fd < 0) {
+    if (!_file.open(filename.toStdString())) {
         printf("Can't create %s: %m\n", (const char*)filename.toLatin1());
         return false;
     }
 
     _filename = filename;
 
+    // Discard anything that was queued after the previous log was closed.
+    // The writer thread isn't running, so it's safe to pop from here.
+    shared_ptr<LogFrame> stale;
+    while (_writeQueue.tryPop(stale)) {
+    }
+
+    _maxQueueDepth = 0;
+    _droppedFrames = 0;
+    _writtenFrames = 0;
+
+    _writerRunning = true;
+    _recording = true;
+    _writerThread = std::thread(&Logger::writerLoop, this);
+
     return true;
 }
 
 void Logger::close() {
     QMutexLocker locker(&_mutex);
-    if (_fd >= 0) {
-        ::close(_fd);
-        _fd = -1;
+
+    // Stop queueing frames, then let the writer thread flush what it has
+    _recording = false;
+    if (_writerThread.joinable()) {
+        _writerRunning = false;
+        _writerThread.join();
+    }
+
+    if (_file.isOpen()) {
+        // This writes the last chunk and the index
+        if (!_file.close()) {
+            printf("Logger: Failed to finish %s: %m\n",
+                   (const char*)_filename.toLatin1());
+        }
         _filename = QString();
     }
 }
 
 void Logger::addFrame(shared_ptr<LogFrame> frame) {
-    QMutexLocker locker(&_mutex);
-
-    // Write this from to the file
-    if (_fd >= 0) {
-        if (frame->IsInitialized()) {
-            uint32_t size = frame->ByteSize();
-            if (write(_fd, &size, sizeof(size)) != sizeof(size)) {
-                printf("Logger: Failed to write size, closing log: %m\n");
-                close();
-            } else if (!frame->SerializeToFileDescriptor(_fd)) {
-                printf("Logger: Failed to write frame, closing log: %m\n");
-                close();
+    // Hand the frame to the writer thread.  Serialization and file I/O happen
+    // there so they can't hold up the caller.
+    if (_recording) {
+        while (!_writeQueue.tryPush(frame)) {
+            if (_overrunPolicy == DropFrames || !_recording) {
+                ++_droppedFrames;
+                break;
             }
-        } else {
-            printf("Logger: Not writing frame missing fields: %s\n",
-                   frame->InitializationErrorString().c_str());
+            ::usleep(ProducerRetrySleep_us);
+        }
+
+        int depth = _writeQueue.size();
+        if (depth > _maxQueueDepth) {
+            _maxQueueDepth = depth;
         }
     }
 
+    QMutexLocker locker(&_mutex);
+
     // Get the place in the circular buffer where we will store this frame
     int i = _nextFrameNumber % _history.size();
 
@@ -83,6 +118,52 @@ void Logger::addFrame(shared_ptr<LogFrame> frame) {
     ++_nextFrameNumber;
 }
 
+void Logger::writerLoop() {
+    bool failed = false;
+    shared_ptr<LogFrame> frame;
+    while (true) {
+        if (_writeQueue.tryPop(frame)) {
+            if (failed) {
+                ++_droppedFrames;
+            } else if (writeFrame(*frame)) {
+                ++_writtenFrames;
+            } else {
+                // Stop recording and close the file, but keep draining the
+                // queue so a producer using BlockProducer doesn't wait
+                // forever.
+                failed = true;
+                _recording = false;
+                ++_droppedFrames;
+                if (!_file.close()) {
+                    printf("Logger: Failed to finish %s: %m\n",
+                           (const char*)_filename.toLatin1());
+                }
+            }
+            frame.reset();
+        } else if (!_writerRunning) {
+            // The queue is empty and the log is being closed
+            break;
+        } else {
+            ::usleep(WriterIdleSleep_us);
+        }
+    }
+}
+
+bool Logger::writeFrame(const LogFrame& frame) {
+    if (!frame.IsInitialized()) {
+        printf("Logger: Not writing frame missing fields: %s\n",
+               frame.InitializationErrorString().c_str());
+        return true;
+    }
+
+    if (!_file.addFrame(frame)) {
+        printf("Logger: Failed to write frame, stopping log: %m\n");
+        return false;
+    }
+
+    return true;
+}
+
 shared_ptr<LogFrame> Logger::lastFrame() const {
     QMutexLocker locker(&_mutex);
     return _history[(_nextFrameNumber - 1) % _history.size()];
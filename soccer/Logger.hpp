@@ -8,7 +8,7 @@
  * full list of what is stored in the log.
  *
  * This logger implements a circular buffer for recent history and writes all
- * frames to disk.
+ * frames to disk in the compressed format described in ChunkedLog.hpp.
  *
  * _history is a circular buffer.
  *
@@ -28,21 +28,46 @@
  *
  * Frames are allocated as they are first needed.  The size of the circular
  * buffer limits total memory usage.
+ *
+ * Writing to disk is done on a separate writer thread.  addFrame() only pushes
+ * the frame onto a bounded lock-free queue, so a slow disk never stalls the
+ * processing loop.  If the writer falls behind and the queue fills up, the
+ * OverrunPolicy decides whether the frame is dropped (the default) or whether
+ * addFrame() waits for space.  queueDepth() and droppedFrames() report how
+ * well the writer is keeping up.
+ *
+ * addFrame() must only be called from a single thread (the Processor).
  */
 
 #pragma once
 
+#include "ChunkedLog.hpp"
 #include <protobuf/LogFrame.pb.h>
+#include <SpscQueue.hpp>
 
 #include <QString>
 #include <QMutexLocker>
 #include <QMutex>
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 class Logger {
 public:
+    /// What addFrame() does when the writer thread's queue is full
+    enum OverrunPolicy {
+        /// Discard the frame from the file (it is still kept in the history)
+        DropFrames,
+
+        /// Wait for the writer thread to make room
+        BlockProducer
+    };
+
+    /// Number of frames that can be waiting to be written (~10s at 60Hz)
+    static const size_t WriteQueueSize = 600;
+
     Logger();
     ~Logger();
 
@@ -96,10 +121,23 @@ public:
         return _spaceUsed;
     }
 
-    bool recording() const {
-        QMutexLocker locker(&_mutex);
-        return _fd >= 0;
-    }
+    bool recording() const { return _recording; }
+
+    OverrunPolicy overrunPolicy() const { return _overrunPolicy; }
+    void overrunPolicy(OverrunPolicy policy) { _overrunPolicy = policy; }
+
+    /// Number of frames waiting for the writer thread
+    int queueDepth() const { return _writeQueue.size(); }
+
+    /// Largest queueDepth() seen since the log was opened
+    int maxQueueDepth() const { return _maxQueueDepth; }
+
+    /// Number of frames that were not written to the file since the log was
+    /// opened, either because the queue was full or because a write failed.
+    uint64_t droppedFrames() const { return _droppedFrames; }
+
+    /// Number of frames written to the file since the log was opened
+    uint64_t writtenFrames() const { return _writtenFrames; }
 
     QString filename() const {
         QMutexLocker locker(&_mutex);
@@ -107,6 +145,13 @@ public:
     }
 
 private:
+    /// Body of the writer thread: drains _writeQueue into _fd until the log
+    /// is closed.
+    void writerLoop();
+
+    /// Adds one frame to _file.  Returns false on a write error.
+    bool writeFrame(const Packet::LogFrame& frame);
+
     mutable QMutex _mutex;
 
     QString _filename;
@@ -127,6 +172,24 @@ private:
 
     int _spaceUsed;
 
-    // File descriptor for log file
-    int _fd;
+    // Log file.
+    // This is only used by the writer thread while it is running.
+    ChunkedLogWriter _file;
+
+    // Frames waiting to be written.
+    // The Processor thread pushes and the writer thread pops.
+    SpscQueue<std::shared_ptr<Packet::LogFrame>> _writeQueue;
+    std::thread _writerThread;
+
+    // True while frames should be queued for writing.  This is cleared by the
+    // writer thread if a write fails.
+    std::atomic<bool> _recording;
+
+    // Tells the writer thread to finish the queue and exit
+    std::atomic<bool> _writerRunning;
+
+    std::atomic<OverrunPolicy> _overrunPolicy;
+    std::atomic<int> _maxQueueDepth;
+    std::atomic<uint64_t> _droppedFrames;
+    std::atomic<uint64_t> _writtenFrames;
 };
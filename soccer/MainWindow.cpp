@@ -245,12 +245,56 @@ void MainWindow::updateViews() {
         _procFPS->setText(
             QString("Proc: %1 fps").arg(_processor->framerate(), 0, 'f', 1));
 
+        // Per-stage timing, in milliseconds
+        const FrameProfiler& profiler = _processor->profiler();
+        QString timing =
+            "<table><tr><th align=left>Stage</th><th>Last</th><th>p50</th>"
+            "<th>p99</th><th>Max</th></tr>";
+        for (int i = 0; i < FrameProfiler::NumStages; ++i) {
+            FrameProfiler::Stage stage = (FrameProfiler::Stage)i;
+            FrameProfiler::Stats s = profiler.stats(stage);
+            timing += QString(
+                          "<tr><td>%1</td><td align=right>%2</td>"
+                          "<td align=right>%3</td><td align=right>%4</td>"
+                          "<td align=right>%5</td></tr>")
+                          .arg(FrameProfiler::stageName(stage))
+                          .arg(s.last / 1000.0, 0, 'f', 2)
+                          .arg(s.p50 / 1000.0, 0, 'f', 2)
+                          .arg(s.p99 / 1000.0, 0, 'f', 2)
+                          .arg(s.max / 1000.0, 0, 'f', 2);
+        }
+        timing += "</table>";
+        if (_processor->gameplayModule()->pipelined()) {
+            timing += QString("Pipelined gameplay: %1 frames reused old "
+                              "commands")
+                          .arg(_processor->gameplayModule()->overruns());
+        }
+        _procFPS->setToolTip(
+            QString("Processing Framerate<br>Stage times in ms over the last "
+                    "%1 frames:%2")
+                .arg(FrameProfiler::WindowSize)
+                .arg(timing));
+
         _logMemory->setText(
             QString("Log: %1/%2 %3 kiB")
                 .arg(QString::number(_processor->logger().numFrames()),
                      QString::number(_processor->logger().maxFrames()),
                      QString::number((_processor->logger().spaceUsed() + 512) /
                                      1024)));
+
+        const Logger& logger = _processor->logger();
+        if (logger.recording()) {
+            _logFile->setToolTip(
+                QString("Log File\nWrite queue: %1 (max %2) of %3\n"
+                        "Written: %4, dropped: %5")
+                    .arg(QString::number(logger.queueDepth()),
+                         QString::number(logger.maxQueueDepth()),
+                         QString::number(Logger::WriteQueueSize),
+                         QString::number(logger.writtenFrames()),
+                         QString::number(logger.droppedFrames())));
+        } else {
+            _logFile->setToolTip("Log File");
+        }
     }
 
     // Advance log history
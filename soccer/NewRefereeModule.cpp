@@ -147,8 +147,7 @@ void NewRefereeModule::run() {
         }
 
         NewRefereePacket* packet = new NewRefereePacket;
-        packet->receivedTime = RJ::timestamp();
-        this->received_time = packet->receivedTime;
+        packet->receivedTime = _state.clock->now();
         if (!packet->wrapper.ParseFromArray(buf, size)) {
             fprintf(stderr,
                     "NewRefereeModule: got bad packet of %d bytes from %s:%d\n",
@@ -158,20 +157,31 @@ void NewRefereeModule::run() {
             continue;
         }
 
-        _mutex.lock();
-        _packets.push_back(packet);
+        handlePacket(packet);
+    }
+}
 
-        stage = (Stage)packet->wrapper.stage();
-        command = (Command)packet->wrapper.command();
-        sent_time = packet->wrapper.packet_timestamp();
-        stage_time_left = packet->wrapper.stage_time_left();
-        command_counter = packet->wrapper.command_counter();
-        command_timestamp = packet->wrapper.command_timestamp();
-        yellow_info.ParseRefboxPacket(packet->wrapper.yellow());
-        blue_info.ParseRefboxPacket(packet->wrapper.blue());
+void NewRefereeModule::addPacket(const SSL_Referee& wrapper) {
+    NewRefereePacket* packet = new NewRefereePacket;
+    packet->receivedTime = _state.clock->now();
+    packet->wrapper = wrapper;
+    handlePacket(packet);
+}
 
-        _mutex.unlock();
-    }
+void NewRefereeModule::handlePacket(NewRefereePacket* packet) {
+    _mutex.lock();
+    _packets.push_back(packet);
+
+    received_time = packet->receivedTime;
+    stage = (Stage)packet->wrapper.stage();
+    command = (Command)packet->wrapper.command();
+    sent_time = packet->wrapper.packet_timestamp();
+    stage_time_left = packet->wrapper.stage_time_left();
+    command_counter = packet->wrapper.command_counter();
+    command_timestamp = packet->wrapper.command_timestamp();
+    yellow_info.ParseRefboxPacket(packet->wrapper.yellow());
+    blue_info.ParseRefboxPacket(packet->wrapper.blue());
+    _mutex.unlock();
 }
 
 void NewRefereeModule::spinKickWatcher() {
@@ -136,6 +136,11 @@ public:
 
     void getPackets(std::vector<NewRefereePacket*>& packets);
 
+    /// Handles @wrapper as if it had just been received.  This is how
+    /// referee packets are delivered when the Processor runs headless, in
+    /// which case the thread is never started.
+    void addPacket(const SSL_Referee& wrapper);
+
     bool kicked() { return _kickDetectState == Kicked; }
 
     void useExternalReferee(bool value) { _useExternalRef = value; }
@@ -182,6 +187,9 @@ public:
 protected:
     virtual void run() override;
 
+    /// Queues @packet and takes the referee state from it
+    void handlePacket(NewRefereePacket* packet);
+
     volatile bool _running;
 
     void ready();
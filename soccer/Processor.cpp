@@ -1,6 +1,7 @@
 
 #include <QMutexLocker>
 #include <poll.h>
+#include <algorithm>
 
 #include <gameplay/GameplayModule.hpp>
 #include "Processor.hpp"
@@ -17,7 +18,7 @@
 #include <Robot.hpp>
 #include <motion/MotionControl.hpp>
 #include <RobotConfig.hpp>
-#include <planning/IndependentMultiRobotPathPlanner.hpp>
+#include <planning/ParallelMultiRobotPathPlanner.hpp>
 #include <protobuf/messages_robocup_ssl_detection.pb.h>
 #include <protobuf/messages_robocup_ssl_wrapper.pb.h>
 #include <protobuf/messages_robocup_ssl_geometry.pb.h>
@@ -54,6 +55,7 @@ void Processor::createConfiguration(Configuration* cfg) {
 Processor::Processor(bool sim) : _loopMutex(QMutex::Recursive) {
     _running = true;
     _framePeriod = 1000000 / 60;
+    _firstFrame = true;
     _manualID = -1;
     _defendPlusX = false;
     _externalReferee = true;
@@ -78,10 +80,9 @@ Processor::Processor(bool sim) : _loopMutex(QMutex::Recursive) {
 
     _ballTracker = std::make_shared<BallTracker>();
     _refereeModule = std::make_shared<NewRefereeModule>(_state);
-    _refereeModule->start();
     _gameplayModule = std::make_shared<Gameplay::GameplayModule>(&_state);
     _pathPlanner = std::unique_ptr<Planning::MultiRobotPathPlanner>(
-        new Planning::IndependentMultiRobotPathPlanner());
+        new Planning::ParallelMultiRobotPathPlanner());
     vision.simulation = _simulation;
 }
 
@@ -104,6 +105,11 @@ void Processor::stop() {
     }
 }
 
+void Processor::clock(std::shared_ptr<RJ::Clock> clock) {
+    _state.clock = clock;
+    vision.clock = clock;
+}
+
 void Processor::manualID(int value) {
     QMutexLocker locker(&_loopMutex);
     _manualID = value;
@@ -161,7 +167,15 @@ void Processor::runModels(
     const vector<const SSL_DetectionFrame*>& detectionFrames) {
     vector<BallObservation> ballObservations;
 
-    for (const SSL_DetectionFrame* frame : detectionFrames) {
+    // The filters take observations from every camera in order of capture
+    // time, but frames from different cameras can arrive in any order
+    vector<const SSL_DetectionFrame*> frames = detectionFrames;
+    stable_sort(frames.begin(), frames.end(),
+                [](const SSL_DetectionFrame* a, const SSL_DetectionFrame* b) {
+                    return a->t_capture() < b->t_capture();
+                });
+
+    for (const SSL_DetectionFrame* frame : frames) {
         RJ::Time time = RJ::SecsToTimestamp(frame->t_capture());
 
         // Add ball observations
@@ -218,372 +232,403 @@ void Processor::runModels(
  */
 void Processor::run() {
     vision.start();
+    _refereeModule->start();
 
-    // Create radio socket
-    _radio =
-        _simulation ? (Radio*)new SimRadio(_blueTeam) : (Radio*)new USBRadio();
-
-    Status curStatus;
+    // Create radio socket, unless a radio was provided
+    if (!_radio) {
+        _radio = _simulation ? (Radio*)new SimRadio(_blueTeam)
+                             : (Radio*)new USBRadio();
+    }
 
-    bool first = true;
     // main loop
     while (_running) {
-        RJ::Time startTime = RJ::timestamp();
-        int delta_us = startTime - curStatus.lastLoopTime;
-        _framerate = 1000000.0 / delta_us;
-        curStatus.lastLoopTime = startTime;
-        _state.timestamp = startTime;
-
-        if (!firstLogTime) {
-            firstLogTime = startTime;
-        }
+        runFrame();
 
         ////////////////
-        // Reset
-
-        // Make a new log frame
-        _state.logFrame = std::make_shared<Packet::LogFrame>();
-        _state.logFrame->set_timestamp(RJ::timestamp());
-        _state.logFrame->set_command_time(startTime + Command_Latency);
-        _state.logFrame->set_use_our_half(_useOurHalf);
-        _state.logFrame->set_use_opponent_half(_useOpponentHalf);
-        _state.logFrame->set_manual_id(_manualID);
-        _state.logFrame->set_blue_team(_blueTeam);
-        _state.logFrame->set_defend_plus_x(_defendPlusX);
-
-        if (first) {
-            first = false;
-
-            Packet::LogConfig* logConfig =
-                _state.logFrame->mutable_log_config();
-            logConfig->set_generator("soccer");
-            logConfig->set_git_version_hash(git_version_hash);
-            logConfig->set_git_version_dirty(git_version_dirty);
-            logConfig->set_simulation(_simulation);
+        // Timing
+
+        RJ::Time startTime = _state.timestamp;
+        RJ::Time endTime = _state.clock->now();
+        int lastFrameTime = endTime - startTime;
+        if (lastFrameTime < _framePeriod) {
+            _state.clock->sleepUntil(startTime + _framePeriod);
+        } else {
+            //   printf("Processor took too long: %d us\n", lastFrameTime);
         }
+    }
+    vision.stop();
+    _refereeModule->stop();
+}
 
-        for (OurRobot* robot : _state.self) {
-            // overall robot config
-            switch (robot->hardwareVersion()) {
-                case Packet::RJ2008:
-                    robot->config = robotConfig2008;
-                    break;
-                case Packet::RJ2011:
-                    robot->config = robotConfig2011;
-                    break;
-                case Packet::RJ2015:
-                    robot->config = robotConfig2015;
-                case Packet::Unknown:
-                    robot->config =
-                        robotConfig2011;  // FIXME: defaults to 2011 robots
-                    break;
-            }
+void Processor::runFrame() {
+    _profiler.beginFrame();
+
+    RJ::Time startTime = _state.clock->now();
+    int delta_us = startTime - _frameStatus.lastLoopTime;
+    _framerate = 1000000.0 / delta_us;
+    _frameStatus.lastLoopTime = startTime;
+    _state.timestamp = startTime;
 
-            // per-robot configs
-            robot->status = robotStatuses.at(robot->shell());
+    if (!firstLogTime) {
+        firstLogTime = startTime;
+    }
+
+    ////////////////
+    // Reset
+
+    // Make a new log frame
+    _state.logFrame = std::make_shared<Packet::LogFrame>();
+    _state.logFrame->set_timestamp(_state.clock->now());
+    _state.logFrame->set_command_time(startTime + Command_Latency);
+    _state.logFrame->set_use_our_half(_useOurHalf);
+    _state.logFrame->set_use_opponent_half(_useOpponentHalf);
+    _state.logFrame->set_manual_id(_manualID);
+    _state.logFrame->set_blue_team(_blueTeam);
+    _state.logFrame->set_defend_plus_x(_defendPlusX);
+    _state.logFrame->set_field_length(
+        Field_Dimensions::Current_Dimensions.Length());
+    _profiler.log(_state.logFrame.get());
+
+    if (_firstFrame) {
+        _firstFrame = false;
+
+        Packet::LogConfig* logConfig = _state.logFrame->mutable_log_config();
+        logConfig->set_generator("soccer");
+        logConfig->set_git_version_hash(git_version_hash);
+        logConfig->set_git_version_dirty(git_version_dirty);
+        logConfig->set_simulation(_simulation);
+    }
+
+    for (OurRobot* robot : _state.self) {
+        // overall robot config
+        switch (robot->hardwareVersion()) {
+            case Packet::RJ2008:
+                robot->config = robotConfig2008;
+                break;
+            case Packet::RJ2011:
+                robot->config = robotConfig2011;
+                break;
+            case Packet::RJ2015:
+                robot->config = robotConfig2015;
+            case Packet::Unknown:
+                robot->config =
+                    robotConfig2011;  // FIXME: defaults to 2011 robots
+                break;
         }
 
-        ////////////////
-        // Inputs
-
-        // Read vision packets
-        vector<const SSL_DetectionFrame*> detectionFrames;
-        vector<VisionPacket*> visionPackets;
-        vision.getPackets(visionPackets);
-        for (VisionPacket* packet : visionPackets) {
-            SSL_WrapperPacket* log = _state.logFrame->add_raw_vision();
-            log->CopyFrom(packet->wrapper);
-
-            curStatus.lastVisionTime = packet->receivedTime;
-            if (packet->wrapper.has_detection()) {
-                SSL_DetectionFrame* det = packet->wrapper.mutable_detection();
-
-                // FIXME - Account for network latency
-                double rt = packet->receivedTime / 1000000.0;
-                det->set_t_capture(rt - det->t_sent() + det->t_capture());
-                det->set_t_sent(rt);
-
-                // Remove balls on the excluded half of the field
-                google::protobuf::RepeatedPtrField<SSL_DetectionBall>* balls =
-                    det->mutable_balls();
-                for (int i = 0; i < balls->size(); ++i) {
-                    float x = balls->Get(i).x();
-                    // FIXME - OMG too many terms
+        // per-robot configs
+        robot->status = robotStatuses.at(robot->shell());
+    }
+
+    _profiler.mark(FrameProfiler::Setup);
+
+    ////////////////
+    // Inputs
+
+    // Read vision packets
+    vector<const SSL_DetectionFrame*> detectionFrames;
+    vision.getPackets(_visionPackets);
+    for (VisionPacket* packet : _visionPackets) {
+        // Log the packet as it was received, before any changes below
+        _state.logFrame->add_raw_vision(packet->data.data(), packet->size);
+
+        _frameStatus.lastVisionTime = packet->receivedTime;
+        if (packet->wrapper.has_detection()) {
+            SSL_DetectionFrame* det = packet->wrapper.mutable_detection();
+
+            // FIXME - Account for network latency
+            double rt = packet->receivedTime / 1000000.0;
+            det->set_t_capture(rt - det->t_sent() + det->t_capture());
+            det->set_t_sent(rt);
+
+            // Remove balls on the excluded half of the field
+            google::protobuf::RepeatedPtrField<SSL_DetectionBall>* balls =
+                det->mutable_balls();
+            for (int i = 0; i < balls->size(); ++i) {
+                float x = balls->Get(i).x();
+                // FIXME - OMG too many terms
+                if ((!_state.logFrame->use_opponent_half() &&
+                     ((_defendPlusX && x < 0) || (!_defendPlusX && x > 0))) ||
+                    (!_state.logFrame->use_our_half() &&
+                     ((_defendPlusX && x > 0) || (!_defendPlusX && x < 0)))) {
+                    balls->SwapElements(i, balls->size() - 1);
+                    balls->RemoveLast();
+                    --i;
+                }
+            }
+
+            // Remove robots on the excluded half of the field
+            google::protobuf::RepeatedPtrField<SSL_DetectionRobot>*
+                robots[2] = {det->mutable_robots_yellow(),
+                             det->mutable_robots_blue()};
+
+            for (int team = 0; team < 2; ++team) {
+                for (int i = 0; i < robots[team]->size(); ++i) {
+                    float x = robots[team]->Get(i).x();
                     if ((!_state.logFrame->use_opponent_half() &&
                          ((_defendPlusX && x < 0) ||
                           (!_defendPlusX && x > 0))) ||
                         (!_state.logFrame->use_our_half() &&
                          ((_defendPlusX && x > 0) ||
                           (!_defendPlusX && x < 0)))) {
-                        balls->SwapElements(i, balls->size() - 1);
-                        balls->RemoveLast();
+                        robots[team]->SwapElements(i,
+                                                   robots[team]->size() - 1);
+                        robots[team]->RemoveLast();
                         --i;
                     }
                 }
-
-                // Remove robots on the excluded half of the field
-                google::protobuf::RepeatedPtrField<SSL_DetectionRobot>*
-                    robots[2] = {det->mutable_robots_yellow(),
-                                 det->mutable_robots_blue()};
-
-                for (int team = 0; team < 2; ++team) {
-                    for (int i = 0; i < robots[team]->size(); ++i) {
-                        float x = robots[team]->Get(i).x();
-                        if ((!_state.logFrame->use_opponent_half() &&
-                             ((_defendPlusX && x < 0) ||
-                              (!_defendPlusX && x > 0))) ||
-                            (!_state.logFrame->use_our_half() &&
-                             ((_defendPlusX && x > 0) ||
-                              (!_defendPlusX && x < 0)))) {
-                            robots[team]->SwapElements(
-                                i, robots[team]->size() - 1);
-                            robots[team]->RemoveLast();
-                            --i;
-                        }
-                    }
-                }
-
-                detectionFrames.push_back(det);
             }
-        }
 
-        // Read radio reverse packets
-        _radio->receive();
-        for (const Packet::RadioRx& rx : _radio->reversePackets()) {
-            _state.logFrame->add_radio_rx()->CopyFrom(rx);
-
-            curStatus.lastRadioRxTime = rx.timestamp();
-
-            // Store this packet in the appropriate robot
-            unsigned int board = rx.robot_id();
-            if (board < Num_Shells) {
-                // We have to copy because the RX packet will survive past this
-                // frame but LogFrame will not (the RadioRx in LogFrame will be
-                // reused).
-                _state.self[board]->radioRx().CopyFrom(rx);
-                _state.self[board]->radioRxUpdated();
-            }
+            detectionFrames.push_back(det);
         }
-        _radio->clear();
+    }
 
-        _loopMutex.lock();
+    _profiler.mark(FrameProfiler::Vision);
 
-        for (Joystick* joystick : _joysticks) {
-            joystick->update();
-        }
+    // Read radio reverse packets
+    _radio->receive();
+    for (const Packet::RadioRx& rx : _radio->reversePackets()) {
+        _state.logFrame->add_radio_rx()->CopyFrom(rx);
 
-        runModels(detectionFrames);
-        for (VisionPacket* packet : visionPackets) {
-            delete packet;
+        _frameStatus.lastRadioRxTime = rx.timestamp();
+
+        // Store this packet in the appropriate robot
+        unsigned int board = rx.robot_id();
+        if (board < Num_Shells) {
+            // We have to copy because the RX packet will survive past this
+            // frame but LogFrame will not (the RadioRx in LogFrame will be
+            // reused).
+            _state.self[board]->radioRx().CopyFrom(rx);
+            _state.self[board]->radioRxUpdated();
         }
+    }
+    _radio->clear();
+    _profiler.mark(FrameProfiler::RadioReceive);
 
-        // Update gamestate w/ referee data
-        _refereeModule->updateGameState(blueTeam());
-        _refereeModule->spinKickWatcher();
+    _loopMutex.lock();
+    _profiler.mark(FrameProfiler::LoopLock);
 
-        string yellowname, bluename;
+    for (Joystick* joystick : _joysticks) {
+        joystick->update();
+    }
+    _profiler.mark(FrameProfiler::Joysticks);
 
-        if (blueTeam()) {
-            bluename = _state.gameState.OurInfo.name;
-            yellowname = _state.gameState.TheirInfo.name;
-        } else {
-            yellowname = _state.gameState.OurInfo.name;
-            bluename = _state.gameState.TheirInfo.name;
-        }
+    runModels(detectionFrames);
+    vision.releasePackets();
+    _profiler.mark(FrameProfiler::Models);
 
-        _state.logFrame->set_team_name_blue(bluename);
-        _state.logFrame->set_team_name_yellow(yellowname);
+    // Update gamestate w/ referee data
+    _refereeModule->updateGameState(blueTeam());
+    _refereeModule->spinKickWatcher();
 
-        // Run high-level soccer logic
-        _gameplayModule->run();
+    string yellowname, bluename;
 
-        // recalculates Field obstacles on every run through to account for
-        // changing inset
-        if (_gameplayModule->hasFieldEdgeInsetChanged()) {
-            _gameplayModule->calculateFieldObstacles();
+    if (blueTeam()) {
+        bluename = _state.gameState.OurInfo.name;
+        yellowname = _state.gameState.TheirInfo.name;
+    } else {
+        yellowname = _state.gameState.OurInfo.name;
+        bluename = _state.gameState.TheirInfo.name;
+    }
+
+    _state.logFrame->set_team_name_blue(bluename);
+    _state.logFrame->set_team_name_yellow(yellowname);
+    _profiler.mark(FrameProfiler::Referee);
+
+    // Run high-level soccer logic
+    _gameplayModule->run();
+    _profiler.mark(FrameProfiler::Gameplay);
+
+    // recalculates Field obstacles on every run through to account for
+    // changing inset
+    if (_gameplayModule->hasFieldEdgeInsetChanged()) {
+        _gameplayModule->calculateFieldObstacles();
+    }
+    /// Collect global obstacles
+    Geometry2d::ShapeSet globalObstacles = _gameplayModule->globalObstacles();
+    Geometry2d::ShapeSet goalZoneObstacles =
+        _gameplayModule->goalZoneObstacles();
+
+    // Empty last frame's obstacle sets before taking anything from the pool,
+    // since they point to the circles it is about to reuse
+    for (auto& obstacles : _robotObstacles) {
+        if (obstacles && obstacles.use_count() == 1) {
+            obstacles->clear();
+        } else {
+            obstacles = std::make_shared<ShapeSet>();
         }
-        /// Collect global obstacles
-        Geometry2d::ShapeSet globalObstacles =
-            _gameplayModule->globalObstacles();
-        Geometry2d::ShapeSet globalObstaclesWithGoalZones = globalObstacles;
-        Geometry2d::ShapeSet goalZoneObstacles =
-            _gameplayModule->goalZoneObstacles();
-        globalObstaclesWithGoalZones.add(goalZoneObstacles);
-
-        // Build a plan request for each robot.
-        std::map<int, Planning::PlanRequest> requests;
-        for (OurRobot* r : _state.self) {
-            if (r && r->visible) {
-                if (_state.gameState.state == GameState::Halt) {
-                    r->setPath(nullptr);
-                    continue;
-                }
+    }
+    _obstaclePool.clear();
 
-                // Visualize local obstacles
-                for (auto& shape : r->localObstacles().shapes()) {
-                    _state.drawShape(shape, Qt::black, "LocalObstacles");
-                }
+    // Build a plan request for each robot.
+    const RJ::Time planTime = _state.clock->now();
+    std::map<int, Planning::PlanRequest> requests;
+    for (OurRobot* r : _state.self) {
+        if (r && r->visible) {
+            if (_state.gameState.state == GameState::Halt) {
+                r->setPath(nullptr);
+                continue;
+            }
 
-                auto& globalObstaclesForBot =
-                    (r->shell() == _gameplayModule->goalieID() ||
-                     r->isPenaltyKicker)
-                        ? globalObstacles
-                        : globalObstaclesWithGoalZones;
-
-                // create and visualize obstacles
-                Geometry2d::ShapeSet fullObstacles =
-                    r->collectAllObstacles(globalObstaclesForBot);
-
-                requests[r->shell()] = Planning::PlanRequest(
-                    Planning::MotionInstant(r->pos, r->vel),
-                    r->motionCommand()->clone(), r->motionConstraints(),
-                    std::move(r->angleFunctionPath.path),
-                    std::make_shared<ShapeSet>(std::move(fullObstacles)));
+            // Visualize local obstacles
+            for (auto& shape : r->localObstacles().shapes()) {
+                _state.drawShape(shape, Qt::black, "LocalObstacles");
             }
-        }
 
-        // Run path planner and set the path for each robot that was planned for
-        auto pathsById = _pathPlanner->run(std::move(requests));
-        for (auto& entry : pathsById) {
-            OurRobot* r = _state.self[entry.first];
-            auto& path = entry.second;
-            path->draw(&_state, Qt::magenta, "Planning");
-            r->setPath(std::move(path));
+            // create and visualize obstacles
+            std::shared_ptr<ShapeSet>& fullObstacles =
+                _robotObstacles[r->shell()];
+            r->collectAllObstacles(globalObstacles, _obstaclePool,
+                                   *fullObstacles);
+            if (r->shell() != _gameplayModule->goalieID() &&
+                !r->isPenaltyKicker) {
+                fullObstacles->addView(goalZoneObstacles);
+            }
 
-            r->angleFunctionPath.angleFunction =
-                angleFunctionForCommandType(r->rotationCommand());
-        }
+            // The planner makes many hit queries against these obstacles,
+            // so index them once up front.
+            fullObstacles->buildIndex();
 
-        // Visualize obstacles
-        for (auto& shape : globalObstacles.shapes()) {
-            _state.drawShape(shape, Qt::black, "Global Obstacles");
+            requests[r->shell()] = Planning::PlanRequest(
+                Planning::MotionInstant(r->pos, r->vel), planTime,
+                r->motionCommand()->clone(), r->motionConstraints(),
+                std::move(r->angleFunctionPath.path), fullObstacles);
         }
+    }
 
-        // Run velocity controllers
-        for (OurRobot* robot : _state.self) {
-            if (robot->visible) {
-                if ((_manualID >= 0 && (int)robot->shell() == _manualID) ||
-                    _state.gameState.halt()) {
-                    robot->motionControl()->stopped();
-                } else {
-                    robot->motionControl()->run();
-                }
-            }
-        }
+    _profiler.mark(FrameProfiler::Obstacles);
 
-        ////////////////
-        // Store logging information
+    // Run path planner and set the path for each robot that was planned for
+    auto pathsById = _pathPlanner->run(std::move(requests));
+    for (auto& entry : pathsById) {
+        OurRobot* r = _state.self[entry.first];
+        auto& path = entry.second;
+        path->draw(&_state, Qt::magenta, "Planning");
+        r->setPath(std::move(path));
+
+        r->angleFunctionPath.angleFunction =
+            angleFunctionForCommandType(r->rotationCommand());
+    }
+    _profiler.mark(FrameProfiler::Planning);
 
-        // Debug layers
-        const QStringList& layers = _state.debugLayers();
-        for (const QString& str : layers) {
-            _state.logFrame->add_debug_layers(str.toStdString());
+    // Visualize obstacles
+    for (auto& shape : globalObstacles.shapes()) {
+        _state.drawShape(shape, Qt::black, "Global Obstacles");
+    }
+    _profiler.mark(FrameProfiler::Visualization);
+
+    // Run velocity controllers
+    for (OurRobot* robot : _state.self) {
+        if (robot->visible) {
+            if ((_manualID >= 0 && (int)robot->shell() == _manualID) ||
+                _state.gameState.halt()) {
+                robot->motionControl()->stopped();
+            } else {
+                robot->motionControl()->run();
+            }
         }
+    }
+    _profiler.mark(FrameProfiler::MotionControl);
 
-        // Add our robots data to the LogFram
-        for (OurRobot* r : _state.self) {
-            if (r->visible) {
-                r->addStatusText();
-
-                Packet::LogFrame::Robot* log = _state.logFrame->add_self();
-                *log->mutable_pos() = r->pos;
-                *log->mutable_world_vel() = r->vel;
-                *log->mutable_body_vel() = r->vel.rotated(2 * M_PI - r->angle);
-                //*log->mutable_cmd_body_vel() = r->
-                // *log->mutable_cmd_vel() = r->cmd_vel;
-                // log->set_cmd_w(r->cmd_w);
-                log->set_shell(r->shell());
-                log->set_angle(r->angle);
-
-                if (r->radioRx().has_kicker_voltage()) {
-                    log->set_kicker_voltage(r->radioRx().kicker_voltage());
-                }
+    ////////////////
+    // Store logging information
 
-                if (r->radioRx().has_kicker_status()) {
-                    log->set_charged(r->radioRx().kicker_status() & 0x01);
-                    log->set_kicker_works(
-                        !(r->radioRx().kicker_status() & 0x90));
-                }
+    // Debug layers
+    const QStringList& layers = _state.debugLayers();
+    for (const QString& str : layers) {
+        _state.logFrame->add_debug_layers(str.toStdString());
+    }
 
-                if (r->radioRx().has_ball_sense_status()) {
-                    log->set_ball_sense_status(
-                        r->radioRx().ball_sense_status());
-                }
+    // Add our robots data to the LogFram
+    for (OurRobot* r : _state.self) {
+        if (r->visible) {
+            r->addStatusText();
+
+            Packet::LogFrame::Robot* log = _state.logFrame->add_self();
+            *log->mutable_pos() = r->pos;
+            *log->mutable_world_vel() = r->vel;
+            *log->mutable_body_vel() = r->vel.rotated(2 * M_PI - r->angle);
+            //*log->mutable_cmd_body_vel() = r->
+            // *log->mutable_cmd_vel() = r->cmd_vel;
+            // log->set_cmd_w(r->cmd_w);
+            log->set_shell(r->shell());
+            log->set_angle(r->angle);
+
+            if (r->radioRx().has_kicker_voltage()) {
+                log->set_kicker_voltage(r->radioRx().kicker_voltage());
+            }
 
-                if (r->radioRx().has_battery()) {
-                    log->set_battery_voltage(r->radioRx().battery());
-                }
+            if (r->radioRx().has_kicker_status()) {
+                log->set_charged(r->radioRx().kicker_status() & 0x01);
+                log->set_kicker_works(!(r->radioRx().kicker_status() & 0x90));
+            }
 
-                log->mutable_motor_status()->Clear();
-                log->mutable_motor_status()->MergeFrom(
-                    r->radioRx().motor_status());
+            if (r->radioRx().has_ball_sense_status()) {
+                log->set_ball_sense_status(r->radioRx().ball_sense_status());
+            }
 
-                if (r->radioRx().has_quaternion()) {
-                    log->mutable_quaternion()->Clear();
-                    log->mutable_quaternion()->MergeFrom(
-                        r->radioRx().quaternion());
-                } else {
-                    log->clear_quaternion();
-                }
+            if (r->radioRx().has_battery()) {
+                log->set_battery_voltage(r->radioRx().battery());
+            }
 
-                for (const Packet::DebugText& t : r->robotText) {
-                    log->add_text()->CopyFrom(t);
-                }
+            log->mutable_motor_status()->Clear();
+            log->mutable_motor_status()->MergeFrom(
+                r->radioRx().motor_status());
+
+            if (r->radioRx().has_quaternion()) {
+                log->mutable_quaternion()->Clear();
+                log->mutable_quaternion()->MergeFrom(
+                    r->radioRx().quaternion());
+            } else {
+                log->clear_quaternion();
             }
-        }
 
-        // Opponent robots
-        for (OpponentRobot* r : _state.opp) {
-            if (r->visible) {
-                Packet::LogFrame::Robot* log = _state.logFrame->add_opp();
-                *log->mutable_pos() = r->pos;
-                log->set_shell(r->shell());
-                log->set_angle(r->angle);
-                *log->mutable_world_vel() = r->vel;
-                *log->mutable_body_vel() = r->vel.rotated(2 * M_PI - r->angle);
+            for (const Packet::DebugText& t : r->robotText) {
+                log->add_text()->CopyFrom(t);
             }
         }
+    }
 
-        // Ball
-        if (_state.ball.valid) {
-            Packet::LogFrame::Ball* log = _state.logFrame->mutable_ball();
-            *log->mutable_pos() = _state.ball.pos;
-            *log->mutable_vel() = _state.ball.vel;
+    // Opponent robots
+    for (OpponentRobot* r : _state.opp) {
+        if (r->visible) {
+            Packet::LogFrame::Robot* log = _state.logFrame->add_opp();
+            *log->mutable_pos() = r->pos;
+            log->set_shell(r->shell());
+            log->set_angle(r->angle);
+            *log->mutable_world_vel() = r->vel;
+            *log->mutable_body_vel() = r->vel.rotated(2 * M_PI - r->angle);
         }
+    }
 
-        ////////////////
-        // Outputs
+    // Ball
+    if (_state.ball.valid) {
+        Packet::LogFrame::Ball* log = _state.logFrame->mutable_ball();
+        *log->mutable_pos() = _state.ball.pos;
+        *log->mutable_vel() = _state.ball.vel;
+    }
 
-        // Send motion commands to the robots
-        sendRadioData();
+    _profiler.mark(FrameProfiler::LogFrame);
 
-        // Write to the log
-        _logger.addFrame(_state.logFrame);
+    ////////////////
+    // Outputs
 
-        _loopMutex.unlock();
+    // Send motion commands to the robots
+    sendRadioData();
+    _profiler.mark(FrameProfiler::RadioSend);
 
-        // Store processing loop status
-        _statusMutex.lock();
-        _status = curStatus;
-        _statusMutex.unlock();
+    // Write to the log
+    _logger.addFrame(_state.logFrame);
+    _profiler.mark(FrameProfiler::Logging);
 
-        ////////////////
-        // Timing
+    _loopMutex.unlock();
 
-        RJ::Time endTime = RJ::timestamp();
-        int lastFrameTime = endTime - startTime;
-        if (lastFrameTime < _framePeriod) {
-            // Use system usleep, not QThread::usleep.
-            //
-            // QThread::usleep uses pthread_cond_wait which sometimes fails to
-            // unblock.
-            // This seems to depend on how many threads are blocked.
-            ::usleep(_framePeriod - lastFrameTime);
-        } else {
-            //   printf("Processor took too long: %d us\n", lastFrameTime);
-        }
-    }
-    vision.stop();
+    // Store processing loop status
+    _statusMutex.lock();
+    _status = _frameStatus;
+    _statusMutex.unlock();
+
+    _profiler.endFrame();
 }
 
 void Processor::sendRadioData() {
@@ -8,11 +8,15 @@
 #include <QMutex>
 #include <QMutexLocker>
 
+#include <array>
+
 #include <protobuf/LogFrame.pb.h>
 #include <Logger.hpp>
+#include <FrameProfiler.hpp>
 #include <Geometry2d/TransformMatrix.hpp>
 #include <SystemState.hpp>
 #include <modeling/RobotFilter.hpp>
+#include <planning/ObstaclePool.hpp>
 #include <NewRefereeModule.hpp>
 #include "VisionReceiver.hpp"
 
@@ -145,6 +149,10 @@ public:
 
     SystemState* state() { return &_state; }
 
+    /// Replaces the clock that drives the processing loop.  This must be
+    /// called before the thread is started.
+    void clock(std::shared_ptr<RJ::Clock> clock);
+
     bool simulation() const { return _simulation; }
 
     void defendPlusX(bool value);
@@ -158,10 +166,18 @@ public:
 
     const Logger& logger() const { return _logger; }
 
+    /// Timing of each stage of the processing loop
+    const FrameProfiler& profiler() const { return _profiler; }
+
     bool openLog(const QString& filename) { return _logger.open(filename); }
 
     void closeLog() { _logger.close(); }
 
+    /// Selects what happens when the log writer thread can't keep up
+    void logOverrunPolicy(Logger::OverrunPolicy policy) {
+        _logger.overrunPolicy(policy);
+    }
+
     // Use all/part of the field
     void useOurHalf(bool value) { _useOurHalf = value; }
 
@@ -171,6 +187,23 @@ public:
 
     Radio* radio() { return _radio; }
 
+    /// Uses @radio instead of opening one when the thread starts.  This must
+    /// be called before the thread is started.  The Processor does not take
+    /// ownership.
+    void radio(Radio* radio) { _radio = radio; }
+
+    VisionReceiver* visionReceiver() { return &vision; }
+
+    /**
+     * Runs one iteration of the processing loop and returns without waiting
+     * for the next frame.
+     *
+     * run() calls this once per frame period.  Code that steps the Processor
+     * itself, such as a lock-step simulation, calls it instead of starting the
+     * thread and must provide a radio first.
+     */
+    void runFrame();
+
     void changeVisionChannel(int port);
 
     void recalculateWorldToTeamTransform();
@@ -209,6 +242,8 @@ private:
 
     Logger _logger;
 
+    FrameProfiler _profiler;
+
     Radio* _radio;
 
     bool _useOurHalf, _useOpponentHalf;
@@ -245,6 +280,12 @@ private:
     // Processing period in microseconds
     int _framePeriod;
 
+    // Status of the processing loop, copied to _status after each frame
+    Status _frameStatus;
+
+    // True until the first frame has been run
+    bool _firstFrame;
+
     // True if we are using external referee packets
     bool _externalReferee;
 
@@ -262,6 +303,13 @@ private:
     std::unique_ptr<Planning::MultiRobotPathPlanner> _pathPlanner;
     std::shared_ptr<BallTracker> _ballTracker;
 
+    // Obstacles for each robot's plan request.  These are refilled every
+    // frame with views of the pool's robot and ball circles and of that
+    // frame's global obstacles, so they are only valid during the frame.
+    Planning::ObstaclePool _obstaclePool;
+    std::array<std::shared_ptr<Geometry2d::ShapeSet>, Num_Shells>
+        _robotObstacles;
+
     // mixes values from all joysticks to control the single manual robot
     std::vector<Joystick*> _joysticks;
 
@@ -274,4 +322,8 @@ private:
     bool _useFieldOrientedManualDrive = false;
 
     VisionReceiver vision;
+
+    /// Packets from vision for the current frame.  These belong to vision
+    /// and are only valid until they are released.
+    std::vector<VisionPacket*> _visionPackets;
 };
@@ -134,7 +134,7 @@ void OurRobot::resetForNextIteration() {
     radioTx.set_decel(10);
 
     if (charged()) {
-        _lastChargedTime = RJ::timestamp();
+        _lastChargedTime = _state->clock->now();
     }
 
     _local_obstacles.clear();
@@ -226,9 +226,8 @@ bool OurRobot::behindBall(Geometry2d::Point ballPos) const {
 }
 
 float OurRobot::kickTimer() const {
-    return (charged())
-               ? 0.0
-               : RJ::TimestampToSecs((RJ::timestamp() - _lastChargedTime));
+    return (charged()) ? 0.0 : RJ::TimestampToSecs(
+                                   (_state->clock->now() - _lastChargedTime));
 }
 
 void OurRobot::dribble(uint8_t speed) {
@@ -398,21 +397,20 @@ float OurRobot::avoidBallRadius() const { return _avoidBallRadius; }
 
 void OurRobot::resetAvoidBall() { avoidBallRadius(Ball_Avoid_Small); }
 
-std::shared_ptr<Geometry2d::Shape> OurRobot::createBallObstacle() const {
+void OurRobot::addBallObstacle(Planning::ObstaclePool& pool,
+                               Geometry2d::ShapeSet& obstacles) const {
     // if game is stopped, large obstacle regardless of flags
     if (_state->gameState.state != GameState::Playing &&
         !(_state->gameState.ourRestart || _state->gameState.theirPenalty())) {
-        return std::shared_ptr<Geometry2d::Shape>(
-            new Circle(_state->ball.pos,
-                       Field_Dimensions::Current_Dimensions.CenterRadius()));
+        obstacles.add(pool.circle(
+            _state->ball.pos,
+            Field_Dimensions::Current_Dimensions.CenterRadius()));
+        return;
     }
 
     // create an obstacle if necessary
     if (_avoidBallRadius > 0.0) {
-        return std::shared_ptr<Geometry2d::Shape>(
-            new Circle(_state->ball.pos, _avoidBallRadius));
-    } else {
-        return std::shared_ptr<Geometry2d::Shape>();
+        obstacles.add(pool.circle(_state->ball.pos, _avoidBallRadius));
     }
 }
 
@@ -422,27 +420,24 @@ void OurRobot::setPath(unique_ptr<Planning::Path> path) {
     angleFunctionPath.path = std::move(path);
 }
 
-Geometry2d::ShapeSet OurRobot::collectAllObstacles(
-    const Geometry2d::ShapeSet& globalObstacles) {
-    Geometry2d::ShapeSet fullObstacles(_local_obstacles);
-    // Adds our robots as obstacles only if they're within a certain distance
-    // from this robot. This distance increases with velocity.
-    const Geometry2d::ShapeSet selfObs = createRobotObstacles(
-        _state->self, _self_avoid_mask, this->pos, 0.6 + this->vel.mag());
-    const Geometry2d::ShapeSet oppObs =
-        createRobotObstacles(_state->opp, _opp_avoid_mask);
+void OurRobot::collectAllObstacles(const Geometry2d::ShapeSet& globalObstacles,
+                                   Planning::ObstaclePool& pool,
+                                   Geometry2d::ShapeSet& obstacles) const {
+    obstacles.clear();
+    obstacles.addView(_local_obstacles);
 
     if (_state->ball.valid) {
         // _state->drawShape(ball_obs, Qt::gray,
         //                   QString("ball_obstacles_%1").arg(shell()));
-        auto ballObs = createBallObstacle();
-        if (ballObs) fullObstacles.add(ballObs);
+        addBallObstacle(pool, obstacles);
     }
-    fullObstacles.add(selfObs);
-    fullObstacles.add(oppObs);
-    fullObstacles.add(globalObstacles);
 
-    return fullObstacles;
+    // Adds our robots as obstacles only if they're within a certain distance
+    // from this robot. This distance increases with velocity.
+    addRobotObstacles(_state->self, _self_avoid_mask, pool, obstacles,
+                      this->pos, 0.6 + this->vel.mag());
+    addRobotObstacles(_state->opp, _opp_avoid_mask, pool, obstacles);
+    obstacles.addView(globalObstacles);
 }
 
 bool OurRobot::charged() const {
@@ -519,18 +514,62 @@ boost::optional<Eigen::Quaternionf> OurRobot::quaternion() const {
 }
 
 bool OurRobot::rxIsFresh(RJ::Time age) const {
-    return (RJ::timestamp() - _radioRx.timestamp()) < age;
+    return (_state->clock->now() - _radioRx.timestamp()) < age;
 }
 
 RJ::Time OurRobot::lastKickTime() const { return _lastKickTime; }
 
+bool OurRobot::justKicked() {
+    return _state->clock->now() - lastKickTime() < RJ::SecsToTimestamp(0.25);
+}
+
 void OurRobot::radioRxUpdated() {
     if (_radioRx.kicker_status() < _lastKickerStatus) {
-        _lastKickTime = RJ::timestamp();
+        _lastKickTime = _state->clock->now();
     }
     _lastKickerStatus = _radioRx.kicker_status();
 }
 
+void OurRobot::copyWorldState(const OurRobot& other) {
+    RobotPose::operator=(other);
+    config = other.config;
+    status = other.status;
+
+    _radioRx.CopyFrom(other._radioRx);
+    _lastKickerStatus = other._lastKickerStatus;
+    _lastKickTime = other._lastKickTime;
+    _lastChargedTime = other._lastChargedTime;
+}
+
+void OurRobot::copyCommands(const OurRobot& other) {
+    _motionCommand = other._motionCommand->clone();
+    _rotationCommand = other._rotationCommand->clone();
+    _motionConstraints = other._motionConstraints;
+    _rotationConstraints = other._rotationConstraints;
+
+    _local_obstacles = other._local_obstacles;
+    _self_avoid_mask = other._self_avoid_mask;
+    _opp_avoid_mask = other._opp_avoid_mask;
+    _avoidBallRadius = other._avoidBallRadius;
+    isPenaltyKicker = other.isPenaltyKicker;
+
+    radioTx.CopyFrom(other.radioTx);
+
+    // Debug layer numbers are specific to each SystemState
+    const QStringList& layers = other._state->debugLayers();
+    robotText.clear();
+    for (const Packet::DebugText& text : other.robotText) {
+        Packet::DebugText* copy = new Packet::DebugText(text);
+        if (text.layer() >= 0 && text.layer() < layers.size()) {
+            copy->set_layer(_state->findDebugLayer(layers[text.layer()]));
+        }
+        robotText.push_back(copy);
+    }
+
+    _cmdText->str(other._cmdText->str());
+    _cmdText->clear();
+}
+
 double OurRobot::distanceToChipLanding(int chipPower) {
     return max(0., min(190., *(config->chipper.calibrationSlope) * chipPower +
                                  *(config->chipper.calibrationOffset)));
@@ -5,6 +5,7 @@
 #include <planning/InterpolatedPath.hpp>
 #include <planning/MotionCommand.hpp>
 #include <planning/MotionConstraints.hpp>
+#include <planning/ObstaclePool.hpp>
 #include <planning/RotationConstraints.hpp>
 #include <planning/RRTPlanner.hpp>
 #include "planning/RotationCommand.hpp"
@@ -273,9 +274,7 @@ public:
     RJ::Time lastKickTime() const;
 
     /// checks if the bot has kicked/chipped very recently.
-    bool justKicked() {
-        return RJ::timestamp() - lastKickTime() < RJ::SecsToTimestamp(0.25);
-    }
+    bool justKicked();
 
     /**
      * Gets a string representing the series of commands called on the robot
@@ -315,8 +314,19 @@ public:
     }
     void clearLocalObstacles() { _local_obstacles.clear(); }
 
-    Geometry2d::ShapeSet collectAllObstacles(
-        const Geometry2d::ShapeSet& globalObstacles);
+    /**
+     * Fills @obstacles with everything this robot has to avoid: its local
+     * obstacles, the ball, other robots and @globalObstacles.  Anything
+     * already in @obstacles is removed.  The robot and ball obstacles come
+     * from @pool.
+     *
+     * @obstacles only views the other shapes (see ShapeSet::addView()), so it
+     * must not be used after @globalObstacles, this robot's local obstacles,
+     * or the pool's circles change.
+     */
+    void collectAllObstacles(const Geometry2d::ShapeSet& globalObstacles,
+                             Planning::ObstaclePool& pool,
+                             Geometry2d::ShapeSet& obstacles) const;
 
     void approachAllOpponents(bool enable = true);
     void avoidAllOpponents(bool enable = true);
@@ -422,6 +432,21 @@ public:
 
     void setPath(std::unique_ptr<Planning::Path> path);
 
+    /**
+     * Copies what @other knows about the world: its pose, its last RadioRx
+     * and when it last kicked and was charged.  Used to give gameplay a snapshot of the
+     * robots that the Processor can keep updating.
+     */
+    void copyWorldState(const OurRobot& other);
+
+    /**
+     * Copies the commands that plays gave @other: motion and rotation
+     * commands and constraints, kicking and dribbling, obstacles and
+     * avoidance, and debug text.  @other may belong to a different
+     * SystemState.
+     */
+    void copyCommands(const OurRobot& other);
+
 protected:
     MotionControl* _motionControl;
 
@@ -442,7 +467,7 @@ protected:
     Planning::AngleFunctionPath angleFunctionPath;  /// latest path
 
     /**
-     * Creates a set of obstacles from a given robot team mask,
+     * Adds obstacles to @obstacles from a given robot team mask,
      * where mask values < 0 create no obstacle, and larger values
      * create an obstacle of a given radius
      *
@@ -452,19 +477,17 @@ protected:
      * or opp from _state
      */
     template <class ROBOT>
-    Geometry2d::ShapeSet createRobotObstacles(const std::vector<ROBOT*>& robots,
-                                              const RobotMask& mask) const {
-        Geometry2d::ShapeSet result;
+    void addRobotObstacles(const std::vector<ROBOT*>& robots,
+                           const RobotMask& mask, Planning::ObstaclePool& pool,
+                           Geometry2d::ShapeSet& obstacles) const {
         for (size_t i = 0; i < mask.size(); ++i)
             if (mask[i] > 0 && robots[i] && robots[i]->visible)
-                result.add(std::shared_ptr<Geometry2d::Shape>(
-                    new Geometry2d::Circle(robots[i]->pos, mask[i])));
-        return result;
+                obstacles.add(pool.circle(robots[i]->pos, mask[i]));
     }
 
     /**
      * Only adds obstacles within the checkRadius of the passed in position
-     * Creates a set of obstacles from a given robot team mask, where mask
+     * Adds obstacles to @obstacles from a given robot team mask, where mask
      * values < 0 create no obstacle, and larger values create an obstacle of a
      * given radius
      *
@@ -474,25 +497,24 @@ protected:
      * or opp from _state
      */
     template <class ROBOT>
-    Geometry2d::ShapeSet createRobotObstacles(const std::vector<ROBOT*>& robots,
-                                              const RobotMask& mask,
-                                              Geometry2d::Point currentPosition,
-                                              float checkRadius) const {
-        Geometry2d::ShapeSet result;
+    void addRobotObstacles(const std::vector<ROBOT*>& robots,
+                           const RobotMask& mask, Planning::ObstaclePool& pool,
+                           Geometry2d::ShapeSet& obstacles,
+                           Geometry2d::Point currentPosition,
+                           float checkRadius) const {
         for (size_t i = 0; i < mask.size(); ++i)
             if (mask[i] > 0 && robots[i] && robots[i]->visible) {
                 if (currentPosition.distTo(robots[i]->pos) <= checkRadius) {
-                    result.add(std::shared_ptr<Geometry2d::Shape>(
-                        new Geometry2d::Circle(robots[i]->pos, mask[i])));
+                    obstacles.add(pool.circle(robots[i]->pos, mask[i]));
                 }
             }
-        return result;
     }
 
     /**
-     * Creates an obstacle for the ball if necessary
+     * Adds an obstacle for the ball to @obstacles if necessary
      */
-    std::shared_ptr<Geometry2d::Shape> createBallObstacle() const;
+    void addBallObstacle(Planning::ObstaclePool& pool,
+                         Geometry2d::ShapeSet& obstacles) const;
 
 protected:
     friend class Processor;
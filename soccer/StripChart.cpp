@@ -17,6 +17,9 @@ using namespace Packet;
 using namespace boost;
 using namespace google::protobuf;
 
+// Frames shown by a new chart: a minute at 60 frames per second
+static const int DefaultLength = 60 * 60;
+
 StripChart::StripChart(QWidget* parent) {
     _history = nullptr;
     _minValue = 0;
@@ -24,6 +27,7 @@ StripChart::StripChart(QWidget* parent) {
     //_function = 0;
     autoRange = true;
     _color = Qt::yellow;
+    length(DefaultLength);
 
     QPalette p = palette();
     p.setColor(QPalette::Window, Qt::black);
@@ -44,18 +48,72 @@ StripChart::~StripChart() {
 void StripChart::function(Chart::Function* function) {
     if (function) {
         _functions.append(function);
+
+        // Read every function's values again from the history
+        _values.emplace_back();
+        length(_length);
+    }
+}
+
+void StripChart::length(int frames) {
+    _length = max(frames, 2);
+    _times.reset(_length);
+    for (Chart::Column<float>& column : _values) {
+        column.reset(_length);
+    }
+}
+
+void StripChart::updateSamples() {
+    // Count the history frames newer than the newest one read.  Frame 0 is
+    // the most recent.
+    int newFrames = 0;
+    bool continues = false;
+    for (const auto& frame : *_history) {
+        if (!frame) {
+            break;
+        }
+        if (!_times.empty() && frame->timestamp() <= _times.fromNewest(0)) {
+            continues = frame->timestamp() == _times.fromNewest(0);
+            break;
+        }
+        ++newFrames;
+    }
+
+    if (!continues && !_times.empty()) {
+        _times.clear();
+        for (Chart::Column<float>& column : _values) {
+            column.clear();
+        }
+
+        newFrames = 0;
+        while (newFrames < (int)_history->size() && _history->at(newFrames)) {
+            ++newFrames;
+        }
+    }
+
+    // Read the new frames, oldest first
+    for (int i = newFrames - 1; i >= 0; --i) {
+        const LogFrame& frame = *_history->at(i);
+        _times.push_back(frame.timestamp());
+        for (int f = 0; f < _functions.size(); ++f) {
+            float v;
+            if (!_functions[f]->value(frame, v)) {
+                v = NAN;
+            }
+            _values[f].push_back(v);
+        }
     }
 }
 
 QPointF StripChart::dataPoint(int i, float value) {
-    float x = width() - (i * width() / _history->size());
+    float x = width() - (i * width() / _length);
     int h = height();
     float y = h - (value - _minValue) * h / (_maxValue - _minValue);
     return QPointF(x, y);
 }
 
 int StripChart::indexAtPoint(const QPoint& point) {
-    return (width() - point.x()) * _history->size() / width();
+    return (width() - point.x()) * _length / width();
 }
 
 void StripChart::paintEvent(QPaintEvent* e) {
@@ -63,6 +121,8 @@ void StripChart::paintEvent(QPaintEvent* e) {
         return;
     }
 
+    updateSamples();
+
     QPainter p(this);
 
     float newMin = _minValue;
@@ -79,19 +139,23 @@ void StripChart::paintEvent(QPaintEvent* e) {
     QPointF x = dataPoint(0, 0);
     p.drawLine(x, QPointF(0, x.y()));
 
+    const int count = _times.size();
+    QPolygonF line;
+    line.reserve(count);
     for (unsigned int x = 0; x < _functions.size(); x++) {
-        auto function = _functions[x];
+        const Chart::Column<float>& values = _values[x];
 
-        bool haveLast = false;
-        QPointF last;
         if (x == 0) {
             p.setPen(_color);
         } else {
             p.setPen(Qt::red);
         }
-        for (unsigned int i = 0; i < _history->size(); ++i) {
-            float v = 0;
-            if (_history->at(i) && function->value(*_history->at(i).get(), v)) {
+
+        // Runs of available values are drawn as polylines
+        line.clear();
+        for (int i = 0; i < count; ++i) {
+            float v = values.fromNewest(i);
+            if (!std::isnan(v)) {
                 if (autoRange) {
                     newMin = min(newMin, v);
                     newMax = max(newMax, v);
@@ -106,20 +170,17 @@ void StripChart::paintEvent(QPaintEvent* e) {
                         mappedCursorPos + QPointF(15, 0 + fontHeight * 2 * x),
                         ("V: " + std::to_string(v)).c_str());
 
-                    if (i > 0 && i < _history->size() - 1) {
-                        float v1, v2;
-
-                        function->value(*_history->at(i - 1).get(), v1);
-                        function->value(*_history->at(i + 1).get(), v2);
+                    if (i > 0 && i < count - 1) {
+                        float v1 = values.fromNewest(i - 1);
+                        float v2 = values.fromNewest(i + 1);
 
-                        double t1 = 0.0;
-                        t1 += _history->at(i - 1)->timestamp();
-                        t1 = RJ::TimestampToSecs(t1);
-                        double t2 = 0.0;
-                        t2 += _history->at(i + 1)->timestamp();
-                        t2 = RJ::TimestampToSecs(t2);
+                        // Subtract the timestamps before converting them, so
+                        // the difference keeps its precision
+                        float dt = RJ::TimestampToSecs(
+                            _times.fromNewest(i - 1) -
+                            _times.fromNewest(i + 1));
 
-                        auto derivative = (v2 - v1) / (t2 - t1);
+                        auto derivative = (v1 - v2) / dt;
 
                         p.drawText(
                             mappedCursorPos +
@@ -128,15 +189,13 @@ void StripChart::paintEvent(QPaintEvent* e) {
                     }
                 }
 
-                if (haveLast) {
-                    p.drawLine(last, pt);
-                }
-                last = pt;
-                haveLast = true;
+                line.append(pt);
             } else {
-                haveLast = false;
+                p.drawPolyline(line);
+                line.clear();
             }
         }
+        p.drawPolyline(line);
     }
 
     p.drawText(0, height() - 5, std::to_string(newMin).c_str());
@@ -148,46 +207,92 @@ void StripChart::paintEvent(QPaintEvent* e) {
 
 ////////
 
-bool Chart::PointMagnitude::value(const Packet::LogFrame& frame,
-                                  float& v) const {
-    const Message* msg = &frame;
-    for (int i = 0; i < path.size(); ++i) {
-        const Reflection* ref = msg->GetReflection();
-        const Descriptor* desc = msg->GetDescriptor();
+void Chart::FieldPath::compile(const QVector<int>& path,
+                               const char* endMessage, const char* name) {
+    _compiled = true;
+    _valid = false;
+    _steps.clear();
 
-        int tag = path[i];
-        const FieldDescriptor* fd = desc->FindFieldByNumber(tag);
-        if (fd->type() != FieldDescriptor::TYPE_MESSAGE) {
-            fprintf(stderr, "PointMagnitude: expected a message field\n");
-            return false;
+    const Descriptor* desc = LogFrame::descriptor();
+    for (int i = 0; i < path.size(); ++i) {
+        const FieldDescriptor* fd = desc->FindFieldByNumber(path[i]);
+        if (!fd) {
+            fprintf(stderr, "%s: no field with tag %d\n", name, path[i]);
+            return;
         }
 
+        int index = -1;
         if (fd->is_repeated()) {
             ++i;
             if (i >= path.size()) {
                 fprintf(stderr,
-                        "PointMagnitude: ends after tag for repeated field "
-                        "without giving index\n");
-                return false;
+                        "%s: ends after tag for repeated field without "
+                        "giving index\n",
+                        name);
+                return;
             }
-            int j = path[i];
-            if (ref->FieldSize(*msg, fd) <= j) {
+            index = path[i];
+        }
+        _steps.push_back(PathStep{fd, index});
+
+        if (fd->type() == FieldDescriptor::TYPE_MESSAGE) {
+            desc = fd->message_type();
+        } else if (i < path.size() - 1 || endMessage) {
+            fprintf(stderr, "%s: expected a message field\n", name);
+            return;
+        } else if (fd->type() != FieldDescriptor::TYPE_FLOAT &&
+                   fd->type() != FieldDescriptor::TYPE_DOUBLE) {
+            fprintf(stderr, "%s: unsupported field type %d\n", name,
+                    fd->type());
+            return;
+        } else {
+            desc = nullptr;
+        }
+    }
+
+    if (endMessage ? desc->name() != endMessage : desc != nullptr) {
+        fprintf(stderr, "%s: path ended in a message other than %s\n", name,
+                endMessage ? endMessage : "a number");
+        return;
+    }
+
+    _valid = true;
+}
+
+const Message* Chart::FieldPath::follow(const Packet::LogFrame& frame,
+                                        int n) const {
+    const Message* msg = &frame;
+    for (int i = 0; i < n; ++i) {
+        const Reflection* ref = msg->GetReflection();
+        const PathStep& step = _steps[i];
+        if (step.index >= 0) {
+            if (ref->FieldSize(*msg, step.field) <= step.index) {
                 // Not enough items
-                return false;
+                return nullptr;
             }
-            msg = &ref->GetRepeatedMessage(*msg, fd, j);
+            msg = &ref->GetRepeatedMessage(*msg, step.field, step.index);
         } else {
-            if (!ref->HasField(*msg, fd)) {
+            if (!ref->HasField(*msg, step.field)) {
                 // Missing field
-                return false;
+                return nullptr;
             }
-            msg = &ref->GetMessage(*msg, fd);
+            msg = &ref->GetMessage(*msg, step.field);
         }
     }
+    return msg;
+}
+
+bool Chart::PointMagnitude::value(const Packet::LogFrame& frame,
+                                  float& v) const {
+    if (!_fields.compiled()) {
+        _fields.compile(path, "Point", "PointMagnitude");
+    }
+    if (!_fields.valid()) {
+        return false;
+    }
 
-    if (msg->GetDescriptor()->name() != "Point") {
-        fprintf(stderr,
-                "PointMagnitude: path ended in a message other than Point\n");
+    const Message* msg = _fields.follow(frame, _fields.steps().size());
+    if (!msg) {
         return false;
     }
 
@@ -196,95 +301,38 @@ bool Chart::PointMagnitude::value(const Packet::LogFrame& frame,
 }
 
 bool Chart::NumericField::value(const Packet::LogFrame& frame, float& v) const {
-    const Message* msg = &frame;
-    for (int i = 0; i < path.size(); ++i) {
-        const Reflection* ref = msg->GetReflection();
-        const Descriptor* desc = msg->GetDescriptor();
-
-        int tag = path[i];
-        const FieldDescriptor* fd = desc->FindFieldByNumber(tag);
-        if (fd->type() != FieldDescriptor::TYPE_MESSAGE) {
-            if ((i == path.size() - 1 && !fd->is_repeated()) ||
-                (i == path.size() - 2 && fd->is_repeated())) {
-                // End of the path
-                if (fd->is_repeated()) {
-                    ++i;
-                    if (i >= path.size()) {
-                        fprintf(stderr,
-                                "NumericField: ends after tag for repeated "
-                                "field without giving index\n");
-                        return false;
-                    }
-                    int j = path[i];
-                    if (ref->FieldSize(*msg, fd) <= j) {
-                        // Not enough items
-                        return false;
-                    }
+    if (!_fields.compiled()) {
+        _fields.compile(path, nullptr, "NumericField");
+    }
+    if (!_fields.valid()) {
+        return false;
+    }
 
-                    switch (fd->type()) {
-                        case FieldDescriptor::TYPE_FLOAT:
-                            v = ref->GetRepeatedFloat(*msg, fd, j);
-                            break;
-
-                        case FieldDescriptor::TYPE_DOUBLE:
-                            v = ref->GetRepeatedDouble(*msg, fd, j);
-                            break;
-
-                        default:
-                            fprintf(stderr,
-                                    "NumericField: unsupported repeated field "
-                                    "type %d\n",
-                                    fd->type());
-                            return false;
-                    }
-                } else {
-                    switch (fd->type()) {
-                        case FieldDescriptor::TYPE_FLOAT:
-                            v = ref->GetFloat(*msg, fd);
-                            break;
-
-                        case FieldDescriptor::TYPE_DOUBLE:
-                            v = ref->GetDouble(*msg, fd);
-                            break;
-
-                        default:
-                            fprintf(stderr,
-                                    "NumericField: unsupported field type %d\n",
-                                    fd->type());
-                            return false;
-                    }
-                }
-                return true;
-            } else {
-                // Non-message field in the middle of a path
-                fprintf(stderr, "NumericField: expected a message field\n");
-                return false;
-            }
+    // The last step is the number and the rest lead to its message
+    const PathStep& step = _fields.steps().back();
+    const Message* msg = _fields.follow(frame, _fields.steps().size() - 1);
+    if (!msg) {
+        return false;
+    }
+
+    const Reflection* ref = msg->GetReflection();
+    if (step.index >= 0) {
+        if (ref->FieldSize(*msg, step.field) <= step.index) {
+            // Not enough items
+            return false;
         }
 
-        if (fd->is_repeated()) {
-            ++i;
-            if (i >= path.size()) {
-                fprintf(stderr,
-                        "NumericField: ends after tag for repeated field "
-                        "without giving index\n");
-                return false;
-            }
-            int j = path[i];
-            if (ref->FieldSize(*msg, fd) <= j) {
-                // Not enough items
-                return false;
-            }
-            msg = &ref->GetRepeatedMessage(*msg, fd, j);
+        if (step.field->type() == FieldDescriptor::TYPE_FLOAT) {
+            v = ref->GetRepeatedFloat(*msg, step.field, step.index);
         } else {
-            if (!ref->HasField(*msg, fd)) {
-                // Missing field
-                return false;
-            }
-            msg = &ref->GetMessage(*msg, fd);
+            v = ref->GetRepeatedDouble(*msg, step.field, step.index);
+        }
+    } else {
+        if (step.field->type() == FieldDescriptor::TYPE_FLOAT) {
+            v = ref->GetFloat(*msg, step.field);
+        } else {
+            v = ref->GetDouble(*msg, step.field);
         }
     }
-
-    // Not reached
-    return false;
+    return true;
 }
@@ -2,6 +2,8 @@
 
 #include <QWidget>
 
+#include <time.hpp>
+
 #include <vector>
 #include <memory>
 
@@ -9,6 +11,13 @@ namespace Packet {
 class LogFrame;
 }
 
+namespace google {
+namespace protobuf {
+class FieldDescriptor;
+class Message;
+}
+}
+
 // Chart functions:
 //
 // Gets the value for a given frame.
@@ -21,6 +30,40 @@ struct Function {
     virtual bool value(const Packet::LogFrame& frame, float& v) const = 0;
 };
 
+// One step along a path of tags: the field the tag names and, if the field is
+// repeated, the index of the item.  Otherwise index is -1.
+struct PathStep {
+    const google::protobuf::FieldDescriptor* field;
+    int index;
+};
+
+// A path of tags resolved to field descriptors.  Looking the tags up is the
+// slow part of reading a field through reflection, so it is done once, the
+// first time the path is followed.
+class FieldPath {
+public:
+    // Resolves @path.  Every step must be a message field, and the last one
+    // must be the message type named @endMessage, or a float or double field
+    // if @endMessage is null.  Problems are reported once on stderr with
+    // @name, and leave the path invalid.
+    void compile(const QVector<int>& path, const char* endMessage,
+                 const char* name);
+
+    bool compiled() const { return _compiled; }
+    bool valid() const { return _valid; }
+    const std::vector<PathStep>& steps() const { return _steps; }
+
+    // Follows the first @n steps as message fields from @frame.  Returns the
+    // message reached, or nullptr if a field along the way is missing.
+    const google::protobuf::Message* follow(const Packet::LogFrame& frame,
+                                            int n) const;
+
+private:
+    bool _compiled = false;
+    bool _valid = false;
+    std::vector<PathStep> _steps;
+};
+
 struct PointMagnitude : public Function {
     virtual bool value(const Packet::LogFrame& frame, float& v) const override;
 
@@ -28,6 +71,9 @@ struct PointMagnitude : public Function {
     // Each tag except must identify a Message.
     // A repeated field's tag is followed by the index of the item.
     QVector<int> path;
+
+private:
+    mutable FieldPath _fields;
 };
 
 struct NumericField : public Function {
@@ -37,6 +83,49 @@ struct NumericField : public Function {
     // Each tag except the last one must identify a Message.
     // A repeated field's tag is followed by the index of the item.
     QVector<int> path;
+
+private:
+    mutable FieldPath _fields;
+};
+
+// Fixed-capacity ring of values, one per frame.  Once it is full, each new
+// value replaces the oldest one.
+template <typename T>
+class Column {
+public:
+    void reset(int capacity) {
+        _data.assign(capacity, T());
+        clear();
+    }
+
+    void clear() {
+        _start = 0;
+        _size = 0;
+    }
+
+    void push_back(T v) {
+        const int capacity = _data.size();
+        if (_size < capacity) {
+            _data[(_start + _size) % capacity] = v;
+            ++_size;
+        } else {
+            _data[_start] = v;
+            _start = (_start + 1) % capacity;
+        }
+    }
+
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // Value @i frames before the newest one
+    const T& fromNewest(int i) const {
+        return _data[(_start + _size - 1 - i) % _data.size()];
+    }
+
+private:
+    std::vector<T> _data;
+    int _start = 0;
+    int _size = 0;
 };
 }
 
@@ -66,11 +155,20 @@ public:
     // out-of-range values are found
     bool autoRange;
 
+    // Sets how many frames the chart shows.  This can be much longer than
+    // the history, since each frame's values are kept once they're read.
+    void length(int frames);
+
 protected:
     void paintEvent(QPaintEvent* e) override;
 
+    // Reads the values of the history frames that are newer than the ones
+    // already in the chart.  If the history doesn't continue from them, as
+    // after seeking in a log, the chart starts over from the history.
+    void updateSamples();
+
     // Returns the position for the data at a given frame.
-    // i is an index in _history, so 0 is the most recent frame
+    // i is an index in the samples, so 0 is the most recent frame
     // and increasing indices are older frames.
     QPointF dataPoint(int i, float value);
 
@@ -79,6 +177,14 @@ protected:
     // Chart function (see above)
     QList<Chart::Function*> _functions;
 
+    // Number of frames shown
+    int _length;
+
+    // Timestamp of each frame read so far, and each function's value for it.
+    // Values that weren't available are NaN.
+    Chart::Column<RJ::Time> _times;
+    std::vector<Chart::Column<float>> _values;
+
     float _minValue;
     float _maxValue;
     QColor _color;
@@ -7,7 +7,7 @@
 
 using namespace Packet;
 
-SystemState::SystemState() {
+SystemState::SystemState() : clock(std::make_shared<RJ::RealTimeClock>()) {
     timestamp = 0;
     _numDebugLayers = 0;
 
@@ -142,3 +142,37 @@ void SystemState::drawSegment(const Geometry2d::Segment& line, const QColor& qc,
     *dbg->add_points() = line.pt[1];
     dbg->set_color(color(qc));
 }
+
+/// Appends the debug items in @from to @to, renumbering their layers from
+/// @fromLayers to the layers of @state
+template <class T>
+static void copyDebugItems(const google::protobuf::RepeatedPtrField<T>& from,
+                           google::protobuf::RepeatedPtrField<T>* to,
+                           const QStringList& fromLayers,
+                           SystemState* state) {
+    for (const T& item : from) {
+        T* copy = to->Add();
+        copy->CopyFrom(item);
+        if (item.layer() >= 0 && item.layer() < fromLayers.size()) {
+            copy->set_layer(state->findDebugLayer(fromLayers[item.layer()]));
+        }
+    }
+}
+
+void SystemState::copyDrawings(const SystemState& other) {
+    const LogFrame& from = *other.logFrame;
+    const QStringList& layers = other.debugLayers();
+
+    copyDebugItems(from.debug_robot_paths(),
+                   logFrame->mutable_debug_robot_paths(), layers, this);
+    copyDebugItems(from.debug_paths(), logFrame->mutable_debug_paths(),
+                   layers, this);
+    copyDebugItems(from.debug_polygons(), logFrame->mutable_debug_polygons(),
+                   layers, this);
+    copyDebugItems(from.debug_circles(), logFrame->mutable_debug_circles(),
+                   layers, this);
+    copyDebugItems(from.debug_arcs(), logFrame->mutable_debug_arcs(), layers,
+                   this);
+    copyDebugItems(from.debug_texts(), logFrame->mutable_debug_texts(),
+                   layers, this);
+}
@@ -17,6 +17,7 @@
 #include <GameState.hpp>
 #include <Constants.hpp>
 #include <Utils.hpp>
+#include <Clock.hpp>
 #include <Geometry2d/Arc.hpp>
 
 class RobotConfig;
@@ -112,7 +113,21 @@ public:
     void drawShapeSet(const Geometry2d::ShapeSet& shapes,
                       const QColor& color = Qt::black,
                       const QString& layer = QString());
+
+    /**
+     * Adds the debug drawings from @other's LogFrame to this one.  The layers
+     * are matched by name, since each SystemState numbers them separately.
+     */
+    void copyDrawings(const SystemState& other);
+
+    /// Time at which the current processing loop iteration started
     RJ::Time timestamp;
+
+    /// Source of the current time for everything driven by the processing
+    /// loop.  This is a RealTimeClock unless a simulated one is injected (see
+    /// Processor::clock()).
+    std::shared_ptr<RJ::Clock> clock;
+
     GameState gameState;
 
     /// All possible robots.
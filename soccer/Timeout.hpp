@@ -1,22 +1,25 @@
 
 #pragma once
 
-#include <Utils.hpp>
+#include <Clock.hpp>
+
+#include <memory>
 
 /**
  * This is a simple timeout timer.
  *
- * Initialize it with a given duration,
+ * Initialize it with a clock (normally SystemState::clock) and a duration,
  * then query it repeatedly to see if the duration is over.
  */
 class Timeout {
 public:
-    Timeout(float seconds = 0) {
+    Timeout(std::shared_ptr<RJ::Clock> clock, float seconds = 0)
+        : _clock(std::move(clock)) {
         setIntervalInSeconds(seconds);
         reset();
     }
 
-    void reset() { _startTime = RJ::timestamp(); }
+    void reset() { _startTime = _clock->now(); }
 
     void setIntervalInSeconds(float seconds) {
         _interval = (RJ::Time)(seconds * 1000.0f);
@@ -24,9 +27,10 @@ public:
 
     void setIntervalInMilliseconds(RJ::Time ms) { _interval = ms; }
 
-    bool isTimedOut() { return RJ::timestamp() - _startTime > _interval; }
+    bool isTimedOut() { return _clock->now() - _startTime > _interval; }
 
 private:
+    std::shared_ptr<RJ::Clock> _clock;
     RJ::Time _interval;
     RJ::Time _startTime;
 };
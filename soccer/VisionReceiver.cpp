@@ -2,17 +2,59 @@
 
 #include <multicast.hpp>
 #include <Utils.hpp>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
 #include <unistd.h>
-#include <QMutexLocker>
 #include <QUdpSocket>
 #include <stdexcept>
 
 using namespace std;
 
-VisionReceiver::VisionReceiver(bool sim, int port) {
+#ifndef __linux__
+// recvmmsg() is Linux-only.  Elsewhere, packets are received one recvmsg()
+// call at a time into the same structures.
+struct mmsghdr {
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+};
+
+static int recvmmsg(int fd, struct mmsghdr* msgs, unsigned int count,
+                    int flags, struct timespec*) {
+    unsigned int n = 0;
+    while (n < count) {
+        ssize_t size = recvmsg(fd, &msgs[n].msg_hdr, flags);
+        if (size < 0) {
+            return n > 0 ? n : -1;
+        }
+        msgs[n].msg_len = size;
+        ++n;
+    }
+    return n;
+}
+#endif
+
+// Room for one timestamp control message per packet
+static const int ControlSize = 64;
+
+const int VisionReceiver::NumSlots;
+const int VisionReceiver::MaxPacketSize;
+
+VisionReceiver::VisionReceiver(bool sim, int port)
+    : clock(std::make_shared<RJ::RealTimeClock>()),
+      _slots(NumSlots),
+      _head(0),
+      _tail(0),
+      _read(0) {
     simulation = sim;
     _running = false;
     this->port = port;
+
+    for (VisionPacket& packet : _slots) {
+        packet.data.resize(MaxPacketSize);
+    }
 }
 
 void VisionReceiver::stop() {
@@ -20,11 +62,40 @@ void VisionReceiver::stop() {
     wait();
 }
 
+int VisionReceiver::freeSlots() const {
+    return NumSlots - (int)(_head.load(memory_order_relaxed) -
+                            _tail.load(memory_order_acquire));
+}
+
 void VisionReceiver::getPackets(std::vector<VisionPacket*>& packets) {
-    _mutex.lock();
-    packets = _packets;
-    _packets.clear();
-    _mutex.unlock();
+    packets.clear();
+
+    uint32_t head = _head.load(memory_order_acquire);
+    for (; _read != head; ++_read) {
+        packets.push_back(&slot(_read));
+    }
+}
+
+void VisionReceiver::releasePackets() {
+    _tail.store(_read, memory_order_release);
+}
+
+void VisionReceiver::addPacket(const SSL_WrapperPacket& wrapper) {
+    int size = wrapper.ByteSize();
+    if (freeSlots() == 0 || size > MaxPacketSize) {
+        fprintf(stderr, "VisionReceiver: dropped a packet of %d bytes\n",
+                size);
+        return;
+    }
+
+    uint32_t head = _head.load(memory_order_relaxed);
+    VisionPacket& packet = slot(head);
+    packet.receivedTime = clock->now();
+    packet.size = size;
+    wrapper.SerializeWithCachedSizesToArray((uint8_t*)packet.data.data());
+    packet.wrapper.CopyFrom(wrapper);
+
+    _head.store(head + 1, memory_order_release);
 }
 
 void VisionReceiver::run() {
@@ -50,49 +121,108 @@ void VisionReceiver::run() {
         multicast_add(&socket, SharedVisionAddress);
     }
 
-    // There should be at most four packets: one for each camera on each of two
-    // frames, assuming some clock skew between this
-    // computer and the vision computer.
-    _packets.reserve(4);
+    // Packets are read from the socket directly, bypassing QUdpSocket, so
+    // that several can be read per call with the kernel's receive timestamps.
+    int fd = socket.socketDescriptor();
+#ifdef SO_TIMESTAMPNS
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) != 0) {
+        fprintf(stderr, "VisionReceiver: no receive timestamps: %m\n");
+    }
+#endif
+
+    mmsghdr msgs[NumSlots];
+    iovec iovs[NumSlots];
+    char control[NumSlots][ControlSize];
+    sockaddr_storage addrs[NumSlots];
 
     _running = true;
     while (_running) {
-        char buf[65536];
+        int free = freeSlots();
+        if (free == 0) {
+            // The Processor hasn't caught up.  Leave packets in the socket's
+            // buffer until it does.
+            ::usleep(1000);
+            continue;
+        }
 
         // Wait for a UDP packet
-        if (!socket.waitForReadyRead(500)) {
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 500) <= 0) {
             // Time out once in a while so the thread has a chance to exit
             continue;
         }
 
-        QHostAddress host;
-        quint16 portNumber = 0;
-        qint64 size = socket.readDatagram(buf, sizeof(buf), &host, &portNumber);
-        if (size < 1) {
-            fprintf(stderr, "VisionReceiver: %s\n",
-                    (const char*)socket.errorString().toLatin1());
-            // See Processor for why we can't use QThread::msleep()
-            ::usleep(100 * 1000);
+        // Receive straight into the free slots
+        uint32_t head = _head.load(memory_order_relaxed);
+        for (int i = 0; i < free; ++i) {
+            VisionPacket& packet = slot(head + i);
+            iovs[i].iov_base = packet.data.data();
+            iovs[i].iov_len = packet.data.size();
+
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = control[i];
+            msgs[i].msg_hdr.msg_controllen = ControlSize;
+        }
+
+        int count = recvmmsg(fd, msgs, free, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "VisionReceiver: %m\n");
+                // See Processor for why we can't use QThread::msleep()
+                ::usleep(100 * 1000);
+            }
             continue;
         }
 
+        RJ::Time now = clock->now();
+
         // FIXME - Verify that it is from the right host, in case there are
         // multiple visions on the network
 
-        // Parse the protobuf message
-        VisionPacket* packet = new VisionPacket;
-        packet->receivedTime = RJ::timestamp();
-        if (!packet->wrapper.ParseFromArray(buf, size)) {
-            fprintf(stderr,
-                    "VisionReceiver: got bad packet of %d bytes from %s:%d\n",
-                    (int)size, (const char*)host.toString().toLatin1(),
-                    portNumber);
-            continue;
+        int added = 0;
+        for (int i = 0; i < count; ++i) {
+            // Keep the good packets contiguous by moving this one into the
+            // slot of any bad packet before it
+            VisionPacket& packet = slot(head + added);
+            if (added != i) {
+                swap(packet.data, slot(head + i).data);
+            }
+            packet.size = msgs[i].msg_len;
+
+            // Correct for the time the packet waited in the socket
+            packet.receivedTime = now;
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg;
+                 cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+#ifdef SO_TIMESTAMPNS
+                if (cmsg->cmsg_level == SOL_SOCKET &&
+                    cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec ts;
+                    memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                    RJ::Time arrival =
+                        (RJ::Time)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+                    packet.receivedTime = clock->fromWallTime(arrival);
+                }
+#endif
+            }
+
+            // Parse the protobuf message
+            if ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ||
+                !packet.wrapper.ParseFromArray(packet.data.data(),
+                                               packet.size)) {
+                fprintf(stderr,
+                        "VisionReceiver: got bad packet of %d bytes\n",
+                        packet.size);
+                continue;
+            }
+
+            ++added;
         }
 
-        // Add to the vector of packets
-        _mutex.lock();
-        _packets.push_back(packet);
-        _mutex.unlock();
+        _head.store(head + added, memory_order_release);
     }
 }
@@ -3,20 +3,29 @@
 #include <protobuf/messages_robocup_ssl_wrapper.pb.h>
 #include <Network.hpp>
 #include <Utils.hpp>
+#include <Clock.hpp>
 
 #include <QThread>
-#include <QMutex>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <stdint.h>
 
 class QUdpSocket;
 
+/// A received vision packet, held in one of VisionReceiver's reusable slots
 class VisionPacket {
 public:
-    /// Local time when the packet was received
-    RJ::Time receivedTime;
+    /// Local time when the packet was received.  When the kernel timestamps
+    /// packets, this excludes the time the packet waited in the socket.
+    RJ::Time receivedTime = 0;
 
-    /// protobuf message from the vision system
+    /// The packet as it was received, which is what gets logged.  Only the
+    /// first @size bytes are used.
+    std::vector<char> data;
+    int size = 0;
+
+    /// protobuf message from the vision system, parsed from @data
     SSL_WrapperPacket wrapper;
 };
 
@@ -28,33 +37,70 @@ public:
  * UDP port for packets. If sim = true, it tries both simulator ports until one
  * works. Otherwise, it connects to the port specified in the constructor.
  *
- * Whenever a new packet comes in (encoded as Google Protobuf), it is parsed
- * into an SSL_WrapperPacket and placed onto the circular buffer @_packets.
- * They remain there until they are retrieved with getPackets().
+ * Packets are received directly into a ring of NumSlots preallocated slots,
+ * several at a time where the system allows it, and parsed in place.  The ring
+ * has one producer (the receiving thread, or addPacket() if the thread is not
+ * running) and one consumer (the Processor), which share nothing but the
+ * ring's two indices.  Slots and their messages are reused, so once the
+ * buffers have grown to fit the packets no memory is allocated.
+ *
+ * Packets remain in the ring until they are retrieved with getPackets() and
+ * then given back with releasePackets().  If the consumer falls behind and the
+ * ring fills, packets wait in the socket's buffer.
  */
 class VisionReceiver : public QThread {
 public:
+    /// Number of slots in the ring.  This must be a power of two.
+    static const int NumSlots = 32;
+
+    /// Size of each slot's buffer, which is enough for any UDP datagram
+    static const int MaxPacketSize = 65536;
+
     VisionReceiver(bool sim = false, int port = SharedVisionPortDoubleOld);
 
     void stop();
 
-    /// Copies the vector of packets and then clears it. The vector contains
-    /// only packets received since the last time this was called (or since the
-    /// VisionReceiver was started, if getPackets has never been called).
-    ///
-    /// The caller is responsible for freeing the packets after this function
-    /// returns.
+    /// Replaces the contents of @packets with the packets received since the
+    /// last call, oldest first.  The packets belong to the VisionReceiver and
+    /// stay valid, and may be modified, until releasePackets() is called.
     void getPackets(std::vector<VisionPacket*>& packets);
 
+    /// Returns the slots from the last getPackets() to the ring
+    void releasePackets();
+
+    /// Queues @wrapper as if it had just been received.  This is how packets
+    /// are delivered when vision comes from a simulator in the same process,
+    /// in which case the thread is never started.
+    void addPacket(const SSL_WrapperPacket& wrapper);
+
     bool simulation;
     int port;
 
+    /// Used to timestamp received packets.  This should be the same clock as
+    /// the one in SystemState.
+    std::shared_ptr<RJ::Clock> clock;
+
 protected:
     virtual void run() override;
 
+    VisionPacket& slot(uint32_t i) { return _slots[i & (NumSlots - 1)]; }
+
+    /// Number of slots the producer may fill, starting at slot(_head)
+    int freeSlots() const;
+
     volatile bool _running;
 
-    /// This mutex protects the vector of packets
-    QMutex _mutex;
-    std::vector<VisionPacket*> _packets;
+    std::vector<VisionPacket> _slots;
+
+    /// Number of packets ever added to the ring.  Only the producer writes
+    /// this.
+    std::atomic<uint32_t> _head;
+
+    /// Number of packets ever released by the consumer.  Only the consumer
+    /// writes this.
+    std::atomic<uint32_t> _tail;
+
+    /// Number of packets ever handed out by getPackets().  Only used by the
+    /// consumer.
+    uint32_t _read;
 };
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "VisionReceiver.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static SSL_WrapperPacket detectionPacket(int frameNumber) {
+    SSL_WrapperPacket wrapper;
+    SSL_DetectionFrame* det = wrapper.mutable_detection();
+    det->set_frame_number(frameNumber);
+    det->set_t_capture(frameNumber / 60.0);
+    det->set_t_sent(frameNumber / 60.0);
+    det->set_camera_id(0);
+    return wrapper;
+}
+
+TEST(VisionReceiver, packetsComeOutInOrder) {
+    VisionReceiver vision;
+    vector<VisionPacket*> packets;
+
+    // Go around the ring a few times
+    int next = 0;
+    for (int round = 0; round < 3 * VisionReceiver::NumSlots; ++round) {
+        for (int i = 0; i < 5; ++i) {
+            vision.addPacket(detectionPacket(next + i));
+        }
+
+        vision.getPackets(packets);
+        ASSERT_EQ(5, packets.size());
+        for (VisionPacket* packet : packets) {
+            EXPECT_EQ(next, packet->wrapper.detection().frame_number());
+
+            // The raw bytes are the same packet
+            SSL_WrapperPacket parsed;
+            ASSERT_TRUE(
+                parsed.ParseFromArray(packet->data.data(), packet->size));
+            EXPECT_EQ(next, parsed.detection().frame_number());
+            ++next;
+        }
+        vision.releasePackets();
+
+        vision.getPackets(packets);
+        EXPECT_TRUE(packets.empty());
+    }
+}
+
+TEST(VisionReceiver, fullRingDropsPackets) {
+    VisionReceiver vision;
+    for (int i = 0; i < VisionReceiver::NumSlots + 3; ++i) {
+        vision.addPacket(detectionPacket(i));
+    }
+
+    // Packets handed out but not released still hold their slots
+    vector<VisionPacket*> packets;
+    vision.getPackets(packets);
+    ASSERT_EQ(VisionReceiver::NumSlots, packets.size());
+    EXPECT_EQ(VisionReceiver::NumSlots - 1,
+              packets.back()->wrapper.detection().frame_number());
+
+    vision.addPacket(detectionPacket(100));
+    vector<VisionPacket*> more;
+    vision.getPackets(more);
+    EXPECT_TRUE(more.empty());
+
+    vision.releasePackets();
+    vision.addPacket(detectionPacket(101));
+    vision.getPackets(more);
+    ASSERT_EQ(1, more.size());
+    EXPECT_EQ(101, more[0]->wrapper.detection().frame_number());
+}
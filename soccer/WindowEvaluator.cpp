@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 REGISTER_CONFIGURABLE(WindowEvaluator)
 
@@ -114,8 +116,10 @@ void WindowEvaluator::obstacle_robot(vector<Window>& windows, Point origin,
         Line edge{origin, seg.pt[i]};
         auto d = edge.delta().magsq();
 
+        // Intersect the whole target line, not just the segment, so a robot
+        // that shadows only one end of the target still narrows it
         Point intersect;
-        if (edge.intersects(target, &intersect) &&
+        if (edge.intersects(Line(target), &intersect) &&
             (intersect - origin).dot(edge.delta()) > d) {
             auto f = (intersect - target.pt[0]).dot(target.delta());
             if (f < 0)
@@ -144,33 +148,7 @@ WindowingResult WindowEvaluator::eval_pt_to_seg(Point origin, Segment target) {
     vector<Window> windows = {Window{0, end}};
 
     // apply the obstacles
-
-    vector<Robot*> bots(system->self.size() + system->opp.size());
-
-    auto filter_predicate = [&](const Robot* bot) -> bool {
-        return bot != nullptr && bot->visible &&
-               find(excluded_robots.begin(), excluded_robots.end(), bot) ==
-                   excluded_robots.end();
-    };
-
-    auto end_it = copy_if(system->self.begin(), system->self.end(),
-                          bots.begin(), filter_predicate);
-
-    end_it = copy_if(system->opp.begin(), system->opp.end(), end_it,
-                     filter_predicate);
-
-    bots.resize(distance(bots.begin(), end_it));
-
-    vector<Point> bot_locations;
-    for_each(bots.begin(), bots.end(), [&bot_locations](Robot* bot) {
-        bot_locations.push_back(bot->pos);
-    });
-
-    bot_locations.insert(bot_locations.end(),
-                         hypothetical_robot_locations.begin(),
-                         hypothetical_robot_locations.end());
-
-    for (auto& pos : bot_locations) {
+    for (auto& pos : obstacle_positions()) {
         auto d = (pos - origin).mag();
         // whether or not we can ship over this bot
         auto chip_overable = chip_enabled &&
@@ -213,6 +191,180 @@ WindowingResult WindowEvaluator::eval_pt_to_seg(Point origin, Segment target) {
     return make_pair(windows, best);
 }
 
+vector<Point> WindowEvaluator::obstacle_positions() const {
+    vector<Robot*> bots(system->self.size() + system->opp.size());
+
+    auto filter_predicate = [&](const Robot* bot) -> bool {
+        return bot != nullptr && bot->visible &&
+               find(excluded_robots.begin(), excluded_robots.end(), bot) ==
+                   excluded_robots.end();
+    };
+
+    auto end_it = copy_if(system->self.begin(), system->self.end(),
+                          bots.begin(), filter_predicate);
+
+    end_it = copy_if(system->opp.begin(), system->opp.end(), end_it,
+                     filter_predicate);
+
+    bots.resize(distance(bots.begin(), end_it));
+
+    vector<Point> bot_locations;
+    for_each(bots.begin(), bots.end(), [&bot_locations](Robot* bot) {
+        bot_locations.push_back(bot->pos);
+    });
+
+    bot_locations.insert(bot_locations.end(),
+                         hypothetical_robot_locations.begin(),
+                         hypothetical_robot_locations.end());
+
+    return bot_locations;
+}
+
+vector<boost::optional<Window>> WindowEvaluator::eval_pts_to_segs(
+    const vector<Point>& origins, const vector<Segment>& targets) {
+    size_t count = max(origins.size(), targets.size());
+    if (origins.empty() || targets.empty()) {
+        return {};
+    } else if ((origins.size() != count && origins.size() != 1) ||
+               (targets.size() != count && targets.size() != 1)) {
+        throw invalid_argument(
+            "WindowEvaluator::eval_pts_to_segs(): origins and targets must "
+            "be the same size, or one of them must have one element");
+    }
+
+    vector<Point> positions = obstacle_positions();
+    _obstacle_x.resize(positions.size());
+    _obstacle_y.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        _obstacle_x[i] = positions[i].x;
+        _obstacle_y[i] = positions[i].y;
+    }
+
+    vector<boost::optional<Window>> results(count);
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = best_window(origins[origins.size() == 1 ? 0 : i],
+                                 targets[targets.size() == 1 ? 0 : i]);
+    }
+
+    return results;
+}
+
+boost::optional<Window> WindowEvaluator::best_window(Point origin,
+                                                     Segment target) {
+    const float end = target.delta().magsq();
+    if (end == 0) return boost::none;
+
+    const int n = _obstacle_x.size();
+    _blocked_start.resize(n);
+    _blocked_end.resize(n);
+
+    // Work relative to the origin.  The target is p + u * delta for u in
+    // [0, 1], and the window parameter used by Window is u * end.
+    const float px = target.pt[0].x - origin.x;
+    const float py = target.pt[0].y - origin.y;
+    const float dx = target.delta().x;
+    const float dy = target.delta().y;
+    const float p_cross_d = px * dy - py * dx;
+
+    const float r = Robot_Radius + Ball_Radius;
+    const float chip_min = min_chip_range + Robot_Radius;
+    const float chip_max = max_chip_range - Robot_Radius;
+    const bool chip = chip_enabled;
+
+    const float* xs = _obstacle_x.data();
+    const float* ys = _obstacle_y.data();
+    float* start = _blocked_start.data();
+    float* stop = _blocked_end.data();
+
+    // This is the same geometry as obstacle_robot(), written without
+    // branches so the compiler can vectorize it.  An obstacle that doesn't
+    // block the target gets an empty range.
+    for (int k = 0; k < n; k++) {
+        float bx = xs[k] - origin.x;
+        float by = ys[k] - origin.y;
+        float dist = std::sqrt(bx * bx + by * by);
+        float inv = dist > 0 ? 1 / dist : 0;
+        float nx = bx * inv;
+        float ny = by * inv;
+
+        // Edges of the front of the robot as seen from the origin
+        float cx = bx - nx * Robot_Radius;
+        float cy = by - ny * Robot_Radius;
+        float e0x = cx - ny * r;
+        float e0y = cy + nx * r;
+        float e1x = cx + ny * r;
+        float e1y = cy - nx * r;
+
+        // The line from the origin through edge e hits the target line at
+        // s * e = p + u * delta.  Both edges must cross it beyond the robot
+        // (s > 1), and the shadow is clamped to the target segment.
+        float den0 = e0x * dy - e0y * dx;
+        float den1 = e1x * dy - e1y * dx;
+        float inv0 = 1 / den0;
+        float inv1 = 1 / den1;
+        float s0 = p_cross_d * inv0;
+        float s1 = p_cross_d * inv1;
+        float u0 = (px * e0y - py * e0x) * inv0;
+        float u1 = (px * e1y - py * e1x) * inv1;
+
+        bool hit0 = den0 != 0 && s0 > 1;
+        bool hit1 = den1 != 0 && s1 > 1;
+        bool chip_over = chip && dist < chip_max && dist > chip_min;
+        bool blocks = hit0 && hit1 && !chip_over;
+        u0 = min(max(u0, 0.0f), 1.0f);
+        u1 = min(max(u1, 0.0f), 1.0f);
+
+        start[k] = blocks ? min(u0, u1) * end : 0;
+        stop[k] = blocks ? max(u0, u1) * end : 0;
+    }
+
+    // Keep the non-empty ranges and sort them by start.  There are only a
+    // few robots, so insertion sort is fastest.
+    int m = 0;
+    for (int k = 0; k < n; k++) {
+        if (start[k] < stop[k]) {
+            float s = start[k];
+            float e = stop[k];
+            int j = m++;
+            while (j > 0 && start[j - 1] > s) {
+                start[j] = start[j - 1];
+                stop[j] = stop[j - 1];
+                j--;
+            }
+            start[j] = s;
+            stop[j] = e;
+        }
+    }
+
+    // The windows are the gaps between the blocked ranges.  Like
+    // eval_pt_to_seg(), pick the first of the widest windows.
+    float covered = 0;
+    float best_t0 = 0;
+    float best_t1 = 0;
+    for (int k = 0; k <= m; k++) {
+        float next = k < m ? start[k] : end;
+        if (next - covered > best_t1 - best_t0) {
+            best_t0 = covered;
+            best_t1 = next;
+        }
+        if (k < m) {
+            covered = max(covered, stop[k]);
+        }
+    }
+
+    if (best_t1 <= best_t0) return boost::none;
+
+    Window w{best_t0, best_t1};
+    auto delta = target.delta() / end;
+    w.segment = Segment{target.pt[0] + delta * w.t0,
+                        target.pt[0] + delta * w.t1};
+    w.a0 = RadiansToDegrees((w.segment.pt[0] - origin).angle());
+    w.a1 = RadiansToDegrees((w.segment.pt[1] - origin).angle());
+    fill_shot_success(w, origin);
+
+    return w;
+}
+
 void WindowEvaluator::fill_shot_success(Window& window, Point origin) {
     auto shot_vector = window.segment.center() - origin;
     auto shot_distance = shot_vector.mag();
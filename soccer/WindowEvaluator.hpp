@@ -86,6 +86,22 @@ public:
     WindowingResult eval_pt_to_seg(Geometry2d::Point origin,
                                    Geometry2d::Segment target);
 
+    /**
+     * @brief Finds the best shot window for many shots at once
+     * @details Shot i goes from origins[i] to targets[i].  If either vector
+     * has only one element, it is used for every shot.  Robot positions are
+     * collected once for the whole batch and the obstacles are applied in
+     * flat loops, so this is much faster than calling eval_pt_to_seg() for
+     * each shot.  Only the best window of each shot is computed, and no debug
+     * drawing is done.
+     * @param origins The starting points of the shots
+     * @param targets The target segments to aim at
+     * @return The best window for each shot, or none if the shot is blocked
+     */
+    std::vector<boost::optional<Window>> eval_pts_to_segs(
+        const std::vector<Geometry2d::Point>& origins,
+        const std::vector<Geometry2d::Segment>& targets);
+
     /**
      * @brief Initializes configurable fields.
      * @note See configuration documentation for details.
@@ -125,8 +141,26 @@ public:
 private:
     SystemState* system;
 
+    /// Positions of all robots that are obstacles, including hypothetical
+    /// ones
+    std::vector<Geometry2d::Point> obstacle_positions() const;
+
     void fill_shot_success(Window& window, Geometry2d::Point origin);
 
+    /// Best window for one shot in eval_pts_to_segs(), using the obstacles in
+    /// _obstacle_x and _obstacle_y
+    boost::optional<Window> best_window(Geometry2d::Point origin,
+                                        Geometry2d::Segment target);
+
+    // Obstacle positions for eval_pts_to_segs(), stored as separate
+    // coordinate arrays so the per-obstacle math vectorizes
+    std::vector<float> _obstacle_x;
+    std::vector<float> _obstacle_y;
+
+    // Blocked range of each obstacle along the target, reused between shots
+    std::vector<float> _blocked_start;
+    std::vector<float> _blocked_end;
+
     void obstacle_range(std::vector<Window>& windows, double& t0, double& t1);
 
     void obstacle_robot(std::vector<Window>& windows, Geometry2d::Point origin,
@@ -3,6 +3,9 @@
 #include "SystemState.hpp"
 #include "Configuration.hpp"
 
+#include <algorithm>
+
+using namespace std;
 using namespace Geometry2d;
 
 Configuration config;
@@ -36,3 +39,117 @@ TEST(WindowEvaluator, eval_pt_to_seg) {
     // the window should be our goal segment
     EXPECT_EQ(ourGoalSegment, windows[0].segment);
 }
+
+namespace {
+
+Segment ourGoalSegment() {
+    return Segment(
+        Point(Field_Dimensions::Current_Dimensions.GoalWidth() / 2.0, 0),
+        Point(-Field_Dimensions::Current_Dimensions.GoalWidth() / 2.0, 0));
+}
+
+// Places two of our robots and two opponents in front of our goal
+void placeBlockers(SystemState& state) {
+    Point positions[] = {Point(0.3, 1), Point(-0.5, 2), Point(0.1, 3),
+                         Point(1, 1.5)};
+    for (int i = 0; i < 2; ++i) {
+        state.self[i]->visible = true;
+        state.self[i]->pos = positions[i];
+        state.opp[i]->visible = true;
+        state.opp[i]->pos = positions[i + 2];
+    }
+}
+
+// A grid of shot origins around the robots placed by placeBlockers()
+vector<Point> shotOrigins() {
+    vector<Point> origins;
+    for (float x = -1.5; x <= 1.5; x += 0.25) {
+        for (float y = 0.5; y <= 5; y += 0.25) {
+            origins.push_back(Point(x, y));
+        }
+    }
+    return origins;
+}
+
+// Evaluates @origins against @target in one batch, checks that each result
+// matches evaluating that origin alone, and returns the batch results
+vector<boost::optional<Window>> evalAndCompare(WindowEvaluator& winEval,
+                                               const vector<Point>& origins,
+                                               const Segment& target) {
+    auto results = winEval.eval_pts_to_segs(origins, {target});
+    EXPECT_EQ(origins.size(), results.size());
+    if (results.size() != origins.size()) {
+        return results;
+    }
+
+    for (size_t i = 0; i < origins.size(); ++i) {
+        auto single = winEval.eval_pt_to_seg(origins[i], target);
+        auto& best = single.second;
+
+        EXPECT_EQ((bool)best, (bool)results[i]) << origins[i];
+        if (best && results[i]) {
+            EXPECT_NEAR(best->t0, results[i]->t0, 1e-4);
+            EXPECT_NEAR(best->t1, results[i]->t1, 1e-4);
+            EXPECT_NEAR(best->shot_success, results[i]->shot_success, 1e-4);
+        }
+    }
+    return results;
+}
+
+}  // namespace
+
+// Evaluating a grid of shots in one batch should find the same best windows
+// as evaluating them one at a time.
+TEST(WindowEvaluator, eval_pts_to_segs) {
+    SystemState state;
+    placeBlockers(state);
+    Segment goal = ourGoalSegment();
+    vector<Point> origins = shotOrigins();
+
+    WindowEvaluator winEval(&state);
+    auto results = evalAndCompare(winEval, origins, goal);
+
+    // Some shots should be completely blocked, but not all of them
+    int blocked = count(results.begin(), results.end(), boost::none);
+    EXPECT_GT(blocked, 0);
+    EXPECT_LT(blocked, (int)origins.size());
+
+    // One origin can be evaluated against many targets
+    auto targets = winEval.eval_pts_to_segs({Point(0, 4)}, {goal, goal, goal});
+    EXPECT_EQ(3, targets.size());
+
+    EXPECT_THROW(winEval.eval_pts_to_segs({Point(0, 4), Point(0, 3)},
+                                          {goal, goal, goal}),
+                 std::invalid_argument);
+}
+
+// With chipping enabled, robots in the chip range don't block shots in either
+// version of the evaluator.
+TEST(WindowEvaluator, eval_pts_to_segs_chip) {
+    SystemState state;
+    placeBlockers(state);
+    Segment goal = ourGoalSegment();
+    vector<Point> origins = shotOrigins();
+
+    WindowEvaluator winEval(&state);
+    auto direct = winEval.eval_pts_to_segs(origins, {goal});
+
+    winEval.chip_enabled = true;
+    winEval.min_chip_range = 0.5;
+    winEval.max_chip_range = 3;
+    auto results = evalAndCompare(winEval, origins, goal);
+    ASSERT_EQ(origins.size(), results.size());
+
+    int wider = 0;
+    for (size_t i = 0; i < origins.size(); ++i) {
+        float width = results[i] ? results[i]->t1 - results[i]->t0 : 0;
+        float directWidth = direct[i] ? direct[i]->t1 - direct[i]->t0 : 0;
+        EXPECT_GE(width, directWidth - 1e-4);
+        if (width > directWidth + 1e-4) {
+            ++wider;
+        }
+    }
+
+    // Chipping should open up some shots
+    EXPECT_GT(wider, 0);
+}
@@ -206,6 +206,8 @@ void Gameplay::GameplayModule::calculateFieldObstacles() {
 }
 
 Gameplay::GameplayModule::~GameplayModule() {
+    pipelined(false);
+
     // Apparently this is broken in Boost 1.57 as per:
     // http://www.boost.org/doc/libs/1_57_0/libs/python/doc/tutorial/doc/html/python/embedding.html
     // Py_Finalize();
@@ -310,15 +312,23 @@ Geometry2d::ShapeSet Gameplay::GameplayModule::goalZoneObstacles() const {
  * runs the current play
  */
 void Gameplay::GameplayModule::run() {
+    if (pipelined()) {
+        runPipelined();
+    } else {
+        runPlays(_state);
+    }
+}
+
+void Gameplay::GameplayModule::runPlays(SystemState* state) {
     QMutexLocker lock(&_mutex);
 
     bool verbose = false;
     if (verbose) cout << "Starting GameplayModule::run()" << endl;
 
-    _ballMatrix = Geometry2d::TransformMatrix::translate(_state->ball.pos);
+    _ballMatrix = Geometry2d::TransformMatrix::translate(state->ball.pos);
 
     /// prepare each bot for the next iteration by resetting temporary things
-    for (OurRobot* robot : _state->self) {
+    for (OurRobot* robot : state->self) {
         if (robot) {
             robot->resetAvoidBall();
             robot->resetAvoidRobotRadii();
@@ -328,13 +338,13 @@ void Gameplay::GameplayModule::run() {
 
     /// Build a list of visible robots
     _playRobots.clear();
-    for (OurRobot* r : _state->self) {
+    for (OurRobot* r : state->self) {
         if (r->visible && r->rxIsFresh()) {
             _playRobots.insert(r);
         }
     }
 
-    PyGILState_STATE state = PyGILState_Ensure();
+    PyGILState_STATE gilState = PyGILState_Ensure();
     {
         try {
             // vector of shared pointers to pass to python
@@ -352,7 +362,7 @@ void Gameplay::GameplayModule::run() {
 
             vector<OpponentRobot*>* theirBotVector =
                 new vector<OpponentRobot*>();
-            for (auto itr = _state->opp.begin(); itr != _state->opp.end();
+            for (auto itr = state->opp.begin(); itr != state->opp.end();
                  itr++) {
                 OpponentRobot* bot = *itr;
                 if (bot && bot->visible) {
@@ -361,11 +371,11 @@ void Gameplay::GameplayModule::run() {
             }
             getMainModule().attr("set_their_robots")(theirBotVector);
 
-            getMainModule().attr("set_game_state")(_state->gameState);
+            getMainModule().attr("set_game_state")(state->gameState);
 
-            getMainModule().attr("set_system_state")(&_state);
+            getMainModule().attr("set_system_state")(&state);
 
-            getMainModule().attr("set_ball")(_state->ball);
+            getMainModule().attr("set_ball")(state->ball);
 
         } catch (error_already_set) {
             PyErr_Print();
@@ -397,7 +407,7 @@ void Gameplay::GameplayModule::run() {
                 // record the state of our behavior tree
                 std::string bhvrTreeDesc =
                     extract<std::string>(getRootPlay().attr("__str__")());
-                _state->logFrame->set_behavior_tree(bhvrTreeDesc);
+                state->logFrame->set_behavior_tree(bhvrTreeDesc);
             } catch (error_already_set) {
                 PyErr_Print();
             }
@@ -406,23 +416,118 @@ void Gameplay::GameplayModule::run() {
             throw new runtime_error("Error trying to run root play");
         }
     }
-    PyGILState_Release(state);
+    PyGILState_Release(gilState);
 
     /// visualize
-    if (_state->gameState.stayAwayFromBall() && _state->ball.valid) {
-        _state->drawCircle(_state->ball.pos,
-                           Field_Dimensions::Current_Dimensions.CenterRadius(),
-                           Qt::black, "Rules");
+    if (state->gameState.stayAwayFromBall() && state->ball.valid) {
+        state->drawCircle(state->ball.pos,
+                          Field_Dimensions::Current_Dimensions.CenterRadius(),
+                          Qt::black, "Rules");
     }
 
     if (verbose) cout << "Finishing GameplayModule::run()" << endl;
 
-    if (_state->gameState.ourScore > _our_score_last_frame) {
-        for (OurRobot* r : _state->self) {
+    if (state->gameState.ourScore > _our_score_last_frame) {
+        for (OurRobot* r : state->self) {
             r->sing();
         }
     }
-    _our_score_last_frame = _state->gameState.ourScore;
+    _our_score_last_frame = state->gameState.ourScore;
+}
+
+void Gameplay::GameplayModule::runPipelined() {
+    std::unique_lock<std::mutex> lock(_pipelineMutex);
+
+    // The plays only reset the snapshot's robots, so the real ones are reset
+    // here every frame to keep per-frame state such as the last time the
+    // kicker was charged up to date.
+    for (OurRobot* robot : _state->self) {
+        robot->resetForNextIteration();
+    }
+
+    // Use the commands from the last run that finished.  These are copied
+    // every frame so the robots start from the same commands each time, as
+    // they would if the plays had run again.
+    if (_hasCommands) {
+        for (size_t i = 0; i < Num_Shells; ++i) {
+            _state->self[i]->copyCommands(*_latched->self[i]);
+        }
+        _state->copyDrawings(*_latched);
+        _state->logFrame->set_behavior_tree(
+            _latched->logFrame->behavior_tree());
+    }
+
+    if (_playsRunning) {
+        ++_overruns;
+        return;
+    }
+
+    // Start the plays on a snapshot of this frame
+    _snapshot->timestamp = _state->timestamp;
+    _snapshot->clock = _state->clock;
+    _snapshot->gameState = _state->gameState;
+    _snapshot->ball = _state->ball;
+    for (size_t i = 0; i < Num_Shells; ++i) {
+        _snapshot->self[i]->copyWorldState(*_state->self[i]);
+        static_cast<RobotPose&>(*_snapshot->opp[i]) = *_state->opp[i];
+    }
+    _snapshot->logFrame = make_shared<Packet::LogFrame>();
+
+    _playsRunning = true;
+    lock.unlock();
+    _pipelineCond.notify_one();
+}
+
+void Gameplay::GameplayModule::gameplayLoop() {
+    std::unique_lock<std::mutex> lock(_pipelineMutex);
+    while (true) {
+        _pipelineCond.wait(lock, [this] { return _playsRunning || _stopping; });
+        if (_stopping) {
+            break;
+        }
+
+        // The Processor leaves _snapshot alone while _playsRunning is set
+        lock.unlock();
+        runPlays(_snapshot.get());
+        lock.lock();
+
+        // Keep the results for the Processor
+        _latched->logFrame = make_shared<Packet::LogFrame>();
+        _latched->copyDrawings(*_snapshot);
+        _latched->logFrame->set_behavior_tree(
+            _snapshot->logFrame->behavior_tree());
+        for (size_t i = 0; i < Num_Shells; ++i) {
+            _latched->self[i]->copyCommands(*_snapshot->self[i]);
+        }
+
+        _hasCommands = true;
+        _playsRunning = false;
+    }
+}
+
+void Gameplay::GameplayModule::pipelined(bool value) {
+    if (value == pipelined()) {
+        return;
+    }
+
+    if (value) {
+        if (!_snapshot) {
+            _snapshot = std::make_unique<SystemState>();
+            _latched = std::make_unique<SystemState>();
+        }
+
+        _stopping = false;
+        _playsRunning = false;
+        _hasCommands = false;
+        _gameplayThread = std::thread(&GameplayModule::gameplayLoop, this);
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(_pipelineMutex);
+            _stopping = true;
+        }
+        _pipelineCond.notify_one();
+        _gameplayThread.join();
+    }
 }
 
 #pragma mark python
@@ -11,7 +11,12 @@
 #include <Geometry2d/CompositeShape.hpp>
 #include <Geometry2d/ShapeSet.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <QMutex>
 #include <QString>
 
@@ -39,6 +44,9 @@ namespace Gameplay {
  * calls into python, which does all of the high-level planning, resulting in
  * updated motion targets, etc for the robots.  The
  * GameplayModule then executes path planning for each OurRobot.
+ *
+ * In pipelined mode (see pipelined()) python runs on its own thread instead,
+ * so that a slow play can't hold up the rest of the processing loop.
  */
 class GameplayModule {
 public:
@@ -47,8 +55,34 @@ public:
 
     SystemState* state() const { return _state; }
 
+    /**
+     * Runs the plays and leaves their commands in the robots.  This is called
+     * by the Processor once per frame.
+     */
     virtual void run();
 
+    /**
+     * @brief Runs plays on their own thread, one frame behind the Processor
+     *
+     * @details When pipelined, run() does not call into python.  It gives the
+     * robots the commands from the last run of the plays that finished, then,
+     * if the gameplay thread is idle, copies the robots, ball and game state
+     * into a snapshot and starts the plays on it.  Commands computed from
+     * frame N are therefore used starting in frame N+1.
+     *
+     * A run that takes longer than a frame only delays its own commands:
+     * planning, motion control and the radio keep running every frame with
+     * the previous commands.
+     *
+     * This must not be called while run() is running.
+     */
+    void pipelined(bool value);
+    bool pipelined() const { return _gameplayThread.joinable(); }
+
+    /// Number of frames in pipelined mode that reused the previous commands
+    /// because the plays were still running
+    uint64_t overruns() const { return _overruns; }
+
     void setupUI();
 
     /**
@@ -115,6 +149,16 @@ public:
     Geometry2d::ShapeSet goalZoneObstacles() const;
 
 protected:
+    /// Prepares the robots in @state for a new frame and runs the root play
+    /// on them
+    void runPlays(SystemState* state);
+
+    /// run() in pipelined mode
+    void runPipelined();
+
+    /// Body of the gameplay thread in pipelined mode
+    void gameplayLoop();
+
     boost::python::object getRootPlay();
 
     /// gets the instance of the main.py module that's loaded at GameplayModule
@@ -161,5 +205,30 @@ private:
 
     // python
     boost::python::object _mainPyNamespace;
+
+    // Pipelined mode
+
+    /// The state that plays see.  The Processor only writes to it while the
+    /// gameplay thread is idle.
+    std::unique_ptr<SystemState> _snapshot;
+
+    /// Commands and drawings from the last run of the plays that finished.
+    /// This is only accessed while _pipelineMutex is locked.
+    std::unique_ptr<SystemState> _latched;
+
+    std::thread _gameplayThread;
+    std::mutex _pipelineMutex;
+    std::condition_variable _pipelineCond;
+
+    /// True while the gameplay thread is running plays on _snapshot
+    bool _playsRunning = false;
+
+    /// True once _latched holds commands
+    bool _hasCommands = false;
+
+    /// Tells the gameplay thread to exit
+    bool _stopping = false;
+
+    std::atomic<uint64_t> _overruns{0};
 };
 }
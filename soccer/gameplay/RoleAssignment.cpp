@@ -0,0 +1,147 @@
+#include "RoleAssignment.hpp"
+
+#include <Robot.hpp>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+using namespace Geometry2d;
+
+namespace Gameplay {
+namespace RoleAssignment {
+
+void costMatrix(const vector<OurRobot*>& robots,
+                const vector<Requirements>& roles, int forbiddenBallToucher,
+                Eigen::MatrixXd& cost) {
+    cost.resize(robots.size(), roles.size());
+
+    for (size_t i = 0; i < robots.size(); ++i) {
+        const OurRobot* robot = robots[i];
+        int shell = robot->shell();
+
+        // These don't depend on the role
+        bool hasBall = robot->hasBall();
+        bool canKick = shell != forbiddenBallToucher && robot->kickerWorks() &&
+                       robot->ballSenseWorks();
+        bool hasChipper = robot->chipper_available();
+
+        for (size_t j = 0; j < roles.size(); ++j) {
+            const Requirements& req = roles[j];
+            double c = 0;
+
+            if (req.requiredShellID >= 0 && req.requiredShellID != shell) {
+                c = MaxWeight;
+            } else if (req.hasBall && !hasBall) {
+                c = MaxWeight;
+            } else if (req.requireKicking && !canKick) {
+                c = MaxWeight;
+            } else {
+                if (req.destination) {
+                    c += PositionCostMultiplier *
+                         req.destination->distTo(robot->pos);
+                }
+                if (req.previousShellID >= 0 && req.previousShellID != shell) {
+                    c += RobotChangeCost;
+                }
+                if (!hasChipper) {
+                    c += req.chipperPreferenceWeight;
+                }
+            }
+
+            if (std::isnan(c)) {
+                throw invalid_argument(
+                    "NaN value encountered when building role assignment "
+                    "cost matrix");
+            }
+
+            cost(i, j) = c;
+        }
+    }
+}
+
+vector<int> solve(const Eigen::MatrixXd& cost) {
+    if (cost.rows() > cost.cols()) {
+        // Assign every column to a row instead, then invert the result
+        vector<int> colToRow = solve(cost.transpose());
+        vector<int> rowToCol(cost.rows(), -1);
+        for (size_t col = 0; col < colToRow.size(); ++col) {
+            rowToCol[colToRow[col]] = col;
+        }
+        return rowToCol;
+    }
+
+    // Hungarian algorithm with potentials, adding one row at a time.
+    // Indices are 1-based; column 0 is a sentinel holding the row being added.
+    const int n = cost.rows();
+    const int m = cost.cols();
+    const double inf = numeric_limits<double>::infinity();
+
+    vector<double> u(n + 1, 0), v(m + 1, 0);
+
+    // Row assigned to each column
+    vector<int> p(m + 1, 0);
+
+    // Previous column on the augmenting path
+    vector<int> way(m + 1, 0);
+
+    vector<double> minv(m + 1);
+    vector<char> used(m + 1);
+
+    for (int i = 1; i <= n; ++i) {
+        p[0] = i;
+        int j0 = 0;
+        fill(minv.begin(), minv.end(), inf);
+        fill(used.begin(), used.end(), false);
+
+        // Grow the tree of tight edges until it reaches a free column
+        do {
+            used[j0] = true;
+            int i0 = p[j0];
+            double delta = inf;
+            int j1 = 0;
+            for (int j = 1; j <= m; ++j) {
+                if (!used[j]) {
+                    double cur = cost(i0 - 1, j - 1) - u[i0] - v[j];
+                    if (cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+            }
+
+            for (int j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+
+        // Flip the augmenting path
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0);
+    }
+
+    vector<int> rowToCol(n, -1);
+    for (int j = 1; j <= m; ++j) {
+        if (p[j]) {
+            rowToCol[p[j] - 1] = j - 1;
+        }
+    }
+    return rowToCol;
+}
+
+}  // namespace RoleAssignment
+}  // namespace Gameplay
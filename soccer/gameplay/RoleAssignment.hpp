@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Geometry2d/Point.hpp>
+#include <Geometry2d/Segment.hpp>
+
+#include <boost/optional.hpp>
+#include <Eigen/Dense>
+#include <vector>
+
+class OurRobot;
+
+namespace Gameplay {
+
+/**
+ * @brief Matching of robots to roles, used by role_assignment.py
+ *
+ * @details The cost of giving a role to a robot is computed here from the
+ * role's requirements, and the cheapest overall assignment is found with the
+ * Hungarian algorithm.  See role_assignment.RoleRequirements for what each
+ * requirement means.
+ */
+namespace RoleAssignment {
+
+/// Cost of an assignment that breaks a hard requirement.  This matches
+/// role_assignment.MaxWeight, so a chipper_preference_weight of MaxWeight makes
+/// a chipper required.
+const double MaxWeight = 10000000;
+
+/// Multiply this by the distance between two points to get the cost
+const double PositionCostMultiplier = 1.0;
+
+/// Penalty for switching robots mid-play
+const double RobotChangeCost = 1.0;
+
+/// What a role needs from the robot that fills it
+struct Requirements {
+    /// Where the robot is going.  A point is stored as a zero-length segment.
+    boost::optional<Geometry2d::Segment> destination;
+
+    bool hasBall = false;
+    double chipperPreferenceWeight = 0;
+
+    /// Shell IDs, or -1 for none
+    int requiredShellID = -1;
+    int previousShellID = -1;
+
+    bool requireKicking = false;
+};
+
+/**
+ * Fills @cost with the cost of giving each role (column) to each robot (row)
+ *
+ * @param forbiddenBallToucher Shell ID of the robot that may not touch the
+ *     ball because of the double touch rule, or -1 for none
+ * @throws std::invalid_argument if a cost is NaN
+ */
+void costMatrix(const std::vector<OurRobot*>& robots,
+                const std::vector<Requirements>& roles,
+                int forbiddenBallToucher, Eigen::MatrixXd& cost);
+
+/**
+ * Finds the assignment of rows to columns with the smallest total cost in
+ * O(n^2 m) time, where n is the smaller dimension.  Every row is assigned if
+ * there are at least as many columns as rows, and every column otherwise.
+ *
+ * @return the column assigned to each row, or -1 if the row is unassigned
+ */
+std::vector<int> solve(const Eigen::MatrixXd& cost);
+
+}  // namespace RoleAssignment
+}  // namespace Gameplay
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "RoleAssignment.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace std;
+using namespace Gameplay;
+
+// Total cost of an assignment returned by RoleAssignment::solve()
+static double totalCost(const Eigen::MatrixXd& cost,
+                        const vector<int>& assignment) {
+    double total = 0;
+    for (size_t row = 0; row < assignment.size(); ++row) {
+        if (assignment[row] >= 0) {
+            total += cost(row, assignment[row]);
+        }
+    }
+    return total;
+}
+
+// Smallest total cost, found by trying every assignment
+static double bruteForceCost(const Eigen::MatrixXd& cost) {
+    const bool transpose = cost.rows() > cost.cols();
+    const Eigen::MatrixXd c = transpose ? cost.transpose() : cost;
+
+    vector<int> cols(c.cols());
+    for (size_t i = 0; i < cols.size(); ++i) {
+        cols[i] = i;
+    }
+
+    // Every ordering of the columns, with the first c.rows() assigned
+    double best = numeric_limits<double>::infinity();
+    do {
+        double total = 0;
+        for (int row = 0; row < c.rows(); ++row) {
+            total += c(row, cols[row]);
+        }
+        best = min(best, total);
+    } while (next_permutation(cols.begin(), cols.end()));
+
+    return best;
+}
+
+// Checks that @assignment uses each column at most once and assigns as many
+// rows as possible
+static void expectValid(const Eigen::MatrixXd& cost,
+                        const vector<int>& assignment) {
+    ASSERT_EQ(cost.rows(), assignment.size());
+
+    vector<bool> used(cost.cols(), false);
+    int assigned = 0;
+    for (int col : assignment) {
+        if (col >= 0) {
+            ASSERT_LT(col, cost.cols());
+            EXPECT_FALSE(used[col]);
+            used[col] = true;
+            ++assigned;
+        }
+    }
+    EXPECT_EQ(min(cost.rows(), cost.cols()), assigned);
+}
+
+TEST(RoleAssignment, solveEmpty) {
+    EXPECT_TRUE(RoleAssignment::solve(Eigen::MatrixXd(0, 3)).empty());
+    EXPECT_EQ(vector<int>({-1, -1}),
+              RoleAssignment::solve(Eigen::MatrixXd(2, 0)));
+}
+
+TEST(RoleAssignment, solveSimple) {
+    Eigen::MatrixXd cost(3, 3);
+    cost << 4, 1, 3,  //
+        2, 0, 5,      //
+        3, 2, 2;
+
+    EXPECT_EQ(vector<int>({1, 0, 2}), RoleAssignment::solve(cost));
+}
+
+TEST(RoleAssignment, solveMaxWeight) {
+    // Only robot 1 may fill role 0
+    const double M = RoleAssignment::MaxWeight;
+    Eigen::MatrixXd cost(3, 2);
+    cost << M, 1,  //
+        5, 2,      //
+        M, 3;
+
+    vector<int> assignment = RoleAssignment::solve(cost);
+    EXPECT_EQ(0, assignment[1]);
+    EXPECT_LT(totalCost(cost, assignment), M);
+}
+
+TEST(RoleAssignment, solveMatchesBruteForce) {
+    mt19937 rng(1);
+    uniform_int_distribution<int> sizeDist(1, 6);
+    uniform_real_distribution<double> costDist(0, 10);
+
+    for (int trial = 0; trial < 500; ++trial) {
+        Eigen::MatrixXd cost(sizeDist(rng), sizeDist(rng));
+        for (int i = 0; i < cost.rows(); ++i) {
+            for (int j = 0; j < cost.cols(); ++j) {
+                // Use some MaxWeight entries and some ties
+                int kind = trial % 4 == 0 ? rng() % 8 : 2;
+                if (kind == 0) {
+                    cost(i, j) = RoleAssignment::MaxWeight;
+                } else if (kind == 1) {
+                    cost(i, j) = 1;
+                } else {
+                    cost(i, j) = costDist(rng);
+                }
+            }
+        }
+
+        vector<int> assignment = RoleAssignment::solve(cost);
+        expectValid(cost, assignment);
+        EXPECT_NEAR(bruteForceCost(cost), totalCost(cost, assignment), 1e-6)
+            << "cost:\n"
+            << cost;
+    }
+}
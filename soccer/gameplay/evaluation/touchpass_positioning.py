@@ -114,22 +114,28 @@ def eval_best_receive_point(kick_point,
         # We can't do anything.
         return None
 
-    bestChance = None
-
     for segment in segments:
         main.system_state().draw_line(segment, constants.Colors.Blue,
                                       "Candidate Lines")
-        _, best = win_eval.eval_pt_to_seg(kick_point, segment)
-        if best == None: continue
 
-        currentChance = best.shot_success
-        # TODO dont only aim for center of goal. Waiting on window_evaluator returning a probability.
-        receivePt = best.segment.center()
+    # Evaluate the passes to every candidate segment in one batch, then the
+    # shots from every receive point in another
+    receive_windows = [
+        w for w in win_eval.eval_pts_to_segs([kick_point], segments)
+        if w != None
+    ]
+    # TODO dont only aim for center of goal. Waiting on window_evaluator returning a probability.
+    receive_pts = [w.segment.center() for w in receive_windows]
+    shot_windows = win_eval.eval_pts_to_segs(receive_pts, [targetSeg])
+
+    bestChance = None
+    bestpt = None
 
-        _, best = win_eval.eval_pt_to_seg(receivePt, targetSeg)
+    for receive, receivePt, best in zip(receive_windows, receive_pts,
+                                        shot_windows):
         if best == None: continue
 
-        currentChance = currentChance * best.shot_success
+        currentChance = receive.shot_success * best.shot_success
         if bestChance == None or currentChance > bestChance:
             bestChance = currentChance
             targetPoint = best.segment.center()
@@ -8,6 +8,7 @@
 using namespace boost::python;
 
 #include "motion/TrapezoidalMotion.hpp"
+#include "RoleAssignment.hpp"
 #include "WindowEvaluator.hpp"
 #include <Constants.hpp>
 #include <Geometry2d/Arc.hpp>
@@ -453,10 +454,106 @@ boost::python::tuple WinEval_eval_pt_to_our_goal(
     return boost::python::tuple{lst};
 }
 
+boost::python::list WinEval_eval_pts_to_segs(
+    WindowEvaluator* self, const boost::python::list& origins,
+    const boost::python::list& targets) {
+    std::vector<Geometry2d::Point> originVec;
+    for (int i = 0; i < len(origins); i++) {
+        originVec.push_back(
+            boost::python::extract<Geometry2d::Point>(origins[i]));
+    }
+
+    std::vector<Geometry2d::Segment> targetVec;
+    for (int i = 0; i < len(targets); i++) {
+        targetVec.push_back(
+            boost::python::extract<Geometry2d::Segment>(targets[i]));
+    }
+
+    boost::python::list lst;
+    for (auto& best : self->eval_pts_to_segs(originVec, targetVec)) {
+        if (best.is_initialized())
+            lst.append(best.get());
+        else
+            lst.append(boost::python::api::object());
+    }
+
+    return lst;
+}
+
 void WinEval_add_excluded_robot(WindowEvaluator* self, Robot* robot) {
     self->excluded_robots.push_back(robot);
 }
 
+// Returns the value of an optional int attribute, or -1 if it's None
+int optional_int_attr(const boost::python::object& obj, const char* name) {
+    boost::python::object value = obj.attr(name);
+    return value.is_none() ? -1 : boost::python::extract<int>(value)();
+}
+
+/**
+ * Solves role assignment for role_assignment.assign_roles()
+ *
+ * @param robots list of OurRobot
+ * @param roles list of role_assignment.RoleRequirements
+ * @param forbidden_ball_toucher shell ID from the double touch tracker, or
+ *     None
+ * @return a tuple of the index of the role assigned to each robot (or -1)
+ *     and the total cost of the assignment
+ */
+boost::python::tuple assign_roles(const boost::python::list& robots,
+                                  const boost::python::list& roles,
+                                  const boost::python::object&
+                                      forbidden_ball_toucher) {
+    std::vector<OurRobot*> robotVec;
+    for (int i = 0; i < len(robots); i++) {
+        OurRobot* robot = boost::python::extract<OurRobot*>(robots[i]);
+        if (robot == nullptr) throw NullArgumentException{"robots"};
+        robotVec.push_back(robot);
+    }
+
+    std::vector<Gameplay::RoleAssignment::Requirements> reqVec(len(roles));
+    for (int i = 0; i < len(roles); i++) {
+        boost::python::object role = roles[i];
+        auto& req = reqVec[i];
+
+        boost::python::object shape = role.attr("destination_shape");
+        boost::python::extract<Geometry2d::Point> point(shape);
+        if (point.check()) {
+            req.destination = Geometry2d::Segment(point(), point());
+        } else if (!shape.is_none()) {
+            req.destination =
+                boost::python::extract<Geometry2d::Segment>(shape)();
+        }
+
+        boost::python::object hasBall = role.attr("has_ball");
+        req.hasBall =
+            !hasBall.is_none() && boost::python::extract<bool>(hasBall);
+        req.chipperPreferenceWeight = boost::python::extract<double>(
+            role.attr("chipper_preference_weight"));
+        req.requiredShellID = optional_int_attr(role, "required_shell_id");
+        req.previousShellID = optional_int_attr(role, "previous_shell_id");
+        req.requireKicking =
+            boost::python::extract<bool>(role.attr("require_kicking"));
+    }
+
+    int forbidden = forbidden_ball_toucher.is_none()
+                        ? -1
+                        : boost::python::extract<int>(forbidden_ball_toucher)();
+
+    Eigen::MatrixXd cost;
+    Gameplay::RoleAssignment::costMatrix(robotVec, reqVec, forbidden, cost);
+    std::vector<int> assignment = Gameplay::RoleAssignment::solve(cost);
+
+    boost::python::list lst;
+    double total = 0;
+    for (size_t i = 0; i < assignment.size(); i++) {
+        lst.append(assignment[i]);
+        if (assignment[i] >= 0) total += cost(i, assignment[i]);
+    }
+
+    return boost::python::make_tuple(lst, total);
+}
+
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Point_overloads, normalized, 0, 1)
 
 /**
@@ -469,6 +566,7 @@ BOOST_PYTHON_MODULE(robocup) {
 
     def("fix_angle_radians", &fixAngleRadians);
     def("get_trapezoidal_time", &Trapezoidal::getTime);
+    def("assign_roles", &assign_roles);
 
     class_<Geometry2d::Point, Geometry2d::Point*>("Point", init<float, float>())
         .def(init<const Geometry2d::Point&>())
@@ -735,7 +833,8 @@ BOOST_PYTHON_MODULE(robocup) {
         .def("eval_pt_to_robot", &WinEval_eval_pt_to_robot)
         .def("eval_pt_to_opp_goal", &WinEval_eval_pt_to_opp_goal)
         .def("eval_pt_to_our_goal", &WinEval_eval_pt_to_our_goal)
-        .def("eval_pt_to_seg", &WinEval_eval_pt_to_seg);
+        .def("eval_pt_to_seg", &WinEval_eval_pt_to_seg)
+        .def("eval_pts_to_segs", &WinEval_eval_pts_to_segs);
 
     class_<std::shared_ptr<Configuration>>("Configuration")
         .def("FromRegisteredConfigurables",
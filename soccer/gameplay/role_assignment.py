@@ -1,8 +1,6 @@
-import munkres
 import evaluation.double_touch
 import robocup
 import logging
-import math
 
 # TODO arbitrary cost lambda property
 
@@ -137,22 +135,19 @@ def iterate_role_requirements_tree_leaves(reqs_tree):
 class ImpossibleAssignmentError(RuntimeError):
     pass
 
-# the munkres library doesn't like infinity, so we use this instead
+# the cost of an assignment that breaks a requirement
+# this must match Gameplay::RoleAssignment::MaxWeight in RoleAssignment.hpp,
+# which also has the other cost weights
 MaxWeight = 10000000
 
-# multiply this by the distance between two points to get the cost
-PositionCostMultiplier = 1.0
-
-# how much penalty is there for switching robots mid-play
-RobotChangeCost = 1.0
-
 # a default weight for preferring a chipper
 # this is tunable
 PreferChipper = 2.5
 
 
-# uses the munkres/hungarian algorithm to find the optimal role assignments
+# uses the hungarian algorithm to find the optimal role assignments
 # works by building a cost matrix for reach robot, role pair, then choosing the assignments to minimize total cost
+# the cost matrix and the solution are computed in C++ by robocup.assign_roles()
 # If no restraint-satisfying mass assignment exists, throws an ImpossibleAssignmentError
 #
 # role_reqs is a tree structure containing RoleRequirements
@@ -215,47 +210,10 @@ def assign_roles(robots, role_reqs):
     if len(robots) == 0:
         return {}
 
-    # build the cost matrix
-    cost_matrix = []
-    for robot in robots:
-        cost_row = []
-        for req in role_reqs_list:
-            cost = 0
-
-            if req.required_shell_id != None and req.required_shell_id != robot.shell_id(
-            ):
-                cost = MaxWeight
-            elif req.has_ball == True and robot.has_ball() == False:
-                cost = MaxWeight
-            elif req.require_kicking and (
-                    robot.shell_id() ==
-                    evaluation.double_touch.tracker().forbidden_ball_toucher()
-                    or not robot.kicker_works() or
-                    not robot.ball_sense_works()):
-                cost = MaxWeight
-            else:
-                if req.destination_shape != None:
-                    cost += PositionCostMultiplier * req.destination_shape.dist_to(
-                        robot.pos)
-                if req.previous_shell_id != None and req.previous_shell_id != robot.shell_id(
-                ):
-                    cost += RobotChangeCost
-                if not robot.has_chipper():
-                    cost += req.chipper_preference_weight
-
-            # the munkres library freezes when given NaN values, causing our
-            # whole program to hang and have to be restarted.  We check for it
-            # here and raise an exception if there's a NaN.
-            if (math.isnan(cost)):
-                raise ArithmeticError(
-                    "NaN value encountered when building role assignment cost matrix")
-
-            cost_row.append(cost)
-        cost_matrix.append(cost_row)
-
-    # solve
-    solver = munkres.Munkres()
-    indexes = solver.compute(cost_matrix)
+    # build the cost matrix and solve
+    assignment, total = robocup.assign_roles(
+        list(robots), role_reqs_list,
+        evaluation.double_touch.tracker().forbidden_ball_toucher())
 
     results = {}
 
@@ -270,10 +228,9 @@ def assign_roles(robots, role_reqs):
         parent[tree_path[-1]] = (role_reqs, robot)
 
     # build assignments mapping
-    assignments = {}
-    total = 0
-    for row, col in indexes:
-        total += cost_matrix[row][col]
+    for row, col in enumerate(assignment):
+        if col < 0:
+            continue
 
         bot = robots[row]
         reqs = role_reqs_list[col]
@@ -7,6 +7,7 @@
 #include <fcntl.h>
 #include <assert.h>
 #include <signal.h>
+#include <fstream>
 
 #include <QApplication>
 #include <QFile>
@@ -36,7 +37,16 @@ void usage(const char* prog) {
     fprintf(stderr, "\t-sim:        use simulator\n");
     fprintf(stderr, "\t-freq:       specify radio frequency (906 or 904)\n");
     fprintf(stderr, "\t-nolog:      don't write log files\n");
+    fprintf(stderr,
+            "\t-logblock:   wait for the log writer instead of dropping "
+            "frames when it falls behind\n");
     fprintf(stderr, "\t-noref:      don't use external referee commands\n");
+    fprintf(stderr,
+            "\t-profile <file>: write processing loop timing to a file as "
+            "JSON on exit\n");
+    fprintf(stderr,
+            "\t-pipeline:   run plays on their own thread, one frame behind "
+            "planning and motion control\n");
     exit(1);
 }
 
@@ -65,9 +75,12 @@ int main(int argc, char* argv[]) {
     vector<const char*> playDirs;
     bool sim = false;
     bool log = true;
+    bool logBlock = false;
     QString radioFreq;
     string playbookFile;
     bool noref = false;
+    QString profileFile;
+    bool pipeline = false;
 
     for (int i = 1; i < argc; ++i) {
         const char* var = argv[i];
@@ -82,6 +95,8 @@ int main(int argc, char* argv[]) {
             sim = true;
         } else if (strcmp(var, "-nolog") == 0) {
             log = false;
+        } else if (strcmp(var, "-logblock") == 0) {
+            logBlock = true;
         } else if (strcmp(var, "-freq") == 0) {
             if (i + 1 >= argc) {
                 printf("No radio frequency specified after -freq\n");
@@ -115,6 +130,15 @@ int main(int argc, char* argv[]) {
             playbookFile = argv[++i];
         } else if (strcmp(var, "-noref") == 0) {
             noref = true;
+        } else if (strcmp(var, "-profile") == 0) {
+            if (i + 1 >= argc) {
+                printf("no file specified after -profile\n");
+                usage(argv[0]);
+            }
+
+            profileFile = argv[++i];
+        } else if (strcmp(var, "-pipeline") == 0) {
+            pipeline = true;
         } else {
             printf("Not a valid flag: %s\n", argv[i]);
             usage(argv[0]);
@@ -138,6 +162,10 @@ int main(int argc, char* argv[]) {
     Processor* processor = new Processor(sim);
     processor->blueTeam(blueTeam);
     processor->refereeModule()->useExternalReferee(!noref);
+    if (logBlock) {
+        processor->logOverrunPolicy(Logger::BlockProducer);
+    }
+    processor->gameplayModule()->pipelined(pipeline);
 
     // Load config file
     QString error;
@@ -191,6 +219,11 @@ int main(int argc, char* argv[]) {
     int ret = app.exec();
     processor->stop();
 
+    if (!profileFile.isEmpty()) {
+        ofstream out(profileFile.toStdString());
+        processor->profiler().dump(out);
+    }
+
     delete win;
     delete processor;
 
@@ -4,37 +4,55 @@
 #include <SystemState.hpp>
 
 #include <stdio.h>
+#include <algorithm>
 
 using namespace Geometry2d;
 
-static const float Velocity_Alpha = 0.2;
+// Standard deviation of vision's measurements, in meters
+static const double Position_Noise = 0.01;
 
-BallFilter::BallFilter() {}
+// Spectral density of the unknown accelerations, in m^2/s^3
+static const double Acceleration_Noise = 5;
 
-void BallFilter::update(const BallObservation* obs) {
-    if (_estimate.time) {
-        float dtime = (obs->time - _estimate.time) / 1000000.0f;
-        Point newVel = (obs->pos - _estimate.pos) / dtime;
-        _estimate.vel =
-            newVel * Velocity_Alpha + _estimate.vel * (1.0f - Velocity_Alpha);
-        _estimate.valid = true;
+// Variance of the velocity when the ball is first seen, in (m/s)^2
+static const double Initial_Velocity_Variance = 4;
+
+BallFilter::BallFilter() : _history(Replay_History_Size, Replay_Window) {}
+
+bool BallFilter::update(const BallObservation* obs) {
+    return _history.add(_state, *obs, apply);
+}
+
+void BallFilter::apply(State& state, const BallObservation& obs) {
+    Eigen::Vector2d pos(obs.pos.x, obs.pos.y);
+
+    if (state.time) {
+        double dtime = ((int64_t)(obs.time - state.time)) / 1000000.0;
+        if (dtime > 0) {
+            state.kalman.predict(dtime, Acceleration_Noise);
+        }
+        state.kalman.update(pos, Position_Noise * Position_Noise);
     } else {
-        _estimate.vel = Point();
+        state.kalman.reset(pos, Position_Noise * Position_Noise,
+                           Initial_Velocity_Variance);
     }
 
-    _estimate.pos = obs->pos;
-    _estimate.time = obs->time;
+    state.time = std::max(state.time, obs.time);
 }
 
 void BallFilter::predict(RJ::Time time, Ball* out, float* velocityUncertainty) {
+    const ConstantVelocityKalman<2>& kalman = _state.kalman;
+    Point vel(kalman.vel().x(), kalman.vel().y());
+
     if (velocityUncertainty) {
-        *velocityUncertainty = 2 + _estimate.vel.mag() * 0.5;
+        *velocityUncertainty = 2 + vel.mag() * 0.5;
     }
 
     if (out) {
-        out->pos = _estimate.pos +
-                   _estimate.vel * (time - _estimate.time) / 1000000.0f;
-        out->vel = _estimate.vel;
+        double dtime = ((int64_t)(time - _state.time)) / 1000000.0;
+        Eigen::Vector2d pos = kalman.predictedPos(dtime);
+        out->pos = Point(pos.x(), pos.y());
+        out->vel = vel;
         out->time = time;
         out->valid = true;
     }
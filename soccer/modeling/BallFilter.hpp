@@ -1,24 +1,47 @@
 #pragma once
 
 #include <SystemState.hpp>
+#include "BallTracker.hpp"
+#include "KalmanFilter.hpp"
+#include "ReplayBuffer.hpp"
 
 #include <stdint.h>
 
 class Ball;
-class BallObservation;
 
 // A BallFilter never needs to reset itself.  The BallTracker will
 // create a new one when a new ball is found.
+//
+// The ball is tracked by a constant-velocity Kalman filter.  Observations
+// may come from any camera and are applied in order of capture time: a late
+// one rewinds the filter and replays the newer ones (see ReplayBuffer).
 class BallFilter {
 public:
     BallFilter();
 
-    // Gives a new observation to the filter
-    void update(const BallObservation* obs);
+    // Gives a new observation to the filter.  Returns false if it was too old
+    // to use.
+    bool update(const BallObservation* obs);
 
     // Generates a prediction of the ball's state at a given time in the future
     void predict(RJ::Time time, Ball* out, float* velocityUncertainty);
 
+    // Number of observations that were applied out of order
+    int replays() const { return _history.replays(); }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
 private:
-    Ball _estimate;
+    struct State {
+        ConstantVelocityKalman<2> kalman;
+
+        /// Capture time of the last observation, or zero if there hasn't
+        /// been one
+        RJ::Time time = 0;
+    };
+
+    static void apply(State& state, const BallObservation& obs);
+
+    State _state;
+    ReplayBuffer<State, BallObservation> _history;
 };
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "BallFilter.hpp"
+
+#include <vector>
+
+using namespace Geometry2d;
+using namespace std;
+
+// 60Hz per camera
+static const RJ::Time Frame_Period = 1000000 / 60;
+
+TEST(BallFilter, lateFramesAreReplayed) {
+    // A rolling ball seen by two cameras whose frames are captured half a
+    // period apart.  observations[i] holds what each camera saw in frame i.
+    const int frames = 30;
+    vector<BallObservation> observations[frames];
+    for (int i = 0; i < frames; ++i) {
+        for (int camera = 0; camera < 2; ++camera) {
+            RJ::Time time =
+                1000000 + i * Frame_Period + camera * Frame_Period / 2;
+            float dt = (time - 1000000) / 1000000.0f;
+            observations[i].push_back(BallObservation(
+                Point(2 * dt, 1 - dt + camera * 0.003), time));
+        }
+    }
+
+    BallFilter inOrder;
+    for (const auto& frame : observations) {
+        for (const BallObservation& obs : frame) {
+            EXPECT_TRUE(inOrder.update(&obs));
+        }
+    }
+    EXPECT_EQ(0, inOrder.replays());
+
+    // The second camera's frames arrive with the next batch, after the first
+    // camera's newer frame has already been applied
+    BallFilter late;
+    for (int i = 0; i < frames; ++i) {
+        EXPECT_TRUE(late.update(&observations[i][0]));
+        if (i > 0) {
+            EXPECT_TRUE(late.update(&observations[i - 1][1]));
+        }
+    }
+    EXPECT_TRUE(late.update(&observations[frames - 1][1]));
+    EXPECT_EQ(frames - 1, late.replays());
+
+    RJ::Time time = observations[frames - 1][1].time;
+    Ball expected, actual;
+    inOrder.predict(time, &expected, nullptr);
+    late.predict(time, &actual, nullptr);
+    EXPECT_TRUE(actual.valid);
+    EXPECT_NEAR(expected.pos.x, actual.pos.x, 1e-6);
+    EXPECT_NEAR(expected.pos.y, actual.pos.y, 1e-6);
+    EXPECT_NEAR(expected.vel.x, actual.vel.x, 1e-4);
+    EXPECT_NEAR(expected.vel.y, actual.vel.y, 1e-4);
+
+    // Too old to rewind to, so it's dropped
+    BallObservation old(Point(5, 5), time - Replay_Window - Frame_Period);
+    EXPECT_FALSE(late.update(&old));
+    late.predict(time, &actual, nullptr);
+    EXPECT_NEAR(expected.pos.x, actual.pos.x, 1e-6);
+    EXPECT_EQ(frames - 1, late.replays());
+}
@@ -89,7 +89,7 @@ void BallTracker::run(const vector<BallObservation>& obs, SystemState* state) {
 	}
 #endif
 
-    RJ::Time now = RJ::timestamp();
+    RJ::Time now = state->clock->now();
 
     // FIXME - What time?
     RJ::Time predictTime = now;
@@ -114,31 +114,57 @@ void BallTracker::run(const vector<BallObservation>& obs, SystemState* state) {
             velocityUncertainty * (predictTime - _lastTrackTime) / 1000000.0f;
         state->drawCircle(windowCenter, windowRadius, Qt::white);
 
-        // Find the closest new observation to the real ball's predicted
-        // position
-        float bestDist = -1;
-        unsigned int best = 0;
-        for (unsigned int i = 0; i < goodObs.size(); ++i) {
-            float d = goodObs[i]->pos.distTo(windowCenter);
-            if (goodObs[i]->time > _lastTrackTime && d <= windowRadius &&
-                (bestDist < 0 || d < bestDist)) {
-                bestDist = d;
-                best = i;
+        // Each camera that sees the ball gives the filter an observation.
+        // Observations are in order of capture time and those from one
+        // detection frame share a time, so take the closest observation to
+        // the prediction from each group.  A frame that arrived late is
+        // still used if the filter can replay it.
+        bool updated = false;
+        vector<bool> used(goodObs.size(), false);
+        for (unsigned int start = 0; start < goodObs.size();) {
+            RJ::Time time = goodObs[start]->time;
+            unsigned int end = start + 1;
+            while (end < goodObs.size() && goodObs[end]->time == time) {
+                ++end;
             }
-        }
 
-        if (bestDist >= 0) {
-            // Update the filter
-            _ballFilter->update(goodObs[best]);
-            _lastTrackTime = goodObs[best]->time;
+            _ballFilter->predict(time, &prediction, &velocityUncertainty);
+            float age = time > _lastTrackTime
+                            ? (time - _lastTrackTime) / 1000000.0f
+                            : 0;
+            float radius = Position_Uncertainty + velocityUncertainty * age;
+
+            float bestDist = -1;
+            unsigned int best = 0;
+            for (unsigned int i = start; i < end; ++i) {
+                float d = goodObs[i]->pos.distTo(prediction.pos);
+                if (d <= radius && (bestDist < 0 || d < bestDist)) {
+                    bestDist = d;
+                    best = i;
+                }
+            }
 
+            if (bestDist >= 0 && _ballFilter->update(goodObs[best])) {
+                _lastTrackTime = std::max(_lastTrackTime, time);
+                used[best] = true;
+                updated = true;
+            }
+
+            start = end;
+        }
+
+        if (updated) {
             // Update the real track
             _ballFilter->predict(state->logFrame->command_time(), &state->ball,
                                  nullptr);
 
-            // Don't use this observation for a possible track since it's the
-            // real track
-            fastRemove(goodObs, best);
+            // Don't use these observations for possible tracks since they're
+            // the real track
+            for (int i = goodObs.size() - 1; i >= 0; --i) {
+                if (used[i]) {
+                    fastRemove(goodObs, i);
+                }
+            }
         }
 
         // If we haven't found an update in a long time, drop the real ball
@@ -199,7 +225,9 @@ void BallTracker::run(const vector<BallObservation>& obs, SystemState* state) {
         for (unsigned int i = 0; i < _possibleTracks.size(); ++i) {
             if (_possibleTracks[i].current &&
                 _possibleTracks[i].numFrames >= 3) {
-                _ballFilter = std::make_shared<BallFilter>();
+                // Not make_shared, which would skip BallFilter's aligned
+                // operator new
+                _ballFilter = std::shared_ptr<BallFilter>(new BallFilter());
 
                 // First update and prediction
                 _ballFilter->update(&_possibleTracks[i].obs);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Kalman filter for motion at a constant velocity along one or more
+ * axes
+ *
+ * @details Each axis has a position and a velocity, and only positions are
+ * measured.  The velocity changes by white noise acceleration whose spectral
+ * density is given to predict(), in m^2/s^3 (or rad^2/s^3 for angles).
+ *
+ * All axes follow the same model and are measured together, so they share one
+ * 2x2 covariance of (position, velocity).  This is exactly what a full filter
+ * with a block-diagonal covariance would compute, but each step costs only a
+ * few multiplies per axis.  Everything is fixed-size, so nothing is allocated
+ * and copying the filter is a cheap snapshot of its state.
+ */
+template <int Axes>
+class ConstantVelocityKalman {
+public:
+    typedef Eigen::Matrix<double, Axes, 1> Vector;
+
+    ConstantVelocityKalman() { reset(Vector::Zero(), 0, 0); }
+
+    /// Starts at @pos, not moving, with the given variances
+    void reset(const Vector& pos, double posVariance, double velVariance) {
+        _pos = pos;
+        _vel.setZero();
+        _cov << posVariance, 0, 0, velVariance;
+    }
+
+    /// Moves the estimate forward by @dt seconds
+    void predict(double dt, double processNoise) {
+        _pos += _vel * dt;
+
+        Eigen::Matrix2d f;
+        f << 1, dt, 0, 1;
+
+        Eigen::Matrix2d q;
+        q << dt * dt * dt / 3, dt * dt / 2, dt * dt / 2, dt;
+
+        _cov = f * _cov * f.transpose() + q * processNoise;
+    }
+
+    /// Corrects the estimate with a measured position
+    void update(const Vector& measured, double measurementVariance) {
+        // The measurement only sees position, so the gain for each axis is
+        // the first column of the covariance over the innovation variance
+        Eigen::Vector2d gain =
+            _cov.col(0) / (_cov(0, 0) + measurementVariance);
+
+        Vector innovation = measured - _pos;
+        _pos += gain(0) * innovation;
+        _vel += gain(1) * innovation;
+
+        _cov -= gain * _cov.row(0);
+    }
+
+    /// Position after @dt more seconds, without changing the estimate
+    Vector predictedPos(double dt) const { return _pos + _vel * dt; }
+
+    const Vector& pos() const { return _pos; }
+    const Vector& vel() const { return _vel; }
+
+    /// Sets the position without changing the velocity or covariance, such
+    /// as to wrap an angle
+    void setPos(const Vector& pos) { _pos = pos; }
+
+    /// Covariance of (position, velocity) on each axis
+    const Eigen::Matrix2d& covariance() const { return _cov; }
+
+private:
+    Vector _pos;
+    Vector _vel;
+    Eigen::Matrix2d _cov;
+};
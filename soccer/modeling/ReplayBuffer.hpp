@@ -0,0 +1,101 @@
+#pragma once
+
+#include <time.hpp>
+
+#include <Eigen/Core>
+#include <boost/circular_buffer.hpp>
+
+/// How far back a late observation may be and still be applied by the
+/// vision filters
+static const RJ::Time Replay_Window = 100000;
+
+/// Entries each vision filter keeps, enough for four cameras over the
+/// replay window
+static const int Replay_History_Size = 32;
+
+/**
+ * @brief Recent observations given to a filter, so that one that arrives late
+ * can still be applied in order of capture time
+ *
+ * @details Each entry holds an observation and a copy of the filter's state
+ * from just before it was applied.  An observation that is newer than all of
+ * them is simply applied.  One that is older rewinds the state to the
+ * snapshot where it belongs, is applied there, and then the newer
+ * observations are replayed on top.  The estimate ends up the same as if
+ * everything had arrived in order, without holding back observations to wait
+ * for slow cameras.
+ *
+ * Entries more than @window older than the newest one are forgotten, as is
+ * the oldest entry when the buffer is full.  An observation older than every
+ * remaining entry has no snapshot to rewind to and is dropped.
+ *
+ * Observation must have a @time member.  States are copied on every
+ * observation, so they should be small and fixed-size.  They may hold
+ * fixed-size Eigen types: entries are allocated with Eigen's aligned
+ * allocator.  Nothing is allocated after construction.
+ */
+template <class State, class Observation>
+class ReplayBuffer {
+public:
+    ReplayBuffer(int capacity, RJ::Time window)
+        : _entries(capacity), _window(window) {}
+
+    /// Applies @obs to @state by calling apply(State&, const Observation&),
+    /// replaying any newer observations after it.  Returns false if @obs was
+    /// too old to use.
+    template <class Apply>
+    bool add(State& state, const Observation& obs, Apply apply) {
+        // Find where this observation belongs
+        int index = _entries.size();
+        while (index > 0 && obs.time < _entries[index - 1].obs.time) {
+            --index;
+        }
+
+        if (index == (int)_entries.size()) {
+            // In order
+            _entries.push_back(Entry{state, obs});
+            apply(state, obs);
+        } else if (index == 0) {
+            return false;
+        } else {
+            // Rewind to just before this observation, then replay from it
+            state = _entries[index].before;
+            if (_entries.full()) {
+                // Inserting will drop the oldest entry
+                _entries.pop_front();
+                --index;
+            }
+            _entries.insert(_entries.begin() + index, Entry{state, obs});
+            for (int i = index; i < (int)_entries.size(); ++i) {
+                _entries[i].before = state;
+                apply(state, _entries[i].obs);
+            }
+            ++_replays;
+        }
+
+        // Forget entries too old to be rewound to
+        RJ::Time newest = _entries.back().obs.time;
+        while (newest - _entries.front().obs.time > _window) {
+            _entries.pop_front();
+        }
+
+        return true;
+    }
+
+    void clear() { _entries.clear(); }
+
+    int size() const { return _entries.size(); }
+
+    /// Number of observations that have been applied out of order
+    int replays() const { return _replays; }
+
+private:
+    struct Entry {
+        State before;
+        Observation obs;
+    };
+
+    boost::circular_buffer<Entry, Eigen::aligned_allocator<Entry>> _entries;
+    RJ::Time _window;
+    int _replays = 0;
+};
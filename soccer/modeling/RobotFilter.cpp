@@ -1,66 +1,74 @@
 #include "RobotFilter.hpp"
 #include <Utils.hpp>
+#include <algorithm>
 #include <iostream>
 
 using namespace Geometry2d;
 
 // How long to coast a robot's position when it isn't visible
 static const float Coast_Time = 0.8;
-static const float Velocity_Alpha = 0.2;
-static const float Min_Frame_Time = 0.014;
 
-RobotFilter::RobotFilter() { _camera = -1; }
+// Standard deviation of vision's measurements
+static const double Position_Noise = 0.01;  // m
+static const double Angle_Noise = 0.03;     // rad
+
+// Spectral density of the unknown accelerations
+static const double Acceleration_Noise = 2;            // m^2/s^3
+static const double Angular_Acceleration_Noise = 50;   // rad^2/s^3
+
+// Variance of the velocities when a robot is first seen
+static const double Initial_Velocity_Variance = 4;           // (m/s)^2
+static const double Initial_Angular_Velocity_Variance = 100;  // (rad/s)^2
+
+RobotFilter::RobotFilter() : _history(Replay_History_Size, Replay_Window) {}
 
 void RobotFilter::update(const RobotObservation* obs) {
-    if (obs->source < 0 || obs->source >= Num_Cameras) {
-        // Not from a camera?
-        return;
-    }
+    _history.add(_state, *obs, apply);
+}
 
-    int s = obs->source;
-    double dtime = (obs->time - _estimate[s].time) / 1000000.0f;
-    bool reset = _estimate[s].time == 0 || (dtime > Coast_Time);
+void RobotFilter::apply(State& state, const RobotObservation& obs) {
+    Eigen::Vector2d pos(obs.pos.x, obs.pos.y);
 
-    if (reset || dtime < Min_Frame_Time) {
-        _estimate[s].vel = Point();
-        _estimate[s].angleVel = 0;
+    double dtime = ((int64_t)(obs.time - state.time)) / 1000000.0;
+    if (state.time == 0 || dtime > Coast_Time) {
+        state.pos.reset(pos, Position_Noise * Position_Noise,
+                        Initial_Velocity_Variance);
+        state.angle.reset(Eigen::Matrix<double, 1, 1>(obs.angle),
+                          Angle_Noise * Angle_Noise,
+                          Initial_Angular_Velocity_Variance);
     } else {
-        Point newVel = (obs->pos - _estimate[s].pos) / dtime;
-        _estimate[s].vel = newVel * Velocity_Alpha +
-                           _estimate[s].vel * (1.0f - Velocity_Alpha);
+        if (dtime > 0) {
+            state.pos.predict(dtime, Acceleration_Noise);
+            state.angle.predict(dtime, Angular_Acceleration_Noise);
+        }
 
-        double newW = fixAngleRadians(obs->angle - _estimate[s].angle) / dtime;
-        _estimate[s].angleVel = newW * Velocity_Alpha +
-                                _estimate[s].angleVel * (1.0f - Velocity_Alpha);
+        state.pos.update(pos, Position_Noise * Position_Noise);
+
+        // Measure the angle relative to the estimate so the innovation is
+        // never more than half a turn
+        double angle = state.angle.pos()(0);
+        double measured = angle + fixAngleRadians(obs.angle - angle);
+        state.angle.update(Eigen::Matrix<double, 1, 1>(measured),
+                           Angle_Noise * Angle_Noise);
+        state.angle.setPos(Eigen::Matrix<double, 1, 1>(
+            fixAngleRadians(state.angle.pos()(0))));
     }
-    _estimate[s].pos = obs->pos;
-    _estimate[s].angle = obs->angle;
-    _estimate[s].visible = true;
-    _estimate[s].time = obs->time;
-    _estimate[s].visionFrame = obs->frameNumber;
+
+    state.time = std::max(state.time, obs.time);
 }
 
 void RobotFilter::predict(RJ::Time time, RobotPose* robot) {
-    int bestSource = -1;
-    double bestDTime = 0;
-    for (int s = 0; s < Num_Cameras; ++s) {
-        double dtime = (time - _estimate[s].time) / 1000000.0f;
-        if (_estimate[s].visible && (bestSource < 0 || dtime < bestDTime)) {
-            bestSource = s;
-            bestDTime = dtime;
-        }
-    }
-
-    if (bestSource < 0) {
+    if (_state.time == 0) {
         robot->visible = false;
         return;
     }
 
-    robot->pos =
-        _estimate[bestSource].pos + _estimate[bestSource].vel * bestDTime;
-    robot->vel = _estimate[bestSource].vel;
-    robot->angle = fixAngleRadians(_estimate[bestSource].angle +
-                                   _estimate[bestSource].angleVel * bestDTime);
-    robot->angleVel = _estimate[bestSource].angleVel;
-    robot->visible = _estimate[bestSource].visible && bestDTime < Coast_Time;
+    double dtime = ((int64_t)(time - _state.time)) / 1000000.0;
+
+    Eigen::Vector2d pos = _state.pos.predictedPos(dtime);
+    robot->pos = Point(pos.x(), pos.y());
+    robot->vel = Point(_state.pos.vel().x(), _state.pos.vel().y());
+    robot->angle = fixAngleRadians(_state.angle.predictedPos(dtime)(0));
+    robot->angleVel = _state.angle.vel()(0);
+    robot->visible = dtime < Coast_Time;
 }
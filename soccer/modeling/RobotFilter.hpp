@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Robot.hpp>
+#include "KalmanFilter.hpp"
+#include "ReplayBuffer.hpp"
 
 /**
  * @brief An observation of a robot's position and angle at a certain time
@@ -28,7 +30,16 @@ public:
 };
 
 /**
- * adjusts robot vision for accuracy and calculates velocities from positions
+ * @brief Estimates a robot's position, angle, and velocities from the
+ * observations of every camera that sees it
+ *
+ * @details One constant-velocity Kalman filter tracks position and another
+ * tracks angle.  Observations from all cameras update the same estimate, so
+ * where cameras overlap each observation adds information instead of starting
+ * a separate track.
+ *
+ * Observations are applied in order of capture time.  One that arrives after
+ * newer ones rewinds the estimate and replays them (see ReplayBuffer).
  */
 class RobotFilter {
 public:
@@ -37,18 +48,28 @@ public:
     /// Gives a new observation to the filter
     void update(const RobotObservation* obs);
 
-    /// Generates a prediction of the ball's state at a given time in the
+    /// Generates a prediction of the robot's state at a given time in the
     /// future. This may clear robot->visible if the prediction is too long in
     /// the future to be reliable.
     void predict(RJ::Time time, RobotPose* robot);
 
+    /// Number of observations that were applied out of order
+    int replays() const { return _history.replays(); }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
 private:
-    static const int Num_Cameras = 4;
+    struct State {
+        ConstantVelocityKalman<2> pos;
+        ConstantVelocityKalman<1> angle;
+
+        /// Capture time of the last observation, or zero if there hasn't
+        /// been one
+        RJ::Time time = 0;
+    };
 
-    /// Estimate for each camera
-    RobotPose _estimate[Num_Cameras];
+    static void apply(State& state, const RobotObservation& obs);
 
-    /// Which camera we are using to track this robot, or -1 if it has not been
-    /// seen recently
-    int _camera;
+    State _state;
+    ReplayBuffer<State, RobotObservation> _history;
 };
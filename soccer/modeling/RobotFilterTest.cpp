@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "RobotFilter.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Geometry2d;
+using namespace std;
+
+// 60Hz per camera
+static const RJ::Time Frame_Period = 1000000 / 60;
+
+TEST(RobotFilter, fusesCameras) {
+    std::mt19937 gen(1);
+    std::normal_distribution<float> noise(0, 0.005);
+
+    // A robot moving at constant velocity and turning, seen by two cameras
+    // whose frames are captured half a period apart
+    const Point start(-1, 2);
+    const Point vel(1.5, -0.5);
+    const float w = 2;
+    RobotFilter filter;
+
+    // RMS errors over the second half, predicting a little past each
+    // observation as for command_time
+    double posError = 0, velError = 0, angleError = 0, wError = 0;
+    int n = 0;
+
+    const RJ::Time t0 = 1000000;
+    RJ::Time time = t0;
+    for (int i = 0; i < 120; ++i) {
+        for (int camera = 0; camera < 2; ++camera) {
+            time = t0 + i * Frame_Period + camera * Frame_Period / 2;
+            float dt = (time - t0) / 1000000.0f;
+            RobotObservation obs(
+                start + vel * dt + Point(noise(gen), noise(gen)),
+                fixAngleRadians(w * dt + noise(gen) * 4), time, i);
+            obs.source = camera;
+            filter.update(&obs);
+
+            if (i >= 60) {
+                RJ::Time commandTime = time + 30000;
+                float ct = (commandTime - t0) / 1000000.0f;
+                RobotPose pose;
+                filter.predict(commandTime, &pose);
+                EXPECT_TRUE(pose.visible);
+                posError += (pose.pos - (start + vel * ct)).magsq();
+                velError += (pose.vel - vel).magsq();
+                angleError += pow(fixAngleRadians(pose.angle - w * ct), 2);
+                wError += pow(pose.angleVel - w, 2);
+                ++n;
+            }
+        }
+    }
+
+    EXPECT_LT(sqrt(posError / n), 0.01);
+    EXPECT_LT(sqrt(velError / n), 0.15);
+    EXPECT_LT(sqrt(angleError / n), 0.04);
+    EXPECT_LT(sqrt(wError / n), 0.7);
+
+    // Coasting too long hides the robot
+    RobotPose pose;
+    filter.predict(time + 1000000, &pose);
+    EXPECT_FALSE(pose.visible);
+}
+
+TEST(RobotFilter, angleWraps) {
+    RobotFilter filter;
+    for (int i = 0; i < 60; ++i) {
+        // Turning steadily through +/-pi
+        float angle = fixAngleRadians(M_PI - 0.5 + i * 0.02);
+        RobotObservation obs(Point(), angle, 1000000 + i * Frame_Period, i);
+        obs.source = 0;
+        filter.update(&obs);
+    }
+
+    RobotPose pose;
+    filter.predict(1000000 + 59 * Frame_Period, &pose);
+    EXPECT_NEAR(0.02 * 60, pose.angleVel, 0.1);
+    EXPECT_NEAR(0, fixAngleRadians(pose.angle - (M_PI - 0.5 + 59 * 0.02)),
+                0.01);
+}
+
+TEST(RobotFilter, lateObservationsAreReplayed) {
+    // The same observations from two cameras, given in order to one filter
+    // and with the second camera a frame late to the other
+    vector<RobotObservation> observations;
+    for (int i = 0; i < 30; ++i) {
+        for (int camera = 0; camera < 2; ++camera) {
+            RJ::Time time =
+                1000000 + i * Frame_Period + camera * Frame_Period / 2;
+            float dt = i / 60.0f;
+            RobotObservation obs(Point(dt, -dt + camera * 0.003), dt * 2,
+                                 time, i);
+            obs.source = camera;
+            observations.push_back(obs);
+        }
+    }
+
+    RobotFilter inOrder;
+    for (const RobotObservation& obs : observations) {
+        inOrder.update(&obs);
+    }
+    EXPECT_EQ(0, inOrder.replays());
+
+    RobotFilter late;
+    for (unsigned int i = 0; i < observations.size(); i += 2) {
+        late.update(&observations[i]);
+        if (i >= 2) {
+            late.update(&observations[i - 1]);
+        }
+    }
+    late.update(&observations.back());
+    EXPECT_EQ(29, late.replays());
+
+    RJ::Time time = observations.back().time;
+    RobotPose expected, actual;
+    inOrder.predict(time, &expected);
+    late.predict(time, &actual);
+    EXPECT_NEAR(expected.pos.x, actual.pos.x, 1e-6);
+    EXPECT_NEAR(expected.pos.y, actual.pos.y, 1e-6);
+    EXPECT_NEAR(expected.vel.x, actual.vel.x, 1e-4);
+    EXPECT_NEAR(expected.vel.y, actual.vel.y, 1e-4);
+    EXPECT_NEAR(expected.angle, actual.angle, 1e-6);
+    EXPECT_NEAR(expected.angleVel, actual.angleVel, 1e-4);
+
+    // Too old to rewind to, so it's dropped
+    RobotObservation old(Point(5, 5), 0,
+                         time - Replay_Window - Frame_Period, 0);
+    old.source = 0;
+    late.update(&old);
+    late.predict(time, &actual);
+    EXPECT_NEAR(expected.pos.x, actual.pos.x, 1e-6);
+    EXPECT_EQ(29, late.replays());
+}
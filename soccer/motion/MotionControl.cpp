@@ -56,12 +56,14 @@ void MotionControl::run() {
     _angleController.kd = *_robot->config->rotation.d;
 
     float timeIntoPath =
-        RJ::TimestampToSecs(RJ::timestamp() - _robot->path().startTime()) +
+        RJ::TimestampToSecs(_robot->state()->clock->now() -
+                            _robot->path().startTime()) +
         1.0 / 60.0;
 
-    // evaluate path - where should we be right now?
-    boost::optional<RobotInstant> optTarget =
-        _robot->path().evaluate(timeIntoPath);
+    // evaluate path - where should we be right now, and one frame from now?
+    vector<boost::optional<RobotInstant>> targets =
+        _robot->path().evaluate({timeIntoPath, timeIntoPath + 1.0f / 60.0f});
+    boost::optional<RobotInstant> optTarget = targets[0];
 
     if (!optTarget) {
         optTarget = _robot->path().end();
@@ -148,8 +150,7 @@ void MotionControl::run() {
 
     // acceleration factor
     Point acceleration;
-    boost::optional<RobotInstant> nextTarget =
-        _robot->path().evaluate(timeIntoPath + 1.0 / 60.0);
+    const boost::optional<RobotInstant>& nextTarget = targets[1];
     if (nextTarget) {
         acceleration = (nextTarget->motion.vel - target.vel) / 60.0f;
     } else {
@@ -201,6 +202,8 @@ void MotionControl::_targetAngleVel(float angleVel) {
 }
 
 void MotionControl::_targetBodyVel(Point targetVel) {
+    const RJ::Time now = _robot->state()->clock->now();
+
     // Limit Velocity
     targetVel.clamp(*_max_velocity);
 
@@ -208,7 +211,7 @@ void MotionControl::_targetBodyVel(Point targetVel) {
     if (_lastCmdTime == -1) {
         targetVel.clamp(*_max_acceleration);
     } else {
-        float dt = (float)((RJ::timestamp() - _lastCmdTime) / 1000000.0f);
+        float dt = (float)((now - _lastCmdTime) / 1000000.0f);
         Point targetAccel = (targetVel - _lastVelCmd) / dt;
         targetAccel.clamp(*_max_acceleration);
 
@@ -222,7 +225,7 @@ void MotionControl::_targetBodyVel(Point targetVel) {
 
     // track these values so we can limit acceleration
     _lastVelCmd = targetVel;
-    _lastCmdTime = RJ::timestamp();
+    _lastCmdTime = now;
 
     // velocity multiplier
     targetVel *= *_robot->config->velMultiplier;
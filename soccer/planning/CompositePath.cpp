@@ -5,7 +5,10 @@ using namespace Geometry2d;
 
 namespace Planning {
 
-CompositePath::CompositePath(unique_ptr<Path> path) { append(std::move(path)); }
+CompositePath::CompositePath(unique_ptr<Path> path)
+    : Path(path->startTime()) {
+    append(std::move(path));
+}
 
 void CompositePath::append(unique_ptr<Path> path) {
     if (duration < numeric_limits<float>::infinity()) {
@@ -147,12 +150,19 @@ unique_ptr<Path> CompositePath::subPath(float startTime, float endTime) const {
     // If the path will only contain that one Path just return a subPath of that
     // Path
     if (time >= endTime) {
-        return paths[start - 1]->subPath(startTime - firstStartTime,
-                                         endTime - firstStartTime);
+        unique_ptr<Path> path = paths[start - 1]->subPath(
+            startTime - firstStartTime, endTime - firstStartTime);
+        if (path) {
+            path->setStartTime(this->startTime() +
+                               RJ::SecsToTimestamp(startTime));
+        }
+        return path;
     } else {
         // Create a CompositePath initialized with only that first path.
         CompositePath* path = new CompositePath(
             paths[start - 1]->subPath(startTime - firstStartTime));
+        path->setStartTime(this->startTime() +
+                           RJ::SecsToTimestamp(startTime));
         unique_ptr<Path> lastPath;
         size_t end;
 
@@ -187,6 +197,7 @@ unique_ptr<Path> CompositePath::subPath(float startTime, float endTime) const {
 
 unique_ptr<Path> CompositePath::clone() const {
     CompositePath* newPath = new CompositePath();
+    newPath->setStartTime(startTime());
     for (const unique_ptr<Path>& path : paths) {
         newPath->append(path->clone());
     }
@@ -34,6 +34,7 @@ public:
      */
     void append(std::unique_ptr<Path> path);
 
+    using Path::evaluate;
     virtual boost::optional<RobotInstant> evaluate(float t) const override;
     virtual bool hit(const Geometry2d::ShapeSet& shape, float& hitTime,
                      float startTime = 0) const override;
@@ -4,8 +4,8 @@
 namespace Planning {
 
 std::unique_ptr<Path> DirectTargetPathPlanner::run(
-    MotionInstant startInstant, const MotionCommand* cmd,
-    const MotionConstraints& motionConstraints,
+    MotionInstant startInstant, RJ::Time startTime,
+    const MotionCommand* cmd, const MotionConstraints& motionConstraints,
     const Geometry2d::ShapeSet* obstacles, std::unique_ptr<Path> prevPath) {
     assert(cmd->getCommandType() == Planning::MotionCommand::DirectPathTarget);
     Planning::DirectPathTargetCommand command =
@@ -18,7 +18,7 @@ std::unique_ptr<Path> DirectTargetPathPlanner::run(
         auto path = std::unique_ptr<Path>(
             new TrapezoidalPath(startInstant.pos, startInstant.vel.mag(),
                                 endTarget, endSpeed, motionConstraints));
-        path->setStartTime(RJ::timestamp());
+        path->setStartTime(startTime);
         return std::move(path);
     } else {
         return std::move(prevPath);
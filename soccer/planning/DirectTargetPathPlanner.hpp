@@ -15,8 +15,8 @@ public:
     }
 
     virtual std::unique_ptr<Path> run(
-        MotionInstant startInstant, const MotionCommand* cmd,
-        const MotionConstraints& motionConstraints,
+        MotionInstant startInstant, RJ::Time startTime,
+        const MotionCommand* cmd, const MotionConstraints& motionConstraints,
         const Geometry2d::ShapeSet* obstacles,
         std::unique_ptr<Path> prevPath = nullptr) override;
 
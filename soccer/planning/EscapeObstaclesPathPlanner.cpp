@@ -21,15 +21,15 @@ void EscapeObstaclesPathPlanner::createConfiguration(Configuration* cfg) {
 }
 
 std::unique_ptr<Path> EscapeObstaclesPathPlanner::run(
-    MotionInstant startInstant, const MotionCommand* cmd,
-    const MotionConstraints& motionConstraints, const ShapeSet* obstacles,
-    std::unique_ptr<Path> prevPath) {
+    MotionInstant startInstant, RJ::Time startTime,
+    const MotionCommand* cmd, const MotionConstraints& motionConstraints,
+    const ShapeSet* obstacles, std::unique_ptr<Path> prevPath) {
     assert(cmd->getCommandType() == MotionCommand::None);
 
     boost::optional<Point> optPrevPt;
     if (prevPath) optPrevPt = prevPath->end().motion.pos;
     const Point unblocked =
-        findNonBlockedGoal(startInstant.pos, optPrevPt, *obstacles);
+        findNonBlockedGoal(startInstant.pos, optPrevPt, *obstacles, _random);
 
     // reuse path if there's not a significantly better spot to target
     if (prevPath && unblocked == prevPath->end().motion.pos) {
@@ -44,13 +44,13 @@ std::unique_ptr<Path> EscapeObstaclesPathPlanner::run(
     auto path = std::unique_ptr<Path>(
         new TrapezoidalPath(startInstant.pos, motionConstraints.maxSpeed,
                             unblocked, 0, motionConstraints));
-    path->setStartTime(RJ::timestamp());
+    path->setStartTime(startTime);
     return std::move(path);
 }
 
 Point EscapeObstaclesPathPlanner::findNonBlockedGoal(
     Point goal, boost::optional<Point> prevGoal, const ShapeSet& obstacles,
-    int maxItr) {
+    std::mt19937& random, int maxItr) {
     if (obstacles.hit(goal)) {
         FixedStepTree goalTree;
         goalTree.init(goal, &obstacles);
@@ -61,11 +61,11 @@ Point EscapeObstaclesPathPlanner::findNonBlockedGoal(
         Point newGoal;
         for (int i = 0; i < maxItr; ++i) {
             // extend towards a random point
-            Tree::Point* newPoint = goalTree.extend(RandomFieldLocation());
+            int newPoint = goalTree.extend(RandomFieldLocation(random));
 
             // if the new point is not blocked, it becomes the new goal
-            if (newPoint && newPoint->hit.empty()) {
-                newGoal = newPoint->pos;
+            if (newPoint >= 0 && !goalTree.inObstacle(newPoint)) {
+                newGoal = goalTree.point(newPoint).pos;
                 break;
             }
         }
@@ -11,8 +11,8 @@ namespace Planning {
 class EscapeObstaclesPathPlanner : public SingleRobotPathPlanner {
 public:
     virtual std::unique_ptr<Path> run(
-        MotionInstant startInstant, const MotionCommand* cmd,
-        const MotionConstraints& motionConstraints,
+        MotionInstant startInstant, RJ::Time startTime,
+        const MotionCommand* cmd, const MotionConstraints& motionConstraints,
         const Geometry2d::ShapeSet* obstacles,
         std::unique_ptr<Path> prevPath = nullptr) override;
 
@@ -23,10 +23,12 @@ public:
 
     /// Uses an RRT to find a point near to @pt that isn't blocked by obstacles.
     /// If @prevPt is give, only uses a newly-found point if it is closer to @pt
-    /// by a configurable threshold.
+    /// by a configurable threshold.  Random points for the RRT are drawn from
+    /// @random.
     static Geometry2d::Point findNonBlockedGoal(
         Geometry2d::Point pt, boost::optional<Geometry2d::Point> prevPt,
-        const Geometry2d::ShapeSet& obstacles, int maxItr = 300);
+        const Geometry2d::ShapeSet& obstacles, std::mt19937& random,
+        int maxItr = 300);
 
     static void createConfiguration(Configuration* cfg);
 
@@ -19,7 +19,7 @@ TEST(EscapeObstaclesPathPlanner, run) {
 
     EscapeObstaclesPathPlanner planner;
     auto path =
-        planner.run(startInstant, &cmd, MotionConstraints(), &obstacles);
+        planner.run(startInstant, 0, &cmd, MotionConstraints(), &obstacles);
 
     ASSERT_NE(nullptr, path) << "Planner returned null path";
 
@@ -9,24 +9,33 @@ std::map<int, std::unique_ptr<Path>> IndependentMultiRobotPathPlanner::run(
     for (auto& entry : requests) {
         int shell = entry.first;
         PlanRequest& request = entry.second;
-        auto& prevPlanner = _planners[shell];
-
-        // Make sure we have the right planner.  If it changes from last time,
-        // delete the old path.
-        if (!prevPlanner ||
-            prevPlanner->commandType() !=
-                request.motionCommand->getCommandType()) {
-            _planners[shell] =
-                PlannerForCommandType(request.motionCommand->getCommandType());
-            request.prevPath = nullptr;
-        }
-
-        paths[shell] = _planners[shell]->run(
-            request.start, request.motionCommand.get(), request.constraints,
-            request.obstacles.get(), std::move(request.prevPath));
+        paths[shell] = runPlanner(plannerFor(shell, request), request);
     }
 
     return paths;
 }
 
+SingleRobotPathPlanner& IndependentMultiRobotPathPlanner::plannerFor(
+    int shell, PlanRequest& request) {
+    auto& prevPlanner = _planners[shell];
+
+    // Make sure we have the right planner.  If it changes from last time,
+    // delete the old path.
+    if (!prevPlanner ||
+        prevPlanner->commandType() != request.motionCommand->getCommandType()) {
+        prevPlanner =
+            PlannerForCommandType(request.motionCommand->getCommandType());
+        request.prevPath = nullptr;
+    }
+
+    return *prevPlanner;
+}
+
+std::unique_ptr<Path> IndependentMultiRobotPathPlanner::runPlanner(
+    SingleRobotPathPlanner& planner, PlanRequest& request) {
+    return planner.run(request.start, request.startTime,
+                       request.motionCommand.get(), request.constraints,
+                       request.obstacles.get(), std::move(request.prevPath));
+}
+
 }  // namespace Planning
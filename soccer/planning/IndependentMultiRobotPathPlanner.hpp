@@ -13,6 +13,16 @@ public:
     virtual std::map<int, std::unique_ptr<Path>> run(
         std::map<int, PlanRequest> requests) override;
 
+protected:
+    /// Returns the planner to use for @request, creating a new one if the
+    /// command type changed since the last run.  In that case the request's
+    /// previous path is discarded since it came from a different planner.
+    SingleRobotPathPlanner& plannerFor(int shell, PlanRequest& request);
+
+    /// Runs @planner on @request
+    static std::unique_ptr<Path> runPlanner(SingleRobotPathPlanner& planner,
+                                            PlanRequest& request);
+
 private:
     /// Map of shell id -> planner
     std::map<int, std::unique_ptr<SingleRobotPathPlanner>> _planners;
@@ -45,20 +45,16 @@ RobotInstant InterpolatedPath::end() const {
 
 // Returns the index of the point in this path nearest to pt.
 int InterpolatedPath::nearestIndex(Point pt) const {
-    if (waypoints.size() == 0) {
-        return -1;
-    }
-
-    int index = 0;
-    float dist = pt.distTo(waypoints[0].pos());
-
-    for (unsigned int i = 1; i < waypoints.size(); ++i) {
-        float d = pt.distTo(waypoints[i].pos());
-        if (d < dist) {
+    int index = -1;
+    float dist = 0;
+    forEachBlock([&](int first, int n, const float* x, const float* y) {
+        float d;
+        const int i = PointBuffer::nearestIndex(x, y, n, pt, &d);
+        if (index < 0 || d < dist) {
+            index = first + i;
             dist = d;
-            index = i;
         }
-    }
+    });
 
     return index;
 }
@@ -85,88 +81,65 @@ bool InterpolatedPath::hit(const ShapeSet& obstacles, float& hitTime,
         obstacles.hitSet(waypoints[start].pos());
 
     for (size_t i = start; i < waypoints.size() - 1; i++) {
-        std::set<std::shared_ptr<Shape>> newHitSet = obstacles.hitSet(
-            Segment(waypoints[i].pos(), waypoints[i + 1].pos()));
-        if (!newHitSet.empty()) {
-            for (std::shared_ptr<Shape> hit : newHitSet) {
-                // If it hits something, check if the hit was in the original
-                // hitSet
-                if (startHitSet.find(hit) == startHitSet.end()) {
-                    hitTime = waypoints[i].time;
-                    return true;
-                }
-            }
+        // If it hits something, check if the hit was in the original hitSet
+        if (obstacles.anyHit(
+                Segment(waypoints[i].pos(), waypoints[i + 1].pos()),
+                startHitSet)) {
+            hitTime = waypoints[i].time;
+            return true;
         }
     }
     return false;
 }
 
 float InterpolatedPath::distanceTo(Point pt) const {
-    int i = nearestIndex(pt);
-    if (i < 0) {
+    if (waypoints.empty()) {
         return 0;
     }
 
     float dist = -1;
-    for (unsigned int i = 0; i < (waypoints.size() - 1); ++i) {
-        Segment s(waypoints[i].pos(), waypoints[i + 1].pos());
-        const float d = s.distTo(pt);
-
-        if (dist < 0 || d < dist) {
-            dist = d;
-        }
-    }
-
+    nearestSegmentIndex(pt, &dist);
     return dist;
 }
 
 Segment InterpolatedPath::nearestSegment(Point pt) const {
-    Segment best;
-    float dist = -1;
-    if (waypoints.empty()) {
-        return best;
+    int i = nearestSegmentIndex(pt);
+    if (i < 0) {
+        return Segment();
     }
+    return Segment(waypoints[i].pos(), waypoints[i + 1].pos());
+}
 
-    for (unsigned int i = 0; i < (waypoints.size() - 1); ++i) {
-        Segment s(waypoints[i].pos(), waypoints[i + 1].pos());
-        const float d = s.distTo(pt);
-
-        if (dist < 0 || d < dist) {
-            best = s;
-            dist = d;
+int InterpolatedPath::nearestSegmentIndex(Point pt, float* dist) const {
+    int index = -1;
+    float bestDist = 0;
+    forEachBlock([&](int first, int n, const float* x, const float* y) {
+        float d;
+        const int i = PointBuffer::nearestSegment(x, y, n, pt, &d);
+        if (i >= 0 && (index < 0 || d < bestDist)) {
+            index = first + i;
+            bestDist = d;
         }
-    }
+    });
 
-    return best;
+    if (dist && index >= 0) {
+        *dist = bestDist;
+    }
+    return index;
 }
 
 float InterpolatedPath::length(Point pt) const {
-    float dist = -1;
-    float length = 0;
-    if (waypoints.empty()) {
+    const int best = nearestSegmentIndex(pt);
+    if (best < 0) {
         return 0;
     }
 
-    for (unsigned int i = 0; i < (waypoints.size() - 1); ++i) {
-        Segment s(waypoints[i].pos(), waypoints[i + 1].pos());
-
-        // add the segment length
-        length += s.length();
-
-        const float d = s.distTo(pt);
-
-        // if point closer to this segment
-        if (dist < 0 || d < dist) {
-            // closest point on segment
-            Point p = s.nearestPoint(pt);
-
-            // new best distance
-            dist = d;
-
-            // reset running length count
-            length = 0;
-            length += p.distTo(s.pt[1]);
-        }
+    // From the closest point on the nearest segment to the end of the path
+    Segment s(waypoints[best].pos(), waypoints[best + 1].pos());
+    float length = s.nearestPoint(pt).distTo(s.pt[1]);
+    for (int i = best + 1; i < (int)waypoints.size() - 1; ++i) {
+        length +=
+            Segment(waypoints[i].pos(), waypoints[i + 1].pos()).length();
     }
 
     return length;
@@ -186,53 +159,68 @@ void InterpolatedPath::draw(SystemState* const state,
 }
 
 boost::optional<RobotInstant> InterpolatedPath::evaluate(float t) const {
+    int cursor = _cursor.load(memory_order_relaxed);
+    boost::optional<RobotInstant> instant = evaluateFrom(t, cursor);
+    _cursor.store(cursor, memory_order_relaxed);
+    return instant;
+}
+
+vector<boost::optional<RobotInstant>> InterpolatedPath::evaluate(
+    const vector<float>& times) const {
+    vector<boost::optional<RobotInstant>> instants;
+    instants.reserve(times.size());
+
+    int cursor = 0;
+    for (float t : times) {
+        instants.push_back(evaluateFrom(t, cursor));
+    }
+    return instants;
+}
+
+boost::optional<RobotInstant> InterpolatedPath::evaluateFrom(
+    float t, int& cursor) const {
     if (t < 0) {
         debugThrow(
             invalid_argument("A time less than 0 was entered for time t."));
     }
-    /*
-    float linearPos;
-    float linearSpeed;
-    bool pathIsValid = TrapezoidalMotion(
-        length(),
-        maxSpeed,
-        maxAcceleration,
-        t,
-        startSpeed,
-        endSpeed,
-        linearPos,      //  these are set by reference since C++ can't return
-    multiple values
-        linearSpeed);   //
-
-    Point direction;
-    if(!getPoint(linearPos, targetPosOut, direction)) {
-        return false;
-    }
-
-    targetVelOut = direction * linearSpeed;
-    */
     if (waypoints.size() == 0 || waypoints.size() == 1) {
         return boost::none;
     }
     if (t < waypoints[0].time) {
         debugThrow(
             invalid_argument("The start time should not be less than zero"));
+        return boost::none;
     }
 
-    int i = 0;
-    while (waypoints[i].time <= t) {
-        if (waypoints[i].time == t) {
-            return RobotInstant(waypoints[i].instant);
-        }
-        i++;
-        if (i == size()) {
-            return boost::none;
+    // Find the first waypoint at or after t.  Sequential queries usually land
+    // on the cursor or the waypoint after it.
+    const int n = waypoints.size();
+    auto isFirstAtOrAfter = [&](int i) {
+        return i < n && waypoints[i].time >= t &&
+               (i == 0 || waypoints[i - 1].time < t);
+    };
+    int i = cursor;
+    if (!isFirstAtOrAfter(i)) {
+        if (isFirstAtOrAfter(i + 1)) {
+            i++;
+        } else {
+            i = lower_bound(waypoints.begin(), waypoints.end(), t,
+                            [](const Entry& entry, float time) {
+                                return entry.time < time;
+                            }) -
+                waypoints.begin();
         }
     }
-    float deltaT = (waypoints[i].time - waypoints[i - 1].time);
-    if (deltaT == 0) {
+    cursor = i;
+
+    if (i == n) {
+        return boost::none;
+    }
+    if (waypoints[i].time == t) {
         return RobotInstant(waypoints[i].instant);
     }
+
+    float deltaT = (waypoints[i].time - waypoints[i - 1].time);
     float constant = (t - waypoints[i - 1].time) / deltaT;
 
     return RobotInstant(MotionInstant(waypoints[i - 1].pos() * (1 - constant) +
@@ -289,6 +277,7 @@ unique_ptr<Path> InterpolatedPath::subPath(float startTime,
     }
 
     InterpolatedPath* subpath = new InterpolatedPath();
+    subpath->setStartTime(this->startTime() + RJ::SecsToTimestamp(startTime));
 
     // Bound the endTime to a reasonable time.
     endTime = min(endTime, getDuration());
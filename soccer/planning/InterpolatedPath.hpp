@@ -2,10 +2,14 @@
 
 #include <planning/Path.hpp>
 #include <Geometry2d/Point.hpp>
+#include <Geometry2d/PointBuffer.hpp>
 #include <Geometry2d/Segment.hpp>
 #include <Geometry2d/ShapeSet.hpp>
 #include <Configuration.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 namespace Planning {
 
 /**
@@ -45,6 +49,15 @@ public:
     /** constructor from two points */
     InterpolatedPath(Geometry2d::Point p0, Geometry2d::Point p1);
 
+    InterpolatedPath(const InterpolatedPath& other)
+        : Path(other), waypoints(other.waypoints) {}
+
+    InterpolatedPath& operator=(const InterpolatedPath& other) {
+        Path::operator=(other);
+        waypoints = other.waypoints;
+        return *this;
+    }
+
     /// Adds an instant at the end of the path for the given time.
     /// Time should not bet less than the last time.
     void addInstant(float time, MotionInstant instant) {
@@ -65,6 +78,8 @@ public:
     virtual void draw(SystemState* const state, const QColor& color,
                       const QString& layer) const override;
     virtual boost::optional<RobotInstant> evaluate(float t) const override;
+    virtual std::vector<boost::optional<RobotInstant>> evaluate(
+        const std::vector<float>& times) const override;
     virtual float getDuration() const override;
     virtual std::unique_ptr<Path> clone() const override;
 
@@ -104,6 +119,14 @@ public:
     /** returns the nearest segement of @a pt to the path */
     Geometry2d::Segment nearestSegment(Geometry2d::Point pt) const;
 
+    /**
+     * Returns the index i of the segment from waypoint i to waypoint i + 1
+     * that is nearest @a pt, or -1 if there are fewer than two waypoints.
+     * If @a dist is not null, it is set to the distance to that segment.
+     */
+    int nearestSegmentIndex(Geometry2d::Point pt,
+                            float* dist = nullptr) const;
+
     // Returns the shortest distance from this path to the given point
     float distanceTo(Geometry2d::Point pt) const;
 
@@ -117,6 +140,46 @@ public:
      *     path starting from the start of the path
      */
     float getTime(int index) const;
+
+private:
+    /**
+     * Evaluates the path at @t, finding the waypoints around it with a binary
+     * search unless @cursor already points at them or at the ones just
+     * before.  @cursor is updated to the first waypoint at or after @t so
+     * that the next, later time is found without searching.
+     */
+    boost::optional<RobotInstant> evaluateFrom(float t, int& cursor) const;
+
+    /// The cursor left by the last call to evaluate(float).  It is only a
+    /// hint, and is checked against the waypoint times before it is used.
+    mutable std::atomic<int> _cursor{0};
+
+    /**
+     * Copies the waypoint positions into arrays a block at a time and calls
+     * @visit(first, n, x, y) for the positions of waypoints
+     * [first, first + n), so the batch functions in Geometry2d::PointBuffer
+     * can be used without allocating.  Consecutive blocks share a waypoint,
+     * so every segment between waypoints is in exactly one block.
+     */
+    template <typename Visitor>
+    void forEachBlock(Visitor visit) const {
+        const int BlockSize = Geometry2d::PointBuffer::BlockSize;
+        float x[BlockSize], y[BlockSize];
+
+        const int size = waypoints.size();
+        for (int first = 0; first < size; first += BlockSize - 1) {
+            const int n = std::min(BlockSize, size - first);
+            for (int i = 0; i < n; ++i) {
+                x[i] = waypoints[first + i].pos().x;
+                y[i] = waypoints[first + i].pos().y;
+            }
+            visit(first, n, x, y);
+
+            if (first + n == size) {
+                break;
+            }
+        }
+    }
 };
 
 }  // namespace Planning
@@ -13,18 +13,25 @@ namespace Planning {
 /// The PlanRequest encapsulates all information that the planner needs to know
 /// about an individual robot in order to generate a path for it.
 struct PlanRequest {
-    PlanRequest(MotionInstant start, std::unique_ptr<MotionCommand> command,
+    PlanRequest(MotionInstant start, RJ::Time startTime,
+                std::unique_ptr<MotionCommand> command,
                 MotionConstraints constraints, std::unique_ptr<Path> prevPath,
                 std::shared_ptr<const Geometry2d::ShapeSet> obs)
         : start(start),
+          startTime(startTime),
           motionCommand(std::move(command)),
           constraints(constraints),
           prevPath(std::move(prevPath)),
           obstacles(obs) {}
 
-    PlanRequest() {}
+    PlanRequest() : startTime(0) {}
 
     MotionInstant start;
+
+    /// Time at which the robot is at @start.  Planned paths start at this
+    /// time.
+    RJ::Time startTime;
+
     std::unique_ptr<MotionCommand> motionCommand;
     MotionConstraints constraints;
     std::unique_ptr<Path> prevPath;
@@ -36,6 +43,8 @@ struct PlanRequest {
  */
 class MultiRobotPathPlanner {
 public:
+    virtual ~MultiRobotPathPlanner() {}
+
     virtual std::map<int, std::unique_ptr<Path>> run(
         std::map<int, PlanRequest> requests) = 0;
 };
@@ -0,0 +1,23 @@
+#include "ObstaclePool.hpp"
+
+using namespace std;
+using namespace Geometry2d;
+
+namespace Planning {
+
+const int ObstaclePool::BlockSize;
+
+shared_ptr<Shape> ObstaclePool::circle(Point center, float radius) {
+    const int block = _used / BlockSize;
+    if (block == (int)_blocks.size()) {
+        // Add a block instead of growing one, so circles already handed out
+        // stay where they are
+        _blocks.emplace_back(new Circle[BlockSize]);
+    }
+
+    Circle& slot = _blocks[block][_used++ % BlockSize];
+    slot = Circle(center, radius);
+    return ShapeSet::view(&slot);
+}
+
+}  // namespace Planning
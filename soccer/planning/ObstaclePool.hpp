@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/ShapeSet.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace Planning {
+
+/**
+ * @brief Storage for the circle obstacles built in one frame
+ *
+ * @details Robot and ball obstacles are rebuilt every frame for every robot
+ * that is planned for.  The pool stores them by value in fixed-size blocks of
+ * contiguous circles and hands out non-owning pointers to them (see
+ * ShapeSet::view()), so a robot's obstacle set is a list of views into the
+ * pool.  Blocks are kept when the pool is cleared, so once the pool has grown
+ * to the number of circles a frame needs, building obstacles neither
+ * allocates nor does any reference counting.
+ *
+ * Circles never move once handed out, but they are overwritten after the next
+ * clear().  Any ShapeSet holding them must be cleared or discarded by then.
+ */
+class ObstaclePool {
+public:
+    /// Number of circles in each block of storage
+    static const int BlockSize = 64;
+
+    /// Starts a new frame.  Circles handed out before this will be reused.
+    void clear() { _used = 0; }
+
+    /// Returns a circle with the given center and radius.  The pointer
+    /// doesn't own the circle and is only valid until the next clear().
+    std::shared_ptr<Geometry2d::Shape> circle(Geometry2d::Point center,
+                                              float radius);
+
+    /// Number of circles handed out since clear()
+    int size() const { return _used; }
+
+    /// Number of blocks allocated over the life of the pool
+    int allocations() const { return _blocks.size(); }
+
+private:
+    std::vector<std::unique_ptr<Geometry2d::Circle[]>> _blocks;
+
+    /// The first _used circles across the blocks have been handed out in
+    /// this frame
+    int _used = 0;
+};
+
+}  // namespace Planning
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "ObstaclePool.hpp"
+#include <Geometry2d/ShapeSet.hpp>
+
+using namespace std;
+using namespace Geometry2d;
+
+namespace Planning {
+
+TEST(ObstaclePool, reusesStorage) {
+    ObstaclePool pool;
+    ShapeSet obstacles;
+
+    for (int frame = 0; frame < 10; ++frame) {
+        obstacles.clear();
+        pool.clear();
+        for (int i = 0; i < 5; ++i) {
+            obstacles.add(pool.circle(Point(frame, i), 0.1f * (i + 1)));
+        }
+
+        ASSERT_EQ(5, obstacles.size());
+        EXPECT_EQ(5, pool.size());
+        for (int i = 0; i < 5; ++i) {
+            const Circle* circle =
+                dynamic_cast<const Circle*>(obstacles.shapes()[i].get());
+            ASSERT_NE(nullptr, circle);
+            EXPECT_EQ(Point(frame, i), circle->center);
+            EXPECT_FLOAT_EQ(0.1f * (i + 1), circle->radius());
+
+            // The set doesn't own the circles
+            EXPECT_EQ(0, obstacles.shapes()[i].use_count());
+        }
+    }
+
+    // Only the first frame allocated
+    EXPECT_EQ(1, pool.allocations());
+}
+
+TEST(ObstaclePool, circlesDontMoveAsThePoolGrows) {
+    ObstaclePool pool;
+
+    const int n = 3 * ObstaclePool::BlockSize + 1;
+    vector<shared_ptr<Shape>> circles;
+    for (int i = 0; i < n; ++i) {
+        circles.push_back(pool.circle(Point(i, 0), 0.5f));
+    }
+    EXPECT_EQ(4, pool.allocations());
+
+    for (int i = 0; i < n; ++i) {
+        const Circle* circle = dynamic_cast<const Circle*>(circles[i].get());
+        ASSERT_NE(nullptr, circle);
+        EXPECT_EQ(Point(i, 0), circle->center);
+    }
+
+    // The next frame overwrites the same circles in order
+    pool.clear();
+    EXPECT_EQ(circles[0].get(), pool.circle(Point(1, 2), 0.25f).get());
+    EXPECT_EQ(4, pool.allocations());
+}
+
+}  // namespace Planning
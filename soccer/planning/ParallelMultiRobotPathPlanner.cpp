@@ -0,0 +1,113 @@
+#include "ParallelMultiRobotPathPlanner.hpp"
+
+#include <Constants.hpp>
+
+#include <algorithm>
+
+namespace Planning {
+
+ParallelMultiRobotPathPlanner::ParallelMultiRobotPathPlanner(int numThreads)
+    : _numThreads(numThreads) {
+    if (_numThreads <= 0) {
+        _numThreads = std::max(
+            1, std::min((int)std::thread::hardware_concurrency(),
+                        (int)Robots_Per_Team));
+    }
+
+    if (_numThreads > 1) {
+        for (int i = 0; i < _numThreads; ++i) {
+            _workers.emplace_back(&ParallelMultiRobotPathPlanner::workerLoop,
+                                  this);
+        }
+    }
+}
+
+ParallelMultiRobotPathPlanner::~ParallelMultiRobotPathPlanner() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::map<int, std::unique_ptr<Path>> ParallelMultiRobotPathPlanner::run(
+    std::map<int, PlanRequest> requests) {
+    if (_workers.empty()) {
+        return IndependentMultiRobotPathPlanner::run(std::move(requests));
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Pick planners here since that changes the planner map.  The jobs are in
+    // shell order.
+    _jobs.clear();
+    for (auto& entry : requests) {
+        PlanRequest& request = entry.second;
+        _jobs.push_back(
+            Job{&request, &plannerFor(entry.first, request), nullptr, nullptr});
+    }
+    _nextJob = 0;
+    _jobsRemaining = _jobs.size();
+    _workAvailable.notify_all();
+
+    _workDone.wait(lock, [this]() { return _jobsRemaining == 0; });
+
+    std::map<int, std::unique_ptr<Path>> paths;
+    auto job = _jobs.begin();
+    for (auto& entry : requests) {
+        if (job->error) {
+            std::exception_ptr error = job->error;
+            _jobs.clear();
+            std::rethrow_exception(error);
+        }
+        paths[entry.first] = std::move(job->path);
+        ++job;
+    }
+    _jobs.clear();
+
+    return paths;
+}
+
+void ParallelMultiRobotPathPlanner::workerLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _workAvailable.wait(
+            lock, [this]() { return _stopping || _nextJob < _jobs.size(); });
+        if (_stopping) {
+            return;
+        }
+
+        while (runNextJob(lock)) {
+        }
+    }
+}
+
+bool ParallelMultiRobotPathPlanner::runNextJob(
+    std::unique_lock<std::mutex>& lock) {
+    if (_nextJob >= _jobs.size()) {
+        return false;
+    }
+
+    // _jobs isn't resized until every job is done, so this stays valid while
+    // unlocked.
+    Job& job = _jobs[_nextJob++];
+
+    lock.unlock();
+    try {
+        job.path = runPlanner(*job.planner, *job.request);
+    } catch (...) {
+        job.error = std::current_exception();
+    }
+    lock.lock();
+
+    if (--_jobsRemaining == 0) {
+        _workDone.notify_one();
+    }
+    return true;
+}
+
+}  // namespace Planning
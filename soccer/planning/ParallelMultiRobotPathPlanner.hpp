@@ -0,0 +1,68 @@
+#pragma once
+
+#include "IndependentMultiRobotPathPlanner.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Planning {
+
+/**
+ * Same as IndependentMultiRobotPathPlanner, but runs the single-robot planners
+ * on a fixed pool of worker threads.
+ *
+ * Planners are selected on the calling thread, then each robot's request is
+ * handed to whichever worker is free.  Every SingleRobotPathPlanner has its own
+ * random number generator, so the paths don't depend on which worker ran them
+ * or in what order, and the results are collected by shell id once all the
+ * jobs are done.  The output is the same as IndependentMultiRobotPathPlanner's
+ * given the same seed.
+ *
+ * If a planner throws, the exception for the lowest shell id is rethrown from
+ * run() after all the jobs have finished.
+ */
+class ParallelMultiRobotPathPlanner : public IndependentMultiRobotPathPlanner {
+public:
+    /// @param numThreads Number of worker threads.  Zero picks one per core,
+    ///     up to the number of robots on a team.  With one thread, planning
+    ///     runs on the calling thread.
+    explicit ParallelMultiRobotPathPlanner(int numThreads = 0);
+    ~ParallelMultiRobotPathPlanner();
+
+    virtual std::map<int, std::unique_ptr<Path>> run(
+        std::map<int, PlanRequest> requests) override;
+
+    int numThreads() const { return _numThreads; }
+
+private:
+    struct Job {
+        PlanRequest* request;
+        SingleRobotPathPlanner* planner;
+        std::unique_ptr<Path> path;
+        std::exception_ptr error;
+    };
+
+    void workerLoop();
+
+    /// Runs the next unclaimed job in _jobs.  Called with _mutex held (by
+    /// @lock), which is released while planning.  Returns false if there were
+    /// no jobs left to claim.
+    bool runNextJob(std::unique_lock<std::mutex>& lock);
+
+    int _numThreads;
+    std::vector<std::thread> _workers;
+
+    // Everything below is protected by _mutex
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workDone;
+    std::vector<Job> _jobs;
+    size_t _nextJob = 0;
+    size_t _jobsRemaining = 0;
+    bool _stopping = false;
+};
+
+}  // namespace Planning
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "ParallelMultiRobotPathPlanner.hpp"
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/Rect.hpp>
+
+#include <stdlib.h>
+
+using namespace Geometry2d;
+
+namespace Planning {
+
+// Each robot has to get around a wall to reach its goal, so the RRT is used
+static std::map<int, PlanRequest> exampleRequests() {
+    const RJ::Time startTime = RJ::SecsToTimestamp(100);
+    auto obstacles = std::make_shared<ShapeSet>();
+    obstacles->add(std::make_shared<Rect>(Point(-1, 3), Point(1, 3.2)));
+    obstacles->add(std::make_shared<Circle>(Point(2.5, 5), 0.3));
+    obstacles->buildIndex();
+
+    std::map<int, PlanRequest> requests;
+    for (int shell = 0; shell < 6; ++shell) {
+        Point start(-1.5 + shell * 0.6, 1);
+        Point goal(1.5 - shell * 0.6, 5);
+        requests[shell] = PlanRequest(
+            MotionInstant(start, {0, 0}), startTime,
+            std::make_unique<PathTargetCommand>(MotionInstant(goal, {0, 0})),
+            MotionConstraints(), nullptr, obstacles);
+    }
+
+    // Robots that aren't moving anywhere use a different planner
+    requests[8] =
+        PlanRequest(MotionInstant({0, 3.1}, {0, 0}), startTime,
+                    std::make_unique<EmptyCommand>(), MotionConstraints(),
+                    nullptr, obstacles);
+
+    return requests;
+}
+
+TEST(ParallelMultiRobotPathPlanner, matchesIndependentPlanner) {
+    srand48(1);
+    IndependentMultiRobotPathPlanner sequential;
+    auto expected = sequential.run(exampleRequests());
+
+    srand48(1);
+    ParallelMultiRobotPathPlanner parallel(4);
+    auto actual = parallel.run(exampleRequests());
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (const auto& entry : expected) {
+        const auto& path = actual[entry.first];
+        ASSERT_NE(nullptr, path) << "No path for shell " << entry.first;
+        ASSERT_NE(nullptr, entry.second);
+
+        EXPECT_FLOAT_EQ(entry.second->getDuration(), path->getDuration());
+        for (float t = 0; t < path->getDuration(); t += 0.1) {
+            auto a = entry.second->evaluate(t);
+            auto b = path->evaluate(t);
+            ASSERT_TRUE(a && b);
+            EXPECT_FLOAT_EQ(a->motion.pos.x, b->motion.pos.x);
+            EXPECT_FLOAT_EQ(a->motion.pos.y, b->motion.pos.y);
+        }
+    }
+}
+
+}  // namespace Planning
@@ -1,6 +1,17 @@
 #include "Path.hpp"
 #include <protobuf/LogFrame.pb.h>
 namespace Planning {
+
+std::vector<boost::optional<RobotInstant>> Path::evaluate(
+    const std::vector<float>& times) const {
+    std::vector<boost::optional<RobotInstant>> instants;
+    instants.reserve(times.size());
+    for (float t : times) {
+        instants.push_back(evaluate(t));
+    }
+    return instants;
+}
+
 // This method is a default implementation of draw() that works by evaluating
 // the path at fixed time intervals form t = 0 to t = duration.
 void Path::draw(SystemState* const state, const QColor& color,
@@ -23,9 +34,12 @@ void Path::draw(SystemState* const state, const QColor& color,
     const float step = duration / segmentCount;
 
     // Draw points along the path except the last one
+    std::vector<float> times;
     for (int i = 0; i < segmentCount; ++i) {
-        float t = i * step;
-        addPoint(evaluate(t)->motion);
+        times.push_back(i * step);
+    }
+    for (const boost::optional<RobotInstant>& instant : evaluate(times)) {
+        addPoint(instant->motion);
     }
 
     // Draw the last point of the path
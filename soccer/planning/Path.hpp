@@ -9,6 +9,8 @@
 #include <QColor>
 #include <QString>
 
+#include <vector>
+
 namespace Planning {
 
 /**
@@ -16,7 +18,9 @@ namespace Planning {
  */
 class Path {
 public:
-    Path(RJ::Time startTime = RJ::timestamp()) : _startTime(startTime) {}
+    /// Planners set @startTime to the time they planned for (see
+    /// PlanRequest::startTime) rather than it being read from a clock here.
+    Path(RJ::Time startTime = 0) : _startTime(startTime) {}
     virtual ~Path() {}
 
     /**
@@ -33,6 +37,19 @@ public:
      */
     virtual boost::optional<RobotInstant> evaluate(float t) const = 0;
 
+    /**
+     * Evaluates the path at each of @times.  This gives the same results as
+     * calling evaluate(float) for each time, but paths can override it to
+     * share work between the times, which is cheapest when they are in
+     * increasing order.
+     *
+     * @param times Times (in seconds) since the robot started the path
+     * @return The instant for each time, or boost::none for times outside the
+     *     path
+     */
+    virtual std::vector<boost::optional<RobotInstant>> evaluate(
+        const std::vector<float>& times) const;
+
     /**
      * Returns true if the path hits an obstacle
      *
@@ -137,6 +154,24 @@ public:
         }
     }
 
+    virtual std::vector<boost::optional<RobotInstant>> evaluate(
+        const std::vector<float>& times) const override {
+        if (!path) {
+            return std::vector<boost::optional<RobotInstant>>(times.size());
+        }
+
+        std::vector<boost::optional<RobotInstant>> instants =
+            path->evaluate(times);
+        if (angleFunction) {
+            for (boost::optional<RobotInstant>& instant : instants) {
+                if (instant) {
+                    instant->angle = angleFunction->operator()(instant->motion);
+                }
+            }
+        }
+        return instants;
+    }
+
     /**
      * Returns true if the path hits an obstacle
      *
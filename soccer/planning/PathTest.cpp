@@ -2,6 +2,10 @@
 #include <gtest/gtest.h>
 #include <planning/InterpolatedPath.hpp>
 #include <planning/CompositePath.hpp>
+#include <planning/TrapezoidalPath.hpp>
+#include <Geometry2d/Circle.hpp>
+#include <Geometry2d/Rect.hpp>
+#include <Constants.hpp>
 
 using namespace std;
 using namespace Geometry2d;
@@ -24,6 +28,33 @@ TEST(Path, nearestSegment) {
     EXPECT_FLOAT_EQ(p1.y, actSeg.pt[1].y);
 }
 
+TEST(InterpolatedPath, nearestLongPath) {
+    // Long enough that the waypoints are searched in several blocks
+    InterpolatedPath path;
+    for (int i = 0; i < 150; ++i) {
+        path.waypoints.emplace_back(
+            MotionInstant(Point(i * 0.1f, (i % 2) * 0.1f), Point()), i);
+    }
+
+    // Just off the middle of segment 100, and closest to its first waypoint
+    Point pt(10.06, 0.02);
+    EXPECT_EQ(100, path.nearestIndex(pt));
+    EXPECT_EQ(100, path.nearestSegmentIndex(pt));
+    EXPECT_FLOAT_EQ(Segment(path.waypoints[100].pos(),
+                            path.waypoints[101].pos())
+                        .distTo(pt),
+                    path.distanceTo(pt));
+
+    // A point past the end is nearest the last segment
+    EXPECT_EQ(148, path.nearestSegmentIndex(Point(20, 0)));
+    EXPECT_FLOAT_EQ(0, path.length(Point(20, 0)));
+
+    InterpolatedPath single(Point(1, 1));
+    EXPECT_EQ(0, single.nearestIndex(Point()));
+    EXPECT_EQ(-1, single.nearestSegmentIndex(Point()));
+    EXPECT_EQ(-1, single.distanceTo(Point()));
+}
+
 TEST(InterpolatedPath, evaluate) {
     Point p0(1, 1), p1(1, 2), p2(2, 2);
 
@@ -37,6 +68,49 @@ TEST(InterpolatedPath, evaluate) {
     ASSERT_FALSE(out);
 }
 
+TEST(InterpolatedPath, evaluateInAnyOrder) {
+    InterpolatedPath path;
+    for (int i = 0; i < 50; ++i) {
+        path.waypoints.emplace_back(
+            MotionInstant(Point(i, i % 3), Point(1, i % 2)), i * 0.5f);
+    }
+
+    // Waypoint times, times between them, and the end of the path
+    auto expectEvaluates = [&](float t) {
+        auto out = path.evaluate(t);
+        ASSERT_TRUE(out);
+        EXPECT_FLOAT_EQ(2 * t, out->motion.pos.x);
+        int i = min(49, (int)(2 * t));
+        if (2 * t == i) {
+            EXPECT_EQ(path.waypoints[i].pos(), out->motion.pos);
+            EXPECT_EQ(path.waypoints[i].vel(), out->motion.vel);
+        }
+    };
+    for (float t : {0.0f, 0.1f, 0.5f, 0.6f, 3.25f, 24.5f, 3.0f, 0.0f, 12.4f,
+                    12.5f, 12.6f, 1.0f}) {
+        expectEvaluates(t);
+    }
+    EXPECT_FALSE(path.evaluate(24.6f));
+    expectEvaluates(0.2f);
+
+    // The batch gives the same results as one time at a time, in any order
+    vector<float> times = {0, 0.25, 0.5, 1.75, 1.8, 10, 24.5, 30, 5, 0.1};
+    auto instants = path.evaluate(times);
+    ASSERT_EQ(times.size(), instants.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+        auto out = path.evaluate(times[i]);
+        ASSERT_EQ((bool)out, (bool)instants[i]);
+        if (out) {
+            EXPECT_EQ(out->motion.pos, instants[i]->motion.pos);
+            EXPECT_EQ(out->motion.vel, instants[i]->motion.vel);
+        }
+    }
+
+    // Paths that are too short to evaluate
+    EXPECT_FALSE(InterpolatedPath(Point()).evaluate(0));
+    EXPECT_EQ(2u, InterpolatedPath(Point()).evaluate({0, 1}).size());
+}
+
 TEST(InterpolatedPath, subPath1) {
     InterpolatedPath path;
     path.waypoints.emplace_back(MotionInstant(Point(1, 1), Point(0, 0)), 0);
@@ -60,6 +134,13 @@ TEST(InterpolatedPath, subPath1) {
     //  mid velocity of subpath should be the same as velocity of original path
     EXPECT_FLOAT_EQ(Point(1, 1).y, mid->motion.vel.y);
 
+    // Paths don't read the clock, so they start when they're told to, and
+    // subPaths start where they were cut from
+    EXPECT_EQ(0u, path.startTime());
+    path.setStartTime(5000000);
+    EXPECT_EQ(5000000u, path.clone()->startTime());
+    EXPECT_EQ(6000000u, path.subPath(1, 5)->startTime());
+
     EXPECT_FLOAT_EQ(1, mid->motion.pos.x);
     EXPECT_FLOAT_EQ(2, mid->motion.pos.y);
 
@@ -155,6 +236,11 @@ TEST(CompositePath, CompositeSubPath) {
     }
     subPaths.push_back(compositePath.subPath(8));
 
+    compositePath.setStartTime(1000000);
+    EXPECT_EQ(1000000u, compositePath.clone()->startTime());
+    EXPECT_EQ(3000000u, compositePath.subPath(2, 5)->startTime());
+    EXPECT_EQ(3000000u, compositePath.subPath(2, 2.5)->startTime());
+
     // Compare the subPaths of the compositePaths to the origional path and
     // check that the results of evaluating the paths are close enough
     for (int i = 0; i < 9; i++) {
@@ -175,4 +261,42 @@ TEST(CompositePath, CompositeSubPath) {
     }
 }
 
+TEST(TrapezoidalPath, hit) {
+    MotionConstraints constraints;
+    constraints.maxSpeed = 2;
+    constraints.maxAcceleration = 1;
+    TrapezoidalPath path(Point(0, 0), 0, Point(0, 4), 0, constraints);
+
+    // A wall across the middle of the path, thinner than the distance covered
+    // between samples at full speed
+    ShapeSet obstacles;
+    obstacles.add(make_shared<Rect>(Point(-1, 2), Point(1, 2.001)));
+
+    // The robot first touches the wall one robot radius before it
+    float hitTime = -1;
+    ASSERT_TRUE(path.hit(obstacles, hitTime, 0));
+    auto instant = path.evaluate(hitTime);
+    ASSERT_TRUE(instant);
+    EXPECT_NEAR(2 - Robot_Radius, instant->motion.pos.y, 0.01);
+    const float wallTime = hitTime;
+
+    // Already past the wall
+    EXPECT_FALSE(path.hit(obstacles, hitTime, path.getDuration() * 0.9f));
+
+    // Obstacles the path starts in are ignored
+    ShapeSet start;
+    start.add(make_shared<Circle>(Point(0, 0), 0.5));
+    EXPECT_FALSE(path.hit(start, hitTime, 0));
+
+    // A path made of trapezoidal paths reports the time on the whole path
+    CompositePath composite;
+    composite.append(make_unique<TrapezoidalPath>(Point(0, -4), 0, Point(0, 0),
+                                                  0, constraints));
+    composite.append(make_unique<TrapezoidalPath>(Point(0, 0), 0, Point(0, 4),
+                                                  0, constraints));
+    float compositeHitTime = -1;
+    ASSERT_TRUE(composite.hit(obstacles, compositeHitTime, 0));
+    EXPECT_NEAR(path.getDuration() + wallTime, compositeHitTime, 0.001);
+}
+
 }  // namespace Planning
@@ -23,15 +23,14 @@ bool PivotPathPlanner::shouldReplan(MotionInstant startInstant,
 }
 
 std::unique_ptr<Path> PivotPathPlanner::run(
-    MotionInstant startInstant, const MotionCommand* cmd,
-    const MotionConstraints& motionConstraints,
+    MotionInstant startInstant, RJ::Time startTime,
+    const MotionCommand* cmd, const MotionConstraints& motionConstraints,
     const Geometry2d::ShapeSet* obstacles, std::unique_ptr<Path> prevPath) {
     // TODO implement actual Pivoting
     debugThrow("Unfinished Class");
 
-    EscapeObstaclesPathPlanner escapePlanner;
     EmptyCommand emptyCommand;
-    return escapePlanner.run(startInstant, &emptyCommand, motionConstraints,
-                             obstacles, std::move(prevPath));
+    return _escapePlanner.run(startInstant, startTime, &emptyCommand,
+                              motionConstraints, obstacles, std::move(prevPath));
 }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SingleRobotPathPlanner.hpp"
+#include "EscapeObstaclesPathPlanner.hpp"
 #include <Geometry2d/Point.hpp>
 
 class Configuration;
@@ -13,8 +14,8 @@ namespace Planning {
 class PivotPathPlanner : public SingleRobotPathPlanner {
 public:
     virtual std::unique_ptr<Path> run(
-        MotionInstant startInstant, const MotionCommand* cmd,
-        const MotionConstraints& motionConstraints,
+        MotionInstant startInstant, RJ::Time startTime,
+        const MotionCommand* cmd, const MotionConstraints& motionConstraints,
         const Geometry2d::ShapeSet* obstacles,
         std::unique_ptr<Path> prevPath = nullptr) override;
 
@@ -32,6 +33,9 @@ private:
     Geometry2d::Point calculateNonblockedPathEndpoint(
         Geometry2d::Point start, Geometry2d::Point dir,
         const Geometry2d::ShapeSet* obstacles);
+
+    /// Created with this planner so it is seeded on the same thread
+    EscapeObstaclesPathPlanner _escapePlanner;
 };
 
 }  // namespace Planning
@@ -18,14 +18,25 @@ using namespace Geometry2d;
 
 namespace Planning {
 
+REGISTER_CONFIGURABLE(RRTPlanner);
+
+ConfigBool* RRTPlanner::_incrementalReplan;
+
+void RRTPlanner::createConfiguration(Configuration* cfg) {
+    _incrementalReplan =
+        new ConfigBool(cfg, "RRTPlanner/incrementalReplan", false);
+}
+
 RRTPlanner::RRTPlanner(int maxIterations) : _maxIterations(maxIterations) {}
 
-bool RRTPlanner::shouldReplan(MotionInstant start, MotionInstant goal,
+bool RRTPlanner::shouldReplan(MotionInstant start, RJ::Time startTime,
+                              MotionInstant goal,
                               const MotionConstraints& motionConstraints,
                               const Geometry2d::ShapeSet* obstacles,
                               const Path* prevPath) const {
-    if (SingleRobotPathPlanner::shouldReplan(start, motionConstraints,
-                                             obstacles, prevPath)) {
+    if (SingleRobotPathPlanner::shouldReplan(start, startTime,
+                                             motionConstraints, obstacles,
+                                             prevPath)) {
         return true;
     }
 
@@ -45,8 +56,8 @@ bool RRTPlanner::shouldReplan(MotionInstant start, MotionInstant goal,
 }
 
 std::unique_ptr<Path> RRTPlanner::run(
-    MotionInstant start, const MotionCommand* cmd,
-    const MotionConstraints& motionConstraints,
+    MotionInstant start, RJ::Time startTime,
+    const MotionCommand* cmd, const MotionConstraints& motionConstraints,
     const Geometry2d::ShapeSet* obstacles, std::unique_ptr<Path> prevPath) {
     // This planner only works with commands of type 'PathTarget'
     assert(cmd->getCommandType() == Planning::MotionCommand::PathTarget);
@@ -58,7 +69,7 @@ std::unique_ptr<Path> RRTPlanner::run(
     // Simple case: no path
     if (start.pos == goal.pos) {
         InterpolatedPath* path = new InterpolatedPath();
-        path->setStartTime(RJ::timestamp());
+        path->setStartTime(startTime);
         path->waypoints.emplace_back(
             MotionInstant(start.pos, Geometry2d::Point()), 0);
         return unique_ptr<Path>(path);
@@ -68,16 +79,17 @@ std::unique_ptr<Path> RRTPlanner::run(
     boost::optional<Geometry2d::Point> prevGoal;
     if (prevPath) prevGoal = prevPath->end().motion.pos;
     goal.pos = EscapeObstaclesPathPlanner::findNonBlockedGoal(
-        goal.pos, prevGoal, *obstacles);
+        goal.pos, prevGoal, *obstacles, _random);
 
     // Replan if needed, otherwise return the previous path unmodified
-    if (shouldReplan(start, goal, motionConstraints, obstacles,
+    if (shouldReplan(start, startTime, goal, motionConstraints, obstacles,
                      prevPath.get())) {
         // Run bi-directional RRT to generate a path.
         auto points = runRRT(start, goal, motionConstraints, obstacles);
 
         // Optimize out uneccesary waypoints
         optimize(points, obstacles, motionConstraints, start.vel, goal.vel);
+        _prevWaypoints = points;
 
         // Check if Planning or optimization failed
         if (points.size() < 2) {
@@ -85,12 +97,13 @@ std::unique_ptr<Path> RRTPlanner::run(
             auto path = make_unique<InterpolatedPath>();
             path->waypoints.emplace_back(MotionInstant(start.pos, Point()), 0);
             path->waypoints.emplace_back(MotionInstant(start.pos, Point()), 0);
+            path->setStartTime(startTime);
             return std::move(path);
         }
 
         // Generate and return a cubic bezier path using the waypoints
         return generateCubicBezier(points, *obstacles, motionConstraints,
-                                   start.vel, goal.vel);
+                                   start.vel, goal.vel, startTime);
     } else {
         return prevPath;
     }
@@ -99,26 +112,43 @@ std::unique_ptr<Path> RRTPlanner::run(
 vector<Point> RRTPlanner::runRRT(MotionInstant start, MotionInstant goal,
                                  const MotionConstraints& motionConstraints,
                                  const Geometry2d::ShapeSet* obstacles) {
-    unique_ptr<InterpolatedPath> path = make_unique<InterpolatedPath>();
-
-    // Initialize two RRT trees
-    FixedStepTree startTree;
-    FixedStepTree goalTree;
+    // Initialize two RRT trees.  These are reused from the last plan so their
+    // storage doesn't have to be reallocated.
+    FixedStepTree& startTree = _startTree;
+    FixedStepTree& goalTree = _goalTree;
     startTree.init(start.pos, obstacles);
-    goalTree.init(goal.pos, obstacles);
     startTree.step = goalTree.step = .15f;
 
+    // When replanning incrementally, the goal tree from the last plan is kept
+    // if the goal hasn't moved much, with only the branches that the new
+    // obstacles block cut off.  The start tree begins with the part of the
+    // last path that is still clear, and if that can be joined to the goal
+    // tree directly there is no search at all.
+    const bool incremental = incrementalReplan() && _prevGoal;
+    bool connected = false;
+    if (incremental &&
+        (goal.pos - *_prevGoal).mag() <= goalChangeThreshold()) {
+        goalTree.repair(goal.pos, obstacles);
+    } else {
+        goalTree.init(goal.pos, obstacles);
+    }
+    if (incremental) {
+        addPreviousPrefix(goal.pos);
+        connected = goalTree.connect(startTree.point(startTree.last()).pos);
+    }
+    _prevGoal = goal.pos;
+
     // Run bi-directional RRT algorithm
     Tree* ta = &startTree;
     Tree* tb = &goalTree;
-    for (unsigned int i = 0; i < _maxIterations; ++i) {
-        Geometry2d::Point r = RandomFieldLocation();
+    for (unsigned int i = 0; i < _maxIterations && !connected; ++i) {
+        Geometry2d::Point r = RandomFieldLocation(_random);
 
-        Tree::Point* newPoint = ta->extend(r);
+        int newPoint = ta->extend(r);
 
-        if (newPoint) {
+        if (newPoint >= 0) {
             // try to connect the other tree to this point
-            if (tb->connect(newPoint->pos)) {
+            if (tb->connect(ta->point(newPoint).pos)) {
                 // trees connected
                 // done with global path finding
                 // the path is from start to goal
@@ -130,12 +160,13 @@ vector<Point> RRTPlanner::runRRT(MotionInstant start, MotionInstant goal,
         swap(ta, tb);
     }
 
-    Tree::Point* p0 = startTree.last();
-    Tree::Point* p1 = goalTree.last();
+    int p0 = startTree.last();
+    int p1 = goalTree.last();
 
     vector<Point> points;
     // sanity check
-    if (!p0 || !p1 || p0->pos != p1->pos) {
+    if (p0 < 0 || p1 < 0 ||
+        startTree.point(p0).pos != goalTree.point(p1).pos) {
         return points;
     }
 
@@ -148,6 +179,46 @@ vector<Point> RRTPlanner::runRRT(MotionInstant start, MotionInstant goal,
     return points;
 }
 
+void RRTPlanner::addPreviousPrefix(Geometry2d::Point goal) {
+    if (_prevWaypoints.size() < 2) {
+        return;
+    }
+
+    // Continue from the end of the old segment the robot is nearest to
+    const Point root = _startTree.point(0).pos;
+    size_t next = 1;
+    float bestDist = -1;
+    for (size_t i = 0; i + 1 < _prevWaypoints.size(); ++i) {
+        const float d =
+            Segment(_prevWaypoints[i], _prevWaypoints[i + 1]).distTo(root);
+        if (bestDist < 0 || d < bestDist) {
+            bestDist = d;
+            next = i + 1;
+        }
+    }
+
+    // Stop at the waypoint nearest the new goal.  If the goal has moved, the
+    // rest of the old path only leads to where it used to be, and if the root
+    // is nearer than all of them nothing is kept.
+    size_t end = next;
+    float goalDist = (root - goal).magsq();
+    for (size_t i = next; i < _prevWaypoints.size(); ++i) {
+        const float d = (_prevWaypoints[i] - goal).magsq();
+        if (d < goalDist) {
+            goalDist = d;
+            end = i + 1;
+        }
+    }
+
+    int base = 0;
+    for (size_t i = next; i < end; ++i) {
+        base = _startTree.addChild(base, _prevWaypoints[i]);
+        if (base < 0) {
+            break;
+        }
+    }
+}
+
 void RRTPlanner::optimize(vector<Geometry2d::Point>& pts,
                           const Geometry2d::ShapeSet* obstacles,
                           const MotionConstraints& motionConstraints,
@@ -164,17 +235,8 @@ void RRTPlanner::optimize(vector<Geometry2d::Point>& pts,
     while (span < pts.size()) {
         bool changed = false;
         for (int i = 0; i + span < pts.size(); i++) {
-            bool transitionValid = true;
-            const auto newHitSet =
-                obstacles->hitSet(Geometry2d::Segment(pts[i], pts[i + span]));
-            if (!newHitSet.empty()) {
-                for (std::shared_ptr<Geometry2d::Shape> hit : newHitSet) {
-                    if (startHitSet.find(hit) == startHitSet.end()) {
-                        transitionValid = false;
-                        break;
-                    }
-                }
-            }
+            const bool transitionValid = !obstacles->anyHit(
+                Geometry2d::Segment(pts[i], pts[i + span]), startHitSet);
 
             if (transitionValid) {
                 for (int x = 1; x < span; x++) {
@@ -216,8 +278,9 @@ std::unique_ptr<InterpolatedPath> RRTPlanner::generatePath(
     const std::vector<Geometry2d::Point>& points,
     const Geometry2d::ShapeSet& obstacles,
     const MotionConstraints& motionConstraints, Geometry2d::Point vi,
-    Geometry2d::Point vf) {
-    return generateCubicBezier(points, obstacles, motionConstraints, vi, vf);
+    Geometry2d::Point vf, RJ::Time startTime) {
+    return generateCubicBezier(points, obstacles, motionConstraints, vi, vf,
+                               startTime);
 }
 
 vector<CubicBezierControlPoints> RRTPlanner::generateNormalCubicBezierPath(
@@ -271,7 +334,6 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
     vector<double> pointsX(length);
     vector<double> pointsY(length);
     vector<double> ks(length - 1);
-    vector<double> ks2(length - 1);
 
     for (int i = 0; i < length; i++) {
         pointsX[i] = points[i].x;
@@ -285,7 +347,6 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
         assert(times->size() == points.size());
         for (int i = 0; i < curvesNum; i++) {
             ks[i] = 1.0 / (times->at(i + 1) - times->at(i));
-            ks2[i] = ks[i] * ks[i];
             if (std::isnan(ks[i])) {
                 debugThrow(
                     "Something went wrong. Points are too close to each other "
@@ -299,7 +360,6 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
                                    endSpeed) -
                            getTime(points, i, motionConstraints, startSpeed,
                                    endSpeed));
-            ks2[i] = ks[i] * ks[i];
             if (std::isnan(ks[i])) {
                 debugThrow(
                     "Something went wrong. Points are too close to each other "
@@ -309,10 +369,9 @@ vector<CubicBezierControlPoints> RRTPlanner::generateCubicBezierPath(
         }
     }
 
-    VectorXd solutionX =
-        RRTPlanner::cubicBezierCalc(vi.x, vf.x, pointsX, ks, ks2);
-    VectorXd solutionY =
-        RRTPlanner::cubicBezierCalc(vi.y, vf.y, pointsY, ks, ks2);
+    VectorXd solutionX, solutionY;
+    RRTPlanner::cubicBezierSolve(vi, vf, pointsX, pointsY, ks, solutionX,
+                                 solutionY);
 
     vector<CubicBezierControlPoints> path;
 
@@ -535,7 +594,7 @@ std::unique_ptr<Planning::InterpolatedPath> RRTPlanner::generateCubicBezier(
     const std::vector<Geometry2d::Point>& points,
     const Geometry2d::ShapeSet& obstacles,
     const MotionConstraints& motionConstraints, Geometry2d::Point vi,
-    Geometry2d::Point vf) {
+    Geometry2d::Point vf, RJ::Time startTime) {
     const int interpolations = 40;
 
     size_t length = points.size();
@@ -553,10 +612,76 @@ std::unique_ptr<Planning::InterpolatedPath> RRTPlanner::generateCubicBezier(
 
     std::unique_ptr<InterpolatedPath> path = make_unique<InterpolatedPath>();
     path->waypoints = entries;
-    path->setStartTime(RJ::timestamp());
+    path->setStartTime(startTime);
     return path;
 }
 
+void RRTPlanner::cubicBezierSolve(Point vi, Point vf,
+                                  const vector<double>& pointsX,
+                                  const vector<double>& pointsY,
+                                  const vector<double>& ks,
+                                  VectorXd& solutionX, VectorXd& solutionY) {
+    const int curvesNum = pointsX.size() - 1;
+
+    // With w[j] a third of the velocity at point j, curve i's control points
+    // are
+    //     p1 = P[i] + w[i] / k[i]
+    //     p2 = P[i + 1] - w[i + 1] / k[i]
+    // so velocity is continuous by construction.  Continuous acceleration at
+    // each inner point j gives
+    //     k[j - 1] w[j - 1] + 2 (k[j - 1] + k[j]) w[j] + k[j] w[j + 1]
+    //         = k[j]^2 (P[j + 1] - P[j]) + k[j - 1]^2 (P[j] - P[j - 1])
+    // and w at the ends comes from vi and vf.
+    vector<double> wX(curvesNum + 1), wY(curvesNum + 1);
+    wX[0] = vi.x / 3.0;
+    wY[0] = vi.y / 3.0;
+    wX[curvesNum] = vf.x / 3.0;
+    wY[curvesNum] = vf.y / 3.0;
+
+    // Forward elimination.  upper[j] is the coefficient of w[j + 1] left in
+    // row j once its diagonal is scaled to one.
+    vector<double> upper(curvesNum);
+    for (int j = 1; j < curvesNum; ++j) {
+        const double k0 = ks[j - 1], k1 = ks[j];
+        double rhsX = k1 * k1 * (pointsX[j + 1] - pointsX[j]) +
+                      k0 * k0 * (pointsX[j] - pointsX[j - 1]);
+        double rhsY = k1 * k1 * (pointsY[j + 1] - pointsY[j]) +
+                      k0 * k0 * (pointsY[j] - pointsY[j - 1]);
+
+        // The first row has w[0] known, and the others eliminate the row
+        // before them.  Either way w[j - 1] is moved to the right side.
+        double diag = 2 * (k0 + k1);
+        if (j > 1) {
+            diag -= k0 * upper[j - 1];
+        }
+        rhsX -= k0 * wX[j - 1];
+        rhsY -= k0 * wY[j - 1];
+        if (j == curvesNum - 1) {
+            rhsX -= k1 * wX[curvesNum];
+            rhsY -= k1 * wY[curvesNum];
+        }
+
+        upper[j] = j < curvesNum - 1 ? k1 / diag : 0;
+        wX[j] = rhsX / diag;
+        wY[j] = rhsY / diag;
+    }
+
+    // Back substitution
+    for (int j = curvesNum - 2; j >= 1; --j) {
+        wX[j] -= upper[j] * wX[j + 1];
+        wY[j] -= upper[j] * wY[j + 1];
+    }
+
+    solutionX.resize(curvesNum * 2);
+    solutionY.resize(curvesNum * 2);
+    for (int i = 0; i < curvesNum; ++i) {
+        solutionX(i * 2) = pointsX[i] + wX[i] / ks[i];
+        solutionY(i * 2) = pointsY[i] + wY[i] / ks[i];
+        solutionX(i * 2 + 1) = pointsX[i + 1] - wX[i + 1] / ks[i];
+        solutionY(i * 2 + 1) = pointsY[i + 1] - wY[i + 1] / ks[i];
+    }
+}
+
 VectorXd RRTPlanner::cubicBezierCalc(double vi, double vf,
                                      vector<double>& points, vector<double>& ks,
                                      vector<double>& ks2) {
@@ -57,7 +57,45 @@ public:
         const std::vector<Geometry2d::Point>& points,
         const Geometry2d::ShapeSet& obstacles,
         const MotionConstraints& motionConstraints, Geometry2d::Point vi,
-        Geometry2d::Point vf);
+        Geometry2d::Point vf, RJ::Time startTime);
+
+    /**
+     * Solves for the inner control points of the cubic bezier curves through
+     * @points in x and y at once, with the velocity and acceleration continuous
+     * where curves meet.
+     *
+     * Curve i goes from points[i] to points[i + 1] in 1 / ks[i] seconds.  The
+     * unknowns are the velocities at the inner points, which form a
+     * tridiagonal, diagonally dominant system.  It is solved in O(n) by the
+     * Thomas algorithm, eliminating once for both x and y.
+     *
+     * @param solutionX,solutionY Set to the control points' coordinates in the
+     *     same layout as cubicBezierCalc(): p1 of curve i at 2 * i and p2 at
+     *     2 * i + 1
+     */
+    static void cubicBezierSolve(Geometry2d::Point vi, Geometry2d::Point vf,
+                                 const std::vector<double>& pointsX,
+                                 const std::vector<double>& pointsY,
+                                 const std::vector<double>& ks,
+                                 Eigen::VectorXd& solutionX,
+                                 Eigen::VectorXd& solutionY);
+
+    /**
+     * Solves the same cubic bezier equations as cubicBezierSolve() for one
+     * coordinate with a dense QR decomposition, where ks2[i] is ks[i] squared.
+     * This is much slower and is kept as a reference for testing.
+     */
+    static Eigen::VectorXd cubicBezierCalc(double vi, double vf,
+                                           std::vector<double>& points,
+                                           std::vector<double>& ks,
+                                           std::vector<double>& ks2);
+
+    static void createConfiguration(Configuration* cfg);
+
+    /// If true, replanning reuses the previous plan's waypoints and goal tree
+    /// instead of growing both RRTs from scratch (see runRRT())
+    static bool incrementalReplan() { return *_incrementalReplan; }
+    static void incrementalReplan(bool value) { *_incrementalReplan = value; }
 
     // Overridden methods
 
@@ -66,8 +104,8 @@ public:
     }
 
     std::unique_ptr<Path> run(
-        MotionInstant start, const MotionCommand* cmd,
-        const MotionConstraints& motionConstraints,
+        MotionInstant start, RJ::Time startTime,
+        const MotionCommand* cmd, const MotionConstraints& motionConstraints,
         const Geometry2d::ShapeSet* obstacles,
         std::unique_ptr<Path> prevPath = nullptr) override;
 
@@ -76,9 +114,25 @@ protected:
     /// this does not include connect attempts
     unsigned int _maxIterations;
 
+    /// RRT trees used by runRRT(), kept between plans so their storage is
+    /// reused
+    FixedStepTree _startTree;
+    FixedStepTree _goalTree;
+
+    /// Waypoints of the last plan after optimization, and the goal it was
+    /// planned to, for incremental replanning
+    std::vector<Geometry2d::Point> _prevWaypoints;
+    boost::optional<Geometry2d::Point> _prevGoal;
+
+    /// Adds the part of _prevWaypoints ahead of the start tree's root that is
+    /// still clear of obstacles to the start tree, as a chain from the root.
+    /// The chain ends at the waypoint nearest @goal.
+    void addPreviousPrefix(Geometry2d::Point goal);
+
     /// Check to see if the previous path (if any) should be discarded and
     /// replaced with a newly-planned one
-    bool shouldReplan(MotionInstant start, MotionInstant goal,
+    bool shouldReplan(MotionInstant start, RJ::Time startTime,
+                      MotionInstant goal,
                       const MotionConstraints& motionConstraints,
                       const Geometry2d::ShapeSet* obstacles,
                       const Path* prevPath) const;
@@ -102,7 +156,7 @@ protected:
         const std::vector<Geometry2d::Point>& points,
         const Geometry2d::ShapeSet& obstacles,
         const MotionConstraints& motionConstraints, Geometry2d::Point vi,
-        Geometry2d::Point vf);
+        Geometry2d::Point vf, RJ::Time startTime);
 
     /**
      *  Removes unnecesary waypoints in the path
@@ -142,14 +196,7 @@ protected:
         const MotionConstraints& motionConstraints, Geometry2d::Point vi,
         Geometry2d::Point vf);
 
-    /**
-     * Helper function for cubicBezier() which uses Eigen matrices to solve for
-     * the
-     * cubic bezier equations.
-     */
-    static Eigen::VectorXd cubicBezierCalc(double vi, double vf,
-                                           std::vector<double>& points,
-                                           std::vector<double>& ks,
-                                           std::vector<double>& ks2);
+private:
+    static ConfigBool* _incrementalReplan;
 };
 }  // namespace Planning
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <planning/RRTPlanner.hpp>
+#include <Geometry2d/Rect.hpp>
+
+#include <random>
+
+using namespace std;
+using namespace Geometry2d;
+using namespace Eigen;
+
+namespace Planning {
+
+TEST(RRTPlanner, cubicBezierSolveMatchesQR) {
+    mt19937 gen(1);
+    uniform_real_distribution<double> posDist(-3, 3);
+    uniform_real_distribution<double> kDist(0.3, 5);
+
+    for (int n = 2; n < 30; ++n) {
+        vector<double> pointsX(n), pointsY(n), ks(n - 1), ks2(n - 1);
+        for (int i = 0; i < n; ++i) {
+            pointsX[i] = posDist(gen);
+            pointsY[i] = posDist(gen);
+        }
+        for (int i = 0; i < n - 1; ++i) {
+            ks[i] = kDist(gen);
+            ks2[i] = ks[i] * ks[i];
+        }
+        Point vi(posDist(gen), posDist(gen));
+        Point vf(posDist(gen), posDist(gen));
+
+        VectorXd solutionX, solutionY;
+        RRTPlanner::cubicBezierSolve(vi, vf, pointsX, pointsY, ks, solutionX,
+                                     solutionY);
+        VectorXd expectedX =
+            RRTPlanner::cubicBezierCalc(vi.x, vf.x, pointsX, ks, ks2);
+        VectorXd expectedY =
+            RRTPlanner::cubicBezierCalc(vi.y, vf.y, pointsY, ks, ks2);
+
+        ASSERT_EQ(expectedX.size(), solutionX.size());
+        ASSERT_EQ(expectedY.size(), solutionY.size());
+        for (int i = 0; i < expectedX.size(); ++i) {
+            EXPECT_NEAR(expectedX(i), solutionX(i), 1e-9);
+            EXPECT_NEAR(expectedY(i), solutionY(i), 1e-9);
+        }
+    }
+}
+
+namespace {
+
+// Gives the tests access to runRRT() and the previous plan
+class TestRRTPlanner : public RRTPlanner {
+public:
+    TestRRTPlanner() : RRTPlanner(250) {}
+
+    using RRTPlanner::_prevWaypoints;
+    using RRTPlanner::runRRT;
+
+    // Runs the RRT from @start to @goal and keeps the result as the previous
+    // plan, as run() does
+    vector<Point> plan(Point start, Point goal, const ShapeSet& obstacles) {
+        vector<Point> points =
+            runRRT(MotionInstant(start), MotionInstant(goal),
+                   MotionConstraints(), &obstacles);
+        _prevWaypoints = points;
+        return points;
+    }
+};
+
+// Checks that @points go from @start to @goal without hitting @obstacles
+void expectClearPath(const vector<Point>& points, Point start, Point goal,
+                     const ShapeSet& obstacles) {
+    ASSERT_GE(points.size(), 2u);
+    EXPECT_EQ(start, points.front());
+    EXPECT_EQ(goal, points.back());
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        EXPECT_FALSE(obstacles.anyHit(Segment(points[i], points[i + 1])))
+            << points[i] << " to " << points[i + 1];
+    }
+}
+
+}  // namespace
+
+TEST(RRTPlanner, incrementalReplanAroundMovedObstacle) {
+    RRTPlanner::incrementalReplan(true);
+
+    const Point start(0, 1), goal(0, 5);
+    ShapeSet obstacles;
+    TestRRTPlanner planner;
+    expectClearPath(planner.plan(start, goal, obstacles), start, goal,
+                    obstacles);
+
+    // An obstacle moves onto the old path
+    obstacles.add(make_shared<Rect>(Point(-0.5, 2.9), Point(0.5, 3.1)));
+    expectClearPath(planner.plan(start, goal, obstacles), start, goal,
+                    obstacles);
+
+    // It moves again, and the robot has moved along the path
+    obstacles.clear();
+    obstacles.add(make_shared<Rect>(Point(-1, 3.9), Point(1, 4.1)));
+    const Point moved = planner._prevWaypoints[1];
+    expectClearPath(planner.plan(moved, goal, obstacles), moved, goal,
+                    obstacles);
+
+    RRTPlanner::incrementalReplan(false);
+}
+
+TEST(RRTPlanner, incrementalReplanToMovedGoal) {
+    RRTPlanner::incrementalReplan(true);
+
+    const Point start(0, 2);
+    ShapeSet obstacles;
+    TestRRTPlanner planner;
+    expectClearPath(planner.plan(start, Point(0, 5), obstacles), start,
+                    Point(0, 5), obstacles);
+
+    // The goal moves behind the robot.  The new path shouldn't go through the
+    // old goal first.
+    const Point goal(0, 0.5);
+    vector<Point> points = planner.plan(start, goal, obstacles);
+    expectClearPath(points, start, goal, obstacles);
+    for (Point pt : points) {
+        EXPECT_LE(pt.y, start.y) << pt;
+    }
+
+    // The goal moves by less than goalChangeThreshold, so the goal tree is
+    // kept.  The new path should still end at the new goal.
+    const Point nearby(0.02, 0.5);
+    points = planner.plan(start, nearby, obstacles);
+    expectClearPath(points, start, nearby, obstacles);
+    for (Point pt : points) {
+        EXPECT_LE(pt.y, start.y) << pt;
+    }
+
+    RRTPlanner::incrementalReplan(false);
+}
+
+}  // namespace Planning
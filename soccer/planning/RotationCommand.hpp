@@ -2,6 +2,8 @@
 
 #include "Geometry2d/Point.hpp"
 
+#include <memory>
+
 namespace Planning {
 struct RotationCommand {
 public:
@@ -10,6 +12,7 @@ public:
     virtual ~RotationCommand() = default;
 
     CommandType getCommandType() const { return commandType; }
+    virtual std::unique_ptr<RotationCommand> clone() const = 0;
 
 protected:
     RotationCommand(CommandType command) : commandType(command) {}
@@ -22,6 +25,10 @@ struct FacePointCommand : public RotationCommand {
     explicit FacePointCommand(Geometry2d::Point target)
         : RotationCommand(FacePoint), targetPos(target) {}
 
+    std::unique_ptr<RotationCommand> clone() const override {
+        return std::make_unique<FacePointCommand>(targetPos);
+    }
+
     const Geometry2d::Point targetPos;
 };
 
@@ -29,10 +36,18 @@ struct FaceAngleCommand : public RotationCommand {
     explicit FaceAngleCommand(float radians)
         : RotationCommand(FaceAngle), targetAngle(radians) {}
 
+    std::unique_ptr<RotationCommand> clone() const override {
+        return std::make_unique<FaceAngleCommand>(targetAngle);
+    }
+
     const float targetAngle;
 };
 
 struct EmptyAngleCommand : public RotationCommand {
     EmptyAngleCommand() : RotationCommand(None) {}
+
+    std::unique_ptr<RotationCommand> clone() const override {
+        return std::make_unique<EmptyAngleCommand>();
+    }
 };
 }
\ No newline at end of file
@@ -80,7 +80,8 @@ angleFunctionForCommandType(const Planning::RotationCommand& command) {
 }
 
 bool SingleRobotPathPlanner::shouldReplan(
-    MotionInstant currentInstant, const MotionConstraints& motionConstraints,
+    MotionInstant currentInstant, RJ::Time currentTime,
+    const MotionConstraints& motionConstraints,
     const Geometry2d::ShapeSet* obstacles, const Path* prevPath) {
     if (!prevPath) return true;
 
@@ -88,13 +89,13 @@ bool SingleRobotPathPlanner::shouldReplan(
     // automatically replan
     const RJ::Time kPathExpirationInterval =
         RJ::SecsToTimestamp(replanTimeout());
-    if ((RJ::timestamp() - prevPath->startTime()) > kPathExpirationInterval) {
+    if ((currentTime - prevPath->startTime()) > kPathExpirationInterval) {
         return true;
     }
 
     // Evaluate where the path says the robot should be right now
     float timeIntoPath =
-        RJ::TimestampToSecs((RJ::timestamp() - prevPath->startTime())) +
+        RJ::TimestampToSecs((currentTime - prevPath->startTime())) +
         1.0f / 60.0f;
     boost::optional<RobotInstant> optTarget = prevPath->evaluate(timeIntoPath);
     // If we went off the end of the path, use the end for calculations.
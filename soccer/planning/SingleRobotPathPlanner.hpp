@@ -7,6 +7,9 @@
 #include <planning/Path.hpp>
 #include "planning/RotationCommand.hpp"
 
+#include <random>
+#include <stdlib.h>
+
 namespace Planning {
 
 /**
@@ -14,12 +17,18 @@ namespace Planning {
  */
 class SingleRobotPathPlanner {
 public:
+    SingleRobotPathPlanner() : _random(lrand48()) {}
+    virtual ~SingleRobotPathPlanner() {}
+
     /**
      * Returns an obstacle-free Path subject to the specified MotionContraints.
+     *
+     * @param startTime Time at which the robot is at @startInstant.  New paths
+     *     start at this time.
      */
     virtual std::unique_ptr<Path> run(
-        MotionInstant startInstant, const MotionCommand* cmd,
-        const MotionConstraints& motionConstraints,
+        MotionInstant startInstant, RJ::Time startTime,
+        const MotionCommand* cmd, const MotionConstraints& motionConstraints,
         const Geometry2d::ShapeSet* obstacles,
         std::unique_ptr<Path> prevPath = nullptr) = 0;
 
@@ -42,10 +51,18 @@ public:
     /// Subclasses will generally use this method in addition to their own
     /// planner-specific checks to determine if a replan is necessary.
     static bool shouldReplan(MotionInstant currentInstant,
+                             RJ::Time currentTime,
                              const MotionConstraints& motionConstraints,
                              const Geometry2d::ShapeSet* obstacles,
                              const Path* prevPath);
 
+protected:
+    /// Random number source for randomized planners.  Each planner has its
+    /// own so planners for different robots can run on different threads and
+    /// still give repeatable results.  It is seeded from lrand48() so the
+    /// global seed (soccer -s) still determines the whole run.
+    std::mt19937 _random;
+
 private:
     static ConfigDouble* _goalChangeThreshold;
     static ConfigDouble* _replanTimeout;
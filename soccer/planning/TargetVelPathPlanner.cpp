@@ -57,7 +57,7 @@ Point TargetVelPathPlanner::calculateNonblockedPathEndpoint(
 }
 
 bool TargetVelPathPlanner::shouldReplan(
-    MotionInstant startInstant, const MotionCommand* cmd,
+    MotionInstant startInstant, RJ::Time startTime, const MotionCommand* cmd,
     const MotionConstraints& motionConstraints,
     const Geometry2d::ShapeSet* obstacles, const Path* prevPath) {
     // TODO Undo this hack to use TargetVelPlanner to do Pivot
@@ -71,8 +71,9 @@ bool TargetVelPathPlanner::shouldReplan(
         throw("That Command is not support by the TargetVelPathPlanner");
     }();
 
-    if (SingleRobotPathPlanner::shouldReplan(startInstant, motionConstraints,
-                                             obstacles, prevPath))
+    if (SingleRobotPathPlanner::shouldReplan(startInstant, startTime,
+                                             motionConstraints, obstacles,
+                                             prevPath))
         return true;
 
     // See if obstacles have changed such that the end point is significantly
@@ -104,15 +105,15 @@ bool TargetVelPathPlanner::shouldReplan(
 // TODO(justbuchanan): Paths aren't dynamically feasible sometimes because it
 // doesn't account for initial velocity
 std::unique_ptr<Path> TargetVelPathPlanner::run(
-    MotionInstant startInstant, const MotionCommand* cmd,
-    const MotionConstraints& motionConstraints,
+    MotionInstant startInstant, RJ::Time startTime,
+    const MotionCommand* cmd, const MotionConstraints& motionConstraints,
     const Geometry2d::ShapeSet* obstacles, std::unique_ptr<Path> prevPath) {
     // If the start point is in an obstacle, escape from it
     if (obstacles->hit(startInstant.pos)) {
-        EscapeObstaclesPathPlanner escapePlanner;
         EmptyCommand emptyCommand;
-        return escapePlanner.run(startInstant, &emptyCommand, motionConstraints,
-                                 obstacles, std::move(prevPath));
+        return _escapePlanner.run(startInstant, startTime, &emptyCommand,
+                                  motionConstraints, obstacles,
+                                  std::move(prevPath));
     }
 
     // TODO Undo this hack to use TargetVelPlanner to do Pivot
@@ -126,7 +127,7 @@ std::unique_ptr<Path> TargetVelPathPlanner::run(
         throw("That Command is not support by the TargetVelPathPlanner");
     }();
 
-    if (shouldReplan(startInstant, cmd, motionConstraints, obstacles,
+    if (shouldReplan(startInstant, startTime, cmd, motionConstraints, obstacles,
                      prevPath.get())) {
         // Choose the furthest endpoint we can that doesn't hit obstacles
         Point endpoint = calculateNonblockedPathEndpoint(
@@ -139,7 +140,7 @@ std::unique_ptr<Path> TargetVelPathPlanner::run(
         auto path = std::unique_ptr<Path>(
             new TrapezoidalPath(startInstant.pos, startInstant.vel.mag(),
                                 endpoint, 0, moddedConstraints));
-        path->setStartTime(RJ::timestamp());
+        path->setStartTime(startTime);
         return std::move(path);
     } else {
         return std::move(prevPath);
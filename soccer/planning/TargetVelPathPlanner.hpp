@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SingleRobotPathPlanner.hpp"
+#include "EscapeObstaclesPathPlanner.hpp"
 #include <Geometry2d/Point.hpp>
 
 class Configuration;
@@ -13,8 +14,8 @@ namespace Planning {
 class TargetVelPathPlanner : public SingleRobotPathPlanner {
 public:
     virtual std::unique_ptr<Path> run(
-        MotionInstant startInstant, const MotionCommand* cmd,
-        const MotionConstraints& motionConstraints,
+        MotionInstant startInstant, RJ::Time startTime,
+        const MotionCommand* cmd, const MotionConstraints& motionConstraints,
         const Geometry2d::ShapeSet* obstacles,
         std::unique_ptr<Path> prevPath = nullptr) override;
 
@@ -25,7 +26,8 @@ public:
     static void createConfiguration(Configuration* cfg);
 
 private:
-    bool shouldReplan(MotionInstant startInstant, const MotionCommand* cmd,
+    bool shouldReplan(MotionInstant startInstant, RJ::Time startTime,
+                      const MotionCommand* cmd,
                       const MotionConstraints& motionConstraints,
                       const Geometry2d::ShapeSet* obstacles,
                       const Path* prevPath);
@@ -33,6 +35,11 @@ private:
         Geometry2d::Point start, Geometry2d::Point dir,
         const Geometry2d::ShapeSet* obstacles);
 
+    /// Used when the robot starts inside an obstacle.  This is a member so it
+    /// is seeded when this planner is created, on the thread that picks
+    /// planners, and not on whichever thread runs it.
+    EscapeObstaclesPathPlanner _escapePlanner;
+
     /// If the desired target velocity changes by this much, the path is
     /// replanned
     static ConfigDouble* _targetVelChangeReplanThreshold;
@@ -39,24 +39,29 @@ boost::optional<RobotInstant> TrapezoidalPath::evaluate(float time) const {
 
 bool TrapezoidalPath::hit(const Geometry2d::ShapeSet& obstacles, float& hitTime,
                           float initialTime) const {
-    std::set<std::shared_ptr<Shape>> startHitSet = obstacles.hitSet(_startPos);
-    for (float t = initialTime; t < _duration; t += 0.1) {
-        auto instant = evaluate(t);
-        if (instant) {
-            for (auto& shape : obstacles.shapes()) {
-                // If the shape is in the original hitSet, it is ignored
-                if (startHitSet.find(shape) != startHitSet.end()) {
-                    continue;
-                }
+    if (initialTime >= _duration) {
+        return false;
+    }
+    auto instant = evaluate(initialTime);
+    if (!instant) {
+        return false;
+    }
 
-                if (shape->hit(instant->motion.pos)) {
-                    hitTime = t;
-                    return true;
-                }
-            }
-        }
+    // The path is a straight line, so find where the rest of it first touches
+    // an obstacle and convert that distance back to a time.
+    std::set<std::shared_ptr<Shape>> startHitSet = obstacles.hitSet(_startPos);
+    const Point from = instant->motion.pos;
+    const float contact =
+        obstacles.firstHitDistance(Segment(from, _endPos), startHitSet);
+    if (contact < 0) {
+        return false;
     }
-    return false;
+
+    const float distance = (from - _startPos).mag() + contact;
+    hitTime = std::max(initialTime,
+                       Trapezoidal::getTime(distance, _pathLength, _maxSpeed,
+                                            _maxAcc, _startSpeed, _endSpeed));
+    return true;
 }
 
 std::unique_ptr<Path> TrapezoidalPath::subPath(float startTime,
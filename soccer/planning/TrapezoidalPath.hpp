@@ -37,9 +37,15 @@ public:
                     Geometry2d::Point endPos, float endSpeed,
                     const MotionConstraints& constraints);
 
+    using Path::evaluate;
     virtual boost::optional<RobotInstant> evaluate(float time) const override;
 
-    // TODO: only return true for *new* obstacles
+    /**
+     * Checks the rest of the line after @initialTime against the obstacles
+     * with one segment test, then maps the distance to the first contact back
+     * to a time through the trapezoidal profile.  Obstacles that contain the
+     * start of the path are ignored.
+     */
     virtual bool hit(const Geometry2d::ShapeSet& obstacles, float& hitTime,
                      float initialTime = 0) const override;
 
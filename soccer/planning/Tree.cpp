@@ -3,46 +3,31 @@
 #include <Utils.hpp>
 
 #include <stdio.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace Planning;
 using namespace std;
 
-//// Point ////
-Tree::Point::Point(Geometry2d::Point p, Tree::Point* parent) : pos(p) {
-    _parent = parent;
-    leaf = true;
-
-    if (_parent) {
-        _parent->children.push_back(this);
-        _parent->leaf = false;
-    }
-}
-
-void Tree::Point::addEdges(std::list<Geometry2d::Segment>& edges) {
-    for (Tree::Point* next : children) {
-        edges.push_back(Geometry2d::Segment(pos, next->pos));
-        next->addEdges(edges);
-    }
-}
-
 //// Tree ////
 
 Tree::Tree() {
     step = .1;
+    indexCellSize = DefaultIndexCellSize;
+    _cellSize = indexCellSize;
+    _maskWords = 0;
     _obstacles = nullptr;
 }
 
-Tree::~Tree() { clear(); }
-
 void Tree::clear() {
     _obstacles = nullptr;
 
-    // Delete all points
-    for (Point* pt : points) {
-        delete pt;
+    _points.clear();
+    _hitMasks.clear();
+    for (auto& cell : _cells) {
+        cell.second.clear();
     }
-    points.clear();
 }
 
 void Tree::init(Geometry2d::Point start,
@@ -50,133 +35,222 @@ void Tree::init(Geometry2d::Point start,
     clear();
 
     _obstacles = obstacles;
+    _maskWords = _obstacles->maskWords();
 
-    Point* p = new Point(start, nullptr);
-    p->hit = _obstacles->hitSet(p->pos);
-    points.push_back(p);
+    // Cells are only kept for reuse while they're the same size
+    if (_cellSize != indexCellSize) {
+        _cellSize = indexCellSize;
+        _cells.clear();
+    }
+
+    int root = addPoint(start, -1);
+    _obstacles->hitMask(start, hitMask(root));
 }
 
-void Tree::addPath(vector<Geometry2d::Point>& path, Point* dest,
-                   const bool rev) const {
-    list<Point*> points;
-
-    int n = 0;
-    while (dest) {
-        if (rev) {
-            points.push_back(dest);
-        } else {
-            points.push_front(dest);
+void Tree::repair(Geometry2d::Point root,
+                  const Geometry2d::ShapeSet* obstacles) {
+    // Move the old points aside and rebuild the tree in place.  Parents were
+    // always added before their children, so one pass in order is enough.
+    _repairPoints.assign(_points.begin(), _points.end());
+    _repairIndex.assign(_repairPoints.size(), -1);
+
+    init(root, obstacles);
+    if (_repairPoints.empty()) {
+        return;
+    }
+
+    _repairIndex[0] = 0;
+    for (size_t i = 1; i < _repairPoints.size(); ++i) {
+        const int parent = _repairIndex[_repairPoints[i].parent];
+        if (parent >= 0) {
+            _repairIndex[i] = addChild(parent, _repairPoints[i].pos);
         }
-        dest = dest->parent();
-        ++n;
+    }
+}
+
+int Tree::addChild(int base, Geometry2d::Point pos) {
+    const Geometry2d::Point basePos = point(base).pos;
+
+    // If this move touches any obstacles that the starting point didn't already
+    // touch, it has entered an obstacle and will be rejected.
+    const Geometry2d::Segment move(pos, basePos);
+    if (_obstacles->anyHit(move, hitMask(base))) {
+        return -1;
     }
 
-    path.reserve(points.size() + n);
+    // Allow this point to be added to the tree
+    const bool baseInObstacle = inObstacle(base);
+    int p = addPoint(pos, base);
 
-    for (Point* pt : points) {
-        // Each point in the path is given a time of zero - the actual time will
-        // be calculated later by the planner
-        path.push_back(pt->pos);
+    // The new point is inside the obstacles that this move touches.  These are
+    // a subset of the base's, so if that's empty there's nothing to look up.
+    if (baseInObstacle) {
+        _obstacles->hitMask(move, hitMask(p));
     }
+
+    return p;
 }
 
-Tree::Point* Tree::nearest(Geometry2d::Point pt) {
+int Tree::addPoint(Geometry2d::Point pos, int parent) {
+    const int i = _points.size();
+    _points.emplace_back(pos, parent);
+    _hitMasks.resize(_hitMasks.size() + _maskWords, 0);
+
+    const int x = cellCoord(pos.x), y = cellCoord(pos.y);
+    _cells[cellKey(x, y)].push_back(i);
+
+    if (i == 0) {
+        _minCellX = _maxCellX = x;
+        _minCellY = _maxCellY = y;
+    } else {
+        _minCellX = min(_minCellX, x);
+        _maxCellX = max(_maxCellX, x);
+        _minCellY = min(_minCellY, y);
+        _maxCellY = max(_maxCellY, y);
+    }
+
+    return i;
+}
+
+bool Tree::inObstacle(int i) const {
+    const uint64_t* mask = hitMask(i);
+    for (int w = 0; w < _maskWords; ++w) {
+        if (mask[w]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tree::addPath(vector<Geometry2d::Point>& path, int dest,
+                   const bool rev) const {
+    const size_t first = path.size();
+    while (dest >= 0) {
+        path.push_back(_points[dest].pos);
+        dest = _points[dest].parent;
+    }
+
+    // Points were added from dest to the root
+    if (!rev) {
+        reverse(path.begin() + first, path.end());
+    }
+}
+
+int Tree::nearest(Geometry2d::Point pt) const {
     float bestDistance = -1;
-    Point* best = nullptr;
+    int best = -1;
 
-    for (Point* other : points) {
-        float d = (other->pos - pt).magsq();
-        if (bestDistance < 0 || d < bestDistance) {
+    if (_points.empty()) {
+        return -1;
+    }
+
+    // Indices are in the order points were added, so ties go to the lower one
+    auto check = [&](int i) {
+        float d = (_points[i].pos - pt).magsq();
+        if (bestDistance < 0 || d < bestDistance ||
+            (d == bestDistance && i < best)) {
             bestDistance = d;
-            best = other;
+            best = i;
+        }
+    };
+
+    // Search rings of cells around the query's cell, working outwards until
+    // no unsearched cell can hold anything closer than the best point found.
+    const int cx = cellCoord(pt.x), cy = cellCoord(pt.y);
+    const int maxRing =
+        max(max(cx - _minCellX, _maxCellX - cx),
+            max(cy - _minCellY, _maxCellY - cy));
+    for (int r = 0; r <= maxRing; ++r) {
+        const int x0 = max(cx - r, _minCellX), x1 = min(cx + r, _maxCellX);
+        const int y0 = max(cy - r, _minCellY), y1 = min(cy + r, _maxCellY);
+
+        // Top and bottom rows of the ring, then the sides between them
+        if (cy - r >= _minCellY) {
+            for (int x = x0; x <= x1; ++x) visitCell(x, cy - r, check);
+        }
+        if (r > 0 && cy + r <= _maxCellY) {
+            for (int x = x0; x <= x1; ++x) visitCell(x, cy + r, check);
+        }
+        for (int y = max(y0, cy - r + 1); y <= min(y1, cy + r - 1); ++y) {
+            if (cx - r >= _minCellX) visitCell(cx - r, y, check);
+            if (r > 0 && cx + r <= _maxCellX) visitCell(cx + r, y, check);
+        }
+
+        // Every cell outside this ring is at least r cells away
+        const float reach = r * _cellSize;
+        if (best >= 0 && bestDistance <= reach * reach) {
+            break;
         }
     }
 
     return best;
 }
 
-Tree::Point* Tree::start() const {
-    if (points.empty()) {
-        return nullptr;
+void Tree::near(Geometry2d::Point pt, float radius,
+                vector<int>& result) const {
+    if (_points.empty()) {
+        return;
     }
 
-    return points.front();
-}
-
-Tree::Point* Tree::last() const {
-    if (points.empty()) {
-        return nullptr;
+    const size_t first = result.size();
+    const float radiusSq = radius * radius;
+    const int x0 = max(cellCoord(pt.x - radius), _minCellX);
+    const int x1 = min(cellCoord(pt.x + radius), _maxCellX);
+    const int y0 = max(cellCoord(pt.y - radius), _minCellY);
+    const int y1 = min(cellCoord(pt.y + radius), _maxCellY);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            visitCell(x, y, [&](int i) {
+                if ((_points[i].pos - pt).magsq() <= radiusSq) {
+                    result.push_back(i);
+                }
+            });
+        }
     }
 
-    return points.back();
+    sort(result.begin() + first, result.end());
 }
 
 //// Fixed Step Tree ////
-Tree::Point* FixedStepTree::extend(Geometry2d::Point pt, Tree::Point* base) {
+int FixedStepTree::extend(Geometry2d::Point pt, int base) {
     // if we don't have a base point, try to find a close point
-    if (!base) {
+    if (base < 0) {
         base = nearest(pt);
-        if (!base) {
-            return nullptr;
+        if (base < 0) {
+            return -1;
         }
     }
 
-    Geometry2d::Point delta = pt - base->pos;
+    const Geometry2d::Point basePos = point(base).pos;
+    Geometry2d::Point delta = pt - basePos;
     float d = delta.mag();
 
     Geometry2d::Point pos;
     if (d < step) {
         pos = pt;
     } else {
-        pos = base->pos + delta / d * step;
-    }
-
-    // Check for obstacles.
-
-    // moveHit is the set of obstacles that this move touches.
-    // If this move touches any obstacles that the starting point didn't already
-    // touch,
-    // it has entered an obstacle and will be rejected.
-    std::set<shared_ptr<Geometry2d::Shape>> moveHit =
-        _obstacles->hitSet(Geometry2d::Segment(pos, base->pos));
-    if (!moveHit.empty()) {
-        // We only care if there are any items in moveHit that are not in
-        // point->hit, so
-        // we don't store the result of set_difference.
-        try {
-            set_difference(
-                moveHit.begin(), moveHit.end(), base->hit.begin(),
-                base->hit.end(),
-                ExceptionIterator<std::shared_ptr<Geometry2d::Shape>>());
-        } catch (exception& e) {
-            // We hit a new obstacle
-            return nullptr;
-        }
+        pos = basePos + delta / d * step;
     }
 
-    // Allow this point to be added to the tree
-    Point* p = new Point(pos, base);
-    p->hit = std::move(moveHit);
-    points.push_back(p);
-
-    return p;
+    // Add the point unless the move runs into an obstacle
+    return addChild(base, pos);
 }
 
 bool FixedStepTree::connect(Geometry2d::Point pt) {
     // try to reach the goal pt
     const unsigned int maxAttemps = 50;
 
-    Point* from = nullptr;
+    int from = -1;
 
     for (unsigned int i = 0; i < maxAttemps; ++i) {
-        Point* newPt = extend(pt, from);
+        int newPt = extend(pt, from);
 
         // died
-        if (!newPt) {
+        if (newPt < 0) {
             return false;
         }
 
-        if (newPt->pos == pt) {
+        if (point(newPt).pos == pt) {
             return true;
         }
 
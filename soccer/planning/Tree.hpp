@@ -1,77 +1,158 @@
 #pragma once
 
-#include <list>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #include <Geometry2d/Segment.hpp>
 #include <planning/InterpolatedPath.hpp>
 
 namespace Planning {
 /** base tree class for rrt trees
- *  Tree can be grown in different ways */
+ *  Tree can be grown in different ways
+ *
+ *  Points are stored contiguously and refer to their parent by index, so a
+ *  point's index stays valid as the tree grows but pointers and references to
+ *  points do not.  Each point records which obstacles it is inside of as a
+ *  bitmask over the ShapeSet, with one bit per shape.
+ *
+ *  clear() and init() keep the tree's storage, so a tree that is reused for
+ *  each plan stops allocating once it has grown to its working size.
+ *
+ *  Points are binned into a uniform grid as they are added so that nearest()
+ *  and near() only look at the cells around the query instead of the whole
+ *  tree. */
 class Tree {
 public:
-    /** base class for a tree point */
-    class Point {
-    public:
-        Point(Geometry2d::Point pos, Point* parent);
+    /** a point in the tree */
+    struct Point {
+        Point(Geometry2d::Point pos, int parent) : pos(pos), parent(parent) {}
 
         // field position of the point
         Geometry2d::Point pos;
 
-        // Which obstacles contain this point
-        std::set<std::shared_ptr<Geometry2d::Shape>> hit;
+        // index of the point this one was grown from, or -1 for the root
+        int parent;
+    };
 
-        // velocity information (used by dynamic tree)
-        Geometry2d::Point vel;
+    /// Default edge length of a cell in the nearest-neighbor grid, in meters
+    static constexpr float DefaultIndexCellSize = 0.5f;
 
-        bool leaf;
+    Tree();
+    virtual ~Tree() {}
 
-        inline Point* parent() const { return _parent; }
+    /** remove all points, keeping the storage for reuse */
+    void clear();
 
-        void addEdges(std::list<Geometry2d::Segment>& edges);
+    void init(Geometry2d::Point start, const Geometry2d::ShapeSet* obstacles);
 
-    private:
-        std::list<Point*> children;
-        Point* _parent;
-    };
+    /** rebuilds the tree against new obstacles, rooted at @a root instead of
+     *  its old root.  Points are re-added in the order they were first added,
+     *  and each one is dropped along with its descendants if the move from
+     *  its parent is now blocked.  Indices of the kept points change. */
+    void repair(Geometry2d::Point root, const Geometry2d::ShapeSet* obstacles);
 
-    Tree();
-    virtual ~Tree();
+    /** adds @a pos to the tree as a child of point @a base, unless the move
+     *  between them enters an obstacle that @a base isn't already in.
+     *  Returns the new point's index, or -1 if the move is blocked. */
+    int addChild(int base, Geometry2d::Point pos);
 
-    /** cleanup the tree */
-    void clear();
+    /** number of points in the tree */
+    int size() const { return _points.size(); }
 
-    void init(Geometry2d::Point start, const Geometry2d::ShapeSet* obstacles);
+    const Point& point(int i) const { return _points[i]; }
+
+    /** true if point @a i is inside any of the obstacles */
+    bool inObstacle(int i) const;
 
-    /** find the point of the tree closest to @a pt */
-    Point* nearest(Geometry2d::Point pt);
+    /** find the index of the point of the tree closest to @a pt, or -1 if the
+     *  tree is empty.  If several are equally close, the one added first is
+     *  returned. */
+    int nearest(Geometry2d::Point pt) const;
+
+    /** appends the indices of all points within @a radius of @a pt to
+     *  @a result, in the order they were added to the tree */
+    void near(Geometry2d::Point pt, float radius,
+              std::vector<int>& result) const;
 
     /** grow the tree in the direction of pt
-     *  returns the new tree point.
-     *  If base == 0, then the closest tree point is used */
-    virtual Point* extend(Geometry2d::Point pt, Point* base = nullptr) = 0;
+     *  returns the index of the new tree point or -1 if it couldn't be added.
+     *  If base < 0, then the closest tree point is used */
+    virtual int extend(Geometry2d::Point pt, int base = -1) = 0;
 
     /** attempt to connect the tree to the point */
     virtual bool connect(const Geometry2d::Point pt) = 0;
 
     /** make a path from the dest point's root to the dest point
      *  If rev is true, the path will be from the dest point to its root */
-    void addPath(std::vector<Geometry2d::Point>& points, Point* dest,
+    void addPath(std::vector<Geometry2d::Point>& points, int dest,
                  const bool rev = false) const;
 
-    /** returns the first point or 0 if none */
-    Point* start() const;
+    /** returns the index of the first point or -1 if none */
+    int start() const { return _points.empty() ? -1 : 0; }
 
-    /** last point added */
-    Point* last() const;
+    /** index of the last point added or -1 if none */
+    int last() const { return (int)_points.size() - 1; }
 
     /** tree step size...interpreted differently for different trees */
     float step;
 
-    std::list<Point*> points;
+    /** edge length of a cell in the nearest-neighbor grid.  Changes take
+     *  effect at the next init(). */
+    float indexCellSize;
 
 protected:
+    /** adds a new point to the tree and to the grid.  Its obstacle mask is
+     *  cleared.  Returns the new point's index. */
+    int addPoint(Geometry2d::Point pos, int parent);
+
+    /** obstacle mask of point @a i, with ShapeSet::maskWords() words.  That
+     *  can be zero, so this must not index _hitMasks. */
+    uint64_t* hitMask(int i) { return _hitMasks.data() + i * _maskWords; }
+    const uint64_t* hitMask(int i) const {
+        return _hitMasks.data() + i * _maskWords;
+    }
+
     const Geometry2d::ShapeSet* _obstacles;
+
+private:
+    typedef int64_t CellKey;
+
+    int cellCoord(float v) const { return (int)floorf(v / _cellSize); }
+
+    static CellKey cellKey(int x, int y) {
+        return (CellKey)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y);
+    }
+
+    /// Calls @visit(i) for each point in cell (x, y), if there are any
+    template <typename Visitor>
+    void visitCell(int x, int y, Visitor visit) const {
+        auto it = _cells.find(cellKey(x, y));
+        if (it != _cells.end()) {
+            for (int i : it->second) {
+                visit(i);
+            }
+        }
+    }
+
+    std::vector<Point> _points;
+
+    // Obstacle masks for all points, _maskWords words per point
+    int _maskWords;
+    std::vector<uint64_t> _hitMasks;
+
+    // Grid of point indices, keyed by cell.  Each cell lists its points in the
+    // order they were added.  Cells are emptied rather than removed by clear()
+    // so their storage can be reused.
+    float _cellSize;
+    std::unordered_map<CellKey, std::vector<int>> _cells;
+
+    // Range of cells that contain at least one point
+    int _minCellX, _minCellY, _maxCellX, _maxCellY;
+
+    // Scratch space for repair(), kept so repairs don't allocate
+    std::vector<Point> _repairPoints;
+    std::vector<int> _repairIndex;
 };
 
 /** tree that grows based on fixed distance step */
@@ -79,8 +160,7 @@ class FixedStepTree : public Tree {
 public:
     FixedStepTree() {}
 
-    Tree::Point* extend(Geometry2d::Point pt,
-                        Tree::Point* base = nullptr) override;
+    int extend(Geometry2d::Point pt, int base = -1) override;
     bool connect(Geometry2d::Point pt) override;
 };
 }
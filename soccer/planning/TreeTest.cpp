@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "Tree.hpp"
+#include <Geometry2d/Rect.hpp>
+#include <Constants.hpp>
+
+#include <random>
+
+using namespace std;
+
+namespace Planning {
+
+// Brute-force version of Tree::nearest()
+static int linearNearest(const Tree& tree, Geometry2d::Point pt) {
+    float bestDistance = -1;
+    int best = -1;
+    for (int i = 0; i < tree.size(); ++i) {
+        float d = (tree.point(i).pos - pt).magsq();
+        if (bestDistance < 0 || d < bestDistance) {
+            bestDistance = d;
+            best = i;
+        }
+    }
+    return best;
+}
+
+TEST(Tree, nearestMatchesLinearScan) {
+    Geometry2d::ShapeSet obstacles;
+    obstacles.add(
+        make_shared<Geometry2d::Rect>(Geometry2d::Point(-1, 3),
+                                      Geometry2d::Point(1, 3.2)));
+
+    mt19937 gen(3);
+    uniform_real_distribution<float> xDist(-3, 3), yDist(-0.5, 9.5);
+
+    FixedStepTree tree;
+    tree.step = 0.15;
+    tree.init(Geometry2d::Point(0, 1), &obstacles);
+    for (int i = 0; i < 1000; ++i) {
+        tree.extend(Geometry2d::Point(xDist(gen), yDist(gen)));
+    }
+    ASSERT_GT(tree.size(), 100);
+
+    for (int i = 0; i < 1000; ++i) {
+        // Include some queries well outside the tree
+        Geometry2d::Point pt(xDist(gen) * 2, yDist(gen) * 2 - 5);
+        EXPECT_EQ(linearNearest(tree, pt), tree.nearest(pt));
+
+        vector<int> nearby;
+        tree.near(pt, 0.4, nearby);
+        vector<int> expected;
+        for (int j = 0; j < tree.size(); ++j) {
+            if ((tree.point(j).pos - pt).mag() <= 0.4) {
+                expected.push_back(j);
+            }
+        }
+        EXPECT_EQ(expected, nearby);
+    }
+}
+
+TEST(Tree, nearestPrefersFirstAdded) {
+    Geometry2d::ShapeSet obstacles;
+    FixedStepTree tree;
+    tree.step = 10;
+    tree.init(Geometry2d::Point(0, 5), &obstacles);
+    int a = tree.extend(Geometry2d::Point(1, 0), tree.start());
+    int b = tree.extend(Geometry2d::Point(-1, 0), tree.start());
+    ASSERT_TRUE(a >= 0 && b >= 0);
+
+    // a and b are the same distance from the origin
+    EXPECT_EQ(a, tree.nearest(Geometry2d::Point(0, 0)));
+    EXPECT_EQ(b, tree.nearest(Geometry2d::Point(-0.1, 0)));
+}
+
+TEST(Tree, escapesObstacle) {
+    Geometry2d::ShapeSet obstacles;
+    obstacles.add(make_shared<Geometry2d::Rect>(Geometry2d::Point(-1, -1),
+                                                Geometry2d::Point(1, 1)));
+
+    FixedStepTree tree;
+
+    // Run twice to make sure a reused tree starts over
+    for (int run = 0; run < 2; ++run) {
+        tree.step = 0.5;
+        tree.init(Geometry2d::Point(0, 0), &obstacles);
+        ASSERT_EQ(1, tree.size());
+        EXPECT_TRUE(tree.inObstacle(tree.start()));
+
+        // Moving within the obstacle the tree started in is allowed
+        ASSERT_TRUE(tree.connect(Geometry2d::Point(3, 0)));
+        EXPECT_TRUE(tree.inObstacle(1));
+        EXPECT_FALSE(tree.inObstacle(tree.last()));
+
+        vector<Geometry2d::Point> path;
+        tree.addPath(path, tree.last());
+        ASSERT_EQ(tree.size(), path.size());
+        EXPECT_EQ(Geometry2d::Point(0, 0), path.front());
+        EXPECT_EQ(Geometry2d::Point(3, 0), path.back());
+
+        // Once outside, the tree can't go back in
+        tree.step = 5;
+        EXPECT_EQ(-1, tree.extend(Geometry2d::Point(0, 0), tree.last()));
+    }
+}
+
+TEST(Tree, repairCutsBlockedBranches) {
+    Geometry2d::ShapeSet empty;
+    FixedStepTree tree;
+    tree.step = 0.5;
+    tree.init(Geometry2d::Point(0, 0), &empty);
+
+    // One branch up the y axis and one along the x axis
+    ASSERT_TRUE(tree.connect(Geometry2d::Point(0, 3)));
+    ASSERT_TRUE(tree.connect(Geometry2d::Point(3, 0)));
+    ASSERT_EQ(13, tree.size());
+
+    // A wall across the y axis branch cuts it off above the wall
+    Geometry2d::ShapeSet obstacles;
+    obstacles.add(make_shared<Geometry2d::Rect>(Geometry2d::Point(-1, 1.6),
+                                                Geometry2d::Point(1, 1.7)));
+    tree.repair(Geometry2d::Point(0.05, 0), &obstacles);
+
+    EXPECT_EQ(Geometry2d::Point(0.05, 0), tree.point(tree.start()).pos);
+    ASSERT_EQ(10, tree.size());
+    for (int i = 1; i < tree.size(); ++i) {
+        const Geometry2d::Point pos = tree.point(i).pos;
+        EXPECT_LT(pos.y, 1.6 - Robot_Radius);
+        EXPECT_FALSE(obstacles.anyHit(
+            Geometry2d::Segment(tree.point(tree.point(i).parent).pos, pos)));
+    }
+
+    // The x axis branch is all there and still ends at its target
+    EXPECT_EQ(Geometry2d::Point(3, 0), tree.point(tree.last()).pos);
+    EXPECT_EQ(tree.last(), tree.nearest(Geometry2d::Point(3, 0)));
+}
+
+}  // namespace Planning
@@ -1,13 +1,13 @@
 #include "Util.hpp"
 #include "Field_Dimensions.hpp"
-#include <stdlib.h>
 
 namespace Planning {
 
-Geometry2d::Point RandomFieldLocation() {
+Geometry2d::Point RandomFieldLocation(std::mt19937& random) {
+    std::uniform_real_distribution<float> unit(0, 1);
     const auto& dims = Field_Dimensions::Current_Dimensions;
-    float x = dims.FloorWidth() * (drand48() - 0.5f);
-    float y = dims.FloorLength() * drand48() - dims.Border();
+    float x = dims.FloorWidth() * (unit(random) - 0.5f);
+    float y = dims.FloorLength() * unit(random) - dims.Border();
 
     return Geometry2d::Point(x, y);
 }
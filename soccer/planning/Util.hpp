@@ -2,10 +2,12 @@
 
 #include <Geometry2d/Point.hpp>
 
+#include <random>
+
 namespace Planning {
 
 /// Returns a randomly-generated Point within the bounds of the field. Useful
 /// for randomized planning (i.e. RRT)
-Geometry2d::Point RandomFieldLocation();
+Geometry2d::Point RandomFieldLocation(std::mt19937& random);
 
 }  // namespace Planning
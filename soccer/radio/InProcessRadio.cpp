@@ -0,0 +1,38 @@
+#include "InProcessRadio.hpp"
+
+using namespace std;
+using namespace Packet;
+
+InProcessRadio::InProcessRadio(bool blueTeam) { _blueTeam = blueTeam; }
+
+bool InProcessRadio::isOpen() const { return true; }
+
+void InProcessRadio::send(Packet::RadioTx& packet) { _sent.push_back(packet); }
+
+void InProcessRadio::receive() {
+    for (RadioRx& rx : _pendingReverse) {
+        _reversePackets.push_back(RadioRx());
+        _reversePackets.back().Swap(&rx);
+    }
+    _pendingReverse.clear();
+}
+
+void InProcessRadio::switchTeam(bool blueTeam) {
+    _blueTeam = blueTeam;
+
+    // Anything in flight was for the other team's robots
+    _sent.clear();
+    _pendingReverse.clear();
+}
+
+void InProcessRadio::takeSent(vector<RadioTx>& packets) {
+    for (RadioTx& tx : _sent) {
+        packets.push_back(RadioTx());
+        packets.back().Swap(&tx);
+    }
+    _sent.clear();
+}
+
+void InProcessRadio::addReverse(const Packet::RadioRx& packet) {
+    _pendingReverse.push_back(packet);
+}
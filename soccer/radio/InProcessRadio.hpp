@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Radio.hpp"
+
+/**
+ * @brief Radio IO with a simulator running in the same process
+ *
+ * @details Instead of using sockets like SimRadio, packets are kept in
+ * in-memory queues.  Whatever steps the simulator takes the sent packets with
+ * takeSent() and hands back the robots' replies with addReverse(), which are
+ * picked up by the next receive().
+ *
+ * This is not thread-safe: the simulator and the Processor are expected to be
+ * stepped from the same thread.
+ */
+class InProcessRadio : public Radio {
+public:
+    InProcessRadio(bool blueTeam = false);
+
+    virtual bool isOpen() const override;
+    virtual void send(Packet::RadioTx& packet) override;
+    virtual void receive() override;
+    virtual void switchTeam(bool blueTeam) override;
+
+    bool blueTeam() const { return _blueTeam; }
+
+    /// Moves all packets sent since the last call into @packets
+    void takeSent(std::vector<Packet::RadioTx>& packets);
+
+    /// Queues a reverse packet to be delivered by the next receive()
+    void addReverse(const Packet::RadioRx& packet);
+
+private:
+    bool _blueTeam;
+
+    std::vector<Packet::RadioTx> _sent;
+    std::vector<Packet::RadioRx> _pendingReverse;
+};